@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fsm.h"
+#include "fsm_clock.h"
+
+/**
+ * Dispatch hot path benchmark.
+ *
+ * Builds synthetic machines of varying rule count, state count, guard pass rate and callback presence,
+ * and measures fsm_process_event() with and without a dispatch index, fsm_process_events_batch() and,
+ * for callback-free machines, fsm_advance_states(). Wide builds add machines with 256 states and up to 4096
+ * events, whose dispatch index no longer fits in cache. Each case is printed as one JSON object per line:
+ *
+ *   {"benchmark":"dispatch","wide":0,"mode":"index","rules":256,"states":32,"events":8,"guard_pass_pct":50,
+ *    "callbacks":1,"sample_calls":64,"events_per_sec":1.0e8,"p50_ns":9.8,"p99_ns":14.1}
+ *
+ * A latency sample is the average time per event over sample_calls consecutive events, timed together because
+ * a single call is shorter than the clock resolution; p50_ns and p99_ns are percentiles of these averages,
+ * not of individual calls.
+ *
+ * Usage: bench_dispatch [samples]
+ */
+
+#define BENCH_MAX_RULES       16384
+#define BENCH_CALLS           64     // Events timed together to form one latency sample.
+#define BENCH_EVENT_STREAM    65536  // Length of the pre-generated event stream, a power of two.
+#define BENCH_INSTANCES       256    // Instances used by the batch mode.
+#define BENCH_NO_GUARD        (-1)
+#define BENCH_DEFAULT_SAMPLES 2000
+
+#ifdef FSM_WIDE
+#define BENCH_WIDE 1
+#else
+#define BENCH_WIDE 0
+#endif
+
+typedef enum {
+	BENCH_MODE_SCAN,    // fsm_process_event() without a dispatch index.
+	BENCH_MODE_INDEX,   // fsm_process_event() with a dispatch index.
+	BENCH_MODE_BATCH,   // fsm_process_events_batch() over several instances.
+	BENCH_MODE_VECTOR,  // fsm_advance_states() with a next-state table.
+	BENCH_MODE_COUNT,
+} bench_mode_t;
+
+static const char* const bench_mode_names[BENCH_MODE_COUNT] = {"scan", "index", "batch", "vector"};
+
+typedef struct {
+	bench_mode_t mode;
+	size_t       rule_count;
+	uint16_t     state_count;
+	uint16_t     event_count;
+	int          guard_pass_pct;
+	int          callbacks;  // 0: none, 1: rule on_entry, 2: state and rule exit/entry actions.
+} bench_case_t;
+
+static fsm_transition_t bench_rules[BENCH_MAX_RULES];
+static fsm_state_desc_t bench_states[FSM_MAX_STATES];
+static uint16_t         bench_index[FSM_INDEX_SIZE(FSM_MAX_STATES, FSM_MAX_EVENTS)];
+static fsm_state_t      bench_next[FSM_NEXT_TABLE_SIZE(FSM_MAX_STATES, FSM_MAX_EVENTS)];
+static fsm_event_t      bench_events[BENCH_EVENT_STREAM];
+static uint8_t          bench_guard_bits[BENCH_EVENT_STREAM];
+static size_t           bench_guard_cursor;
+static volatile size_t  bench_sink;
+
+static int bench_guard(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	return bench_guard_bits[bench_guard_cursor++ & (BENCH_EVENT_STREAM - 1)];
+}
+
+static void bench_action(fsm_t* fsm, void* data) {
+	(void)data;
+	bench_sink += fsm->current_state;
+}
+
+static int bench_compare(const void* a, const void* b) {
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+// Rule i handles state (i % states) and the (i / states)-th of the rule events, spread evenly over all events.
+// When there are as many events as rule events every (state, event) pair has exactly one rule and a linear
+// scan has to walk about half of the table on average; larger event counts leave the pairs between them empty.
+static void bench_build(const bench_case_t* c) {
+	size_t rule_events = (c->rule_count + c->state_count - 1) / c->state_count;
+	for (size_t i = 0; i < c->rule_count; i++) {
+		fsm_transition_t* rule = &bench_rules[i];
+		fsm_state_t       from = (fsm_state_t)(i % c->state_count);
+#ifdef FSM_WIDE
+		memset(rule->source_states_mask, 0, sizeof(rule->source_states_mask));
+		rule->source_states_mask[from / 64] = 1ULL << (from % 64);
+#else
+		rule->source_states_mask = FSM_STATE_MASK(from);
+#endif
+		rule->event        = (fsm_event_t)(i / c->state_count * c->event_count / rule_events);
+		rule->target_state = (fsm_state_t)((i * 7 + 3) % c->state_count);
+		rule->guard        = c->guard_pass_pct == BENCH_NO_GUARD ? NULL : bench_guard;
+		rule->on_entry     = c->callbacks ? bench_action : NULL;
+		rule->on_exit      = c->callbacks > 1 ? bench_action : NULL;
+	}
+	for (size_t i = 0; i < FSM_MAX_STATES; i++) {
+		bench_states[i].on_entry = c->callbacks > 1 ? bench_action : NULL;
+		bench_states[i].on_exit  = c->callbacks > 1 ? bench_action : NULL;
+	}
+	for (size_t i = 0; i < BENCH_EVENT_STREAM; i++) {
+		bench_events[i]     = (fsm_event_t)(rand() % c->event_count);
+		bench_guard_bits[i] = (uint8_t)(rand() % 100 >= c->guard_pass_pct);
+	}
+	bench_guard_cursor = 0;
+}
+
+// Builds the definition of a case, printing the step that failed.
+static fsm_result_t bench_setup(const bench_case_t* c, fsm_def_t* def) {
+	const char*  step   = "fsm_def_init";
+	fsm_result_t result = fsm_def_init(def, bench_rules, c->rule_count);
+	if (result == FSM_RESULT_SUCCESS && c->mode != BENCH_MODE_SCAN) {
+		step   = "fsm_def_compile";
+		result = fsm_def_compile(def, bench_index, sizeof(bench_index) / sizeof(bench_index[0]), c->state_count,
+								 c->event_count);
+		if (result == FSM_RESULT_SUCCESS) {
+			step   = "fsm_def_set_states";
+			result = fsm_def_set_states(def, bench_states, c->state_count);
+		}
+	}
+	if (result == FSM_RESULT_SUCCESS && c->mode == BENCH_MODE_VECTOR) {
+		step   = "fsm_def_compile_next_table";
+		result = fsm_def_compile_next_table(def, bench_next, sizeof(bench_next) / sizeof(bench_next[0]));
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		fprintf(stderr, "bench_dispatch: %s case with %zu rules, %u states, %u events: %s failed: %s\n",
+				bench_mode_names[c->mode], c->rule_count, (unsigned)c->state_count, (unsigned)c->event_count, step,
+				fsm_result_string(result));
+	}
+	return result;
+}
+
+static fsm_result_t bench_run(const bench_case_t* c, size_t samples) {
+	static fsm_t        instances[BENCH_INSTANCES];
+	static fsm_t*       batch_instances[BENCH_EVENT_STREAM];
+	static fsm_result_t batch_results[BENCH_CALLS];
+	static fsm_state_t  states[BENCH_EVENT_STREAM];
+	fsm_def_t           def;
+
+	bench_build(c);
+	fsm_result_t result = bench_setup(c, &def);
+	if (result != FSM_RESULT_SUCCESS) {
+		return result;
+	}
+	double* sample_ns = (double*)malloc(samples * sizeof(double));
+	if (!sample_ns) {
+		fprintf(stderr, "bench_dispatch: out of memory for %zu samples\n", samples);
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < BENCH_INSTANCES; i++) {
+		fsm_init(&instances[i], &def, 0);
+	}
+	memset(states, 0, sizeof(states));
+	// Instances of every batch are picked up front, so the timed window only covers dispatch.
+	for (size_t cursor = 0; cursor < BENCH_EVENT_STREAM; cursor += BENCH_CALLS) {
+		for (size_t i = 0; i < BENCH_CALLS; i++) {
+			batch_instances[cursor + i] = &instances[(cursor + i * 31) % BENCH_INSTANCES];
+		}
+	}
+
+	size_t   cursor   = 0;
+	uint64_t total_ns = 0;
+	for (size_t s = 0; s < samples; s++) {
+		const fsm_event_t* events = &bench_events[cursor];
+		uint64_t           start  = fsm_clock_ns();
+		switch (c->mode) {
+		case BENCH_MODE_BATCH:
+			fsm_process_events_batch(&batch_instances[cursor], events, NULL, batch_results, BENCH_CALLS);
+			break;
+		case BENCH_MODE_VECTOR:
+			fsm_advance_states(&def, &states[cursor], events, BENCH_CALLS);
+			break;
+		default:
+			for (size_t i = 0; i < BENCH_CALLS; i++) {
+				fsm_process_event(&instances[0], events[i], NULL);
+			}
+			break;
+		}
+		uint64_t elapsed = fsm_clock_ns() - start;
+		sample_ns[s]     = (double)elapsed / BENCH_CALLS;
+		total_ns += elapsed;
+		cursor = (cursor + BENCH_CALLS) & (BENCH_EVENT_STREAM - 1);
+	}
+
+	qsort(sample_ns, samples, sizeof(double), bench_compare);
+	double events_per_sec = total_ns ? (double)(samples * BENCH_CALLS) * 1e9 / (double)total_ns : 0.0;
+	printf("{\"benchmark\":\"dispatch\",\"wide\":%d,\"mode\":\"%s\",\"rules\":%zu,\"states\":%u,\"events\":%u,"
+		   "\"guard_pass_pct\":%d,\"callbacks\":%d,\"sample_calls\":%d,\"events_per_sec\":%.4g,\"p50_ns\":%.2f,"
+		   "\"p99_ns\":%.2f}\n",
+		   BENCH_WIDE, bench_mode_names[c->mode], c->rule_count, (unsigned)c->state_count, (unsigned)c->event_count,
+		   c->guard_pass_pct, c->callbacks, BENCH_CALLS, events_per_sec, sample_ns[samples / 2],
+		   sample_ns[samples * 99 / 100]);
+	fflush(stdout);
+	free(sample_ns);
+	return FSM_RESULT_SUCCESS;
+}
+
+// Runs every guard rate and callback variant of one machine shape that the mode supports.
+static int bench_shape(bench_mode_t mode, size_t rule_count, uint16_t state_count, uint16_t event_count,
+					   size_t samples) {
+	static const int guard_rates[] = {BENCH_NO_GUARD, 100, 50, 0};
+	int              failures      = 0;
+	if (rule_count < state_count || rule_count > BENCH_MAX_RULES || state_count > FSM_MAX_STATES ||
+		event_count > FSM_MAX_EVENTS) {
+		return 0;
+	}
+	for (size_t g = 0; g < sizeof(guard_rates) / sizeof(guard_rates[0]); g++) {
+		for (int callbacks = 0; callbacks <= 2; callbacks++) {
+			bench_case_t c = {
+				.mode           = mode,
+				.rule_count     = rule_count,
+				.state_count    = state_count,
+				.event_count    = event_count,
+				.guard_pass_pct = guard_rates[g],
+				.callbacks      = callbacks,
+			};
+			// State actions need a compiled definition.
+			if (c.mode == BENCH_MODE_SCAN && c.callbacks > 1) {
+				continue;
+			}
+			// The vector kernel only applies to callback-free machines.
+			if (c.mode == BENCH_MODE_VECTOR && (c.callbacks || c.guard_pass_pct != BENCH_NO_GUARD)) {
+				continue;
+			}
+			failures += bench_run(&c, samples) != FSM_RESULT_SUCCESS;
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv) {
+	static const size_t rule_counts[] = {4, 16, 64, 256, 1024};
+#ifdef FSM_WIDE
+	static const int state_counts[] = {4, 32, 128};
+	// Wide-only shapes with 256 states and 1024 or more events, whose dispatch index outgrows the L2 cache.
+	// A rule per (state, event) pair would overflow the 16-bit rule index, so the rules cover a subset of
+	// the events and the other pairs have no transition.
+	static const struct {
+		size_t   rule_count;
+		uint16_t state_count;
+		uint16_t event_count;
+	} large_shapes[] = {{4096, 256, 1024}, {16384, 256, 4096}};
+#else
+	static const int state_counts[] = {4, 32};
+#endif
+	size_t samples = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_SAMPLES;
+	if (samples == 0) {
+		samples = BENCH_DEFAULT_SAMPLES;
+	}
+
+	int failures = 0;
+	srand(1);
+	for (int m = 0; m < BENCH_MODE_COUNT; m++) {
+		for (size_t r = 0; r < sizeof(rule_counts) / sizeof(rule_counts[0]); r++) {
+			for (size_t s = 0; s < sizeof(state_counts) / sizeof(state_counts[0]); s++) {
+				uint16_t event_count = (uint16_t)((rule_counts[r] + state_counts[s] - 1) / state_counts[s]);
+				failures += bench_shape((bench_mode_t)m, rule_counts[r], (uint16_t)state_counts[s],
+										event_count, samples);
+			}
+		}
+#ifdef FSM_WIDE
+		for (size_t l = 0; l < sizeof(large_shapes) / sizeof(large_shapes[0]); l++) {
+			failures += bench_shape((bench_mode_t)m, large_shapes[l].rule_count, large_shapes[l].state_count,
+									large_shapes[l].event_count, samples);
+		}
+#endif
+	}
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+#[[.rst:
+fsm_generate
+------------
+
+Generates specialized dispatch code from a machine spec (see tools/fsm_spec.h) and adds it to a target.
+
+.. code-block:: cmake
+
+  fsm_generate(<target> <spec>)
+
+Runs fsm_gen on <spec> at build time, producing <name>_fsm.h and <name>_fsm.c in the current binary
+directory, where <name> is the spec file name without extension. The source is added to <target> and the
+directory to its include path, so the target can include "<name>_fsm.h" and must implement the callbacks
+the spec names. Needs the fsm_gen target, built with FSM_BUILD_TOOLS or FSM_BUILD_EXAMPLE.
+]]
+function(fsm_generate target spec)
+    if(NOT TARGET fsm_gen)
+        message(FATAL_ERROR "fsm_generate() needs the fsm_gen tool, configure with -DFSM_BUILD_TOOLS=ON")
+    endif()
+    get_filename_component(spec_path "${spec}" ABSOLUTE)
+    get_filename_component(spec_name "${spec}" NAME_WE)
+    string(MAKE_C_IDENTIFIER "${spec_name}_fsm" output_name)
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/fsm_generated")
+    set(outputs "${output_dir}/${output_name}.h" "${output_dir}/${output_name}.c")
+
+    add_custom_command(
+        OUTPUT ${outputs}
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        COMMAND fsm_gen -o "${output_dir}" "${spec_path}"
+        DEPENDS fsm_gen "${spec_path}"
+        COMMENT "Generating ${output_name}.c from ${spec}"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE ${outputs})
+    target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
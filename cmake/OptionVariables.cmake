@@ -11,7 +11,13 @@
 # |===========================|=====================|===============================================|===============================================================|
 # | CMAKE_BUILD_TYPE          | Always              | "Debug" (if not set)                          | Standard CMake: Debug, Release, MinSizeRel, RelWithDebInfo.   |
 # | FSM_BUILD_SHARED          | Always (Option)     | OFF                                           | Build shared libraries if ON, static if OFF.                  |
+# | FSM_WIDE_MODE             | Always (Option)     | OFF                                           | 16-bit state/event ids and multi-word source state masks.     |
+# | FSM_WIDE_MAX_STATES       | Always              | 256                                           | State limit in wide mode, a multiple of 64 up to 256.         |
+# | FSM_ENABLE_STATS          | Always (Option)     | OFF                                           | Compile per-thread dispatch counters into the hot path.       |
+# | FSM_ENABLE_TRACE          | Always (Option)     | OFF                                           | Record dispatched events into per-thread trace rings.         |
 # | FSM_BUILD_EXAMPLE         | Top-Level (Option)  | OFF                                           | Build example programs.                                       |
+# | FSM_BUILD_BENCHMARK       | Top-Level (Option)  | OFF                                           | Build benchmark programs.                                     |
+# | FSM_BUILD_TOOLS           | Top-Level (Option)  | OFF                                           | Build command line tools (fsm_check, fsm_gen).                |
 # |---------------------------|---------------------|-----------------------------------------------|---------------------------------------------------------------|
 #
 # =======================================================================================================================
@@ -26,7 +32,13 @@
 # |===========================|=====================|===============================================|===============================================================|
 # | CMAKE_BUILD_TYPE          | 总是                | "Debug" (如果未设置)                          | 标准 CMake 变量：Debug, Release, MinSizeRel, RelWithDebInfo。 |
 # | FSM_BUILD_SHARED          | 总是 (选项)         | OFF                                           | 如果为 ON 构建共享库，为 OFF 构建静态库。                     |
+# | FSM_WIDE_MODE             | 总是 (选项)         | OFF                                           | 使用 16 位状态/事件 ID 和多字源状态掩码。                     |
+# | FSM_WIDE_MAX_STATES       | 总是                | 256                                           | 宽模式下的状态上限，64 的倍数，最大 256。                     |
+# | FSM_ENABLE_STATS          | 总是 (选项)         | OFF                                           | 在分发热路径中编译每线程统计计数器。                          |
+# | FSM_ENABLE_TRACE          | 总是 (选项)         | OFF                                           | 将分发的事件记录到每线程的跟踪环形缓冲区。                    |
 # | FSM_BUILD_EXAMPLE         | 顶层项目 (选项)     | OFF                                           | 构建示例程序。                                                |
+# | FSM_BUILD_BENCHMARK       | 顶层项目 (选项)     | OFF                                           | 构建基准测试程序。                                            |
+# | FSM_BUILD_TOOLS           | 顶层项目 (选项)     | OFF                                           | 构建命令行工具（fsm_check、fsm_gen）。                        |
 # |---------------------------|---------------------|-----------------------------------------------|---------------------------------------------------------------|
 
 if(NOT CMAKE_CONFIGURATION_TYPES)
@@ -48,6 +60,15 @@ endif()
 option(FSM_BUILD_SHARED "build shared library" ON)
 mark_as_advanced(FSM_BUILD_SHARED)
 
+option(FSM_WIDE_MODE "use 16-bit state/event ids and multi-word state masks" OFF)
+set(FSM_WIDE_MAX_STATES 256 CACHE STRING "maximum number of states in wide mode (multiple of 64, up to 256)")
+mark_as_advanced(FSM_WIDE_MAX_STATES)
+
+option(FSM_ENABLE_STATS "compile per-thread dispatch statistics into the hot path" OFF)
+option(FSM_ENABLE_TRACE "record dispatched events into per-thread trace rings" OFF)
+
 if(PROJECT_IS_TOP_LEVEL)
     option(FSM_BUILD_EXAMPLE "build example program" OFF)
+    option(FSM_BUILD_BENCHMARK "build benchmark program" OFF)
+    option(FSM_BUILD_TOOLS "build command line tools" OFF)
 endif()
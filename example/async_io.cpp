@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "fsm_coro.hpp"
+
+// Document states
+enum : fsm_state_t {
+	STATE_EDITING,
+	STATE_SAVED,
+	STATE_COUNT,
+};
+
+// Document events
+enum : fsm_event_t {
+	EVENT_SAVE,
+	EVENT_EDIT,
+	EVENT_COUNT,
+};
+
+// Per-instance context: the write in flight and what the action saw
+struct document {
+	fsmpp::completion write;    // Completed by the I/O loop
+	int               flushed;  // Writes the save action has seen complete
+};
+
+// Writes started but not completed yet, the stand-in for an I/O loop
+static std::vector<document*> in_flight;
+
+// Starts the write and waits for it without blocking the dispatching thread
+static fsmpp::task save(fsm_t* self, void* data) {
+	document* doc = static_cast<document*>(fsm_userdata(self));
+	doc->write.reset();
+	in_flight.push_back(doc);
+	co_await doc->write;
+	doc->flushed++;
+}
+
+static void mark_saved(fsm_t* self, void* data) {
+	// Runs after the write completed: the state entry comes after the rule's on_entry
+	document* doc = static_cast<document*>(fsm_userdata(self));
+	if (doc->flushed != 1) {
+		printf("! saved before the write completed\n");
+	}
+}
+
+// C++ designated initializers follow the declaration order of fsm_transition_t
+static const fsm_transition_t transitions[] = {
+	{
+		.on_entry           = fsmpp::async_action<save>,
+		.source_states_mask = FSM_STATE_MASK(STATE_EDITING),
+		.target_state       = STATE_SAVED,
+		.event              = EVENT_SAVE,
+	},
+	{
+		.source_states_mask = FSM_STATE_MASK(STATE_SAVED),
+		.target_state       = STATE_EDITING,
+		.event              = EVENT_EDIT,
+	},
+};
+
+static fsm_state_desc_t states[STATE_COUNT];
+
+int main(void) {
+	constexpr size_t count = 1000;
+	static uint16_t  dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	static fsm_t     fsm[count];
+	static document  docs[count];
+	fsm_def_t        def;
+
+	states[STATE_SAVED].on_entry = mark_saved;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_states(&def, states, STATE_COUNT);
+	}
+	for (size_t i = 0; i < count && result == FSM_RESULT_SUCCESS; i++) {
+		result = fsm_init(&fsm[i], &def, STATE_EDITING);
+		fsm_set_userdata(&fsm[i], &docs[i]);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	// One thread starts every save; each transition stops at its write
+	size_t pending = 0;
+	for (size_t i = 0; i < count; i++) {
+		pending += fsm_process_event(&fsm[i], EVENT_SAVE, NULL) == FSM_RESULT_PENDING;
+	}
+	printf("Saves pending: %zu, writes in flight: %zu\n", pending, in_flight.size());
+
+	// Events for an instance in transition are rejected
+	printf("Edit while saving: %s\n", fsm_result_string(fsm_process_event(&fsm[0], EVENT_EDIT, NULL)));
+
+	// The writes complete in any order; each completion finishes its transition
+	std::shuffle(in_flight.begin(), in_flight.end(), std::mt19937(42));
+	std::vector<document*> completed;
+	completed.swap(in_flight);
+	for (document* doc : completed) {
+		doc->write.complete();
+	}
+
+	size_t saved = 0;
+	for (size_t i = 0; i < count; i++) {
+		saved += fsm_current_state(&fsm[i]) == STATE_SAVED && !fsm_is_pending(&fsm[i]);
+	}
+	printf("Saved: %zu of %zu\n", saved, count);
+	printf("Edit after saving: %s\n", fsm_result_string(fsm_process_event(&fsm[0], EVENT_EDIT, NULL)));
+	return saved == count ? 0 : 1;
+}
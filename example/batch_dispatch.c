@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm.h"
+
+// Connection states
+typedef enum {
+	STATE_IDLE,
+	STATE_CONNECTING,
+	STATE_READY,
+	STATE_CLOSED,
+	STATE_COUNT,
+} state_t;
+
+// Connection events, EVENT_COUNT and above are out of bounds for a compiled definition
+typedef enum {
+	EVENT_OPEN,
+	EVENT_ACCEPT,
+	EVENT_SEND,
+	EVENT_CLOSE,
+	EVENT_COUNT,
+} event_t;
+
+#define INSTANCE_COUNT 64
+#define BATCH_SIZE     256
+#define ROUND_COUNT    200
+
+// Every third payload is rejected by the handshake.
+static int accept_handshake(fsm_t* fsm, void* data) {
+	return *(const unsigned*)data % 3 == 0;
+}
+
+// Every fifth send waits for I/O, which keeps the instance busy until the next round resumes it.
+static void start_send(fsm_t* fsm, void* data) {
+	if (*(const unsigned*)data % 5 == 0) {
+		fsm_suspend(fsm);
+	}
+}
+
+static const fsm_transition_t transitions[] = {
+	{
+		.source_states_mask = FSM_STATES_MASK(STATE_IDLE, STATE_CLOSED),
+		.target_state       = STATE_CONNECTING,
+		.event              = EVENT_OPEN,
+	},
+	{
+		.guard              = accept_handshake,
+		.source_states_mask = FSM_STATE_MASK(STATE_CONNECTING),
+		.target_state       = STATE_READY,
+		.event              = EVENT_ACCEPT,
+	},
+	{
+		.on_exit            = start_send,
+		.source_states_mask = FSM_STATE_MASK(STATE_READY),
+		.target_state       = STATE_READY,
+		.event              = EVENT_SEND,
+	},
+	{
+		.source_states_mask = FSM_STATES_MASK(STATE_CONNECTING, STATE_READY),
+		.target_state       = STATE_CLOSED,
+		.event              = EVENT_CLOSE,
+	},
+};
+
+static unsigned next_random(unsigned* seed) {
+	*seed = *seed * 1103515245u + 12345u;
+	return *seed >> 16;
+}
+
+// Dispatches the same random items through fsm_process_events_batch() and through one fsm_process_event()
+// call per item on a twin population, and counts the items whose result differs and the instances whose state
+// or pending transition differs after each round.
+static size_t compare(const fsm_def_t* def, unsigned seed, size_t counts[FSM_RESULT_COUNT]) {
+	static fsm_t        batched[INSTANCE_COUNT];
+	static fsm_t        sequential[INSTANCE_COUNT];
+	static fsm_t*       items[BATCH_SIZE];
+	static fsm_event_t  events[BATCH_SIZE];
+	static unsigned     payloads[BATCH_SIZE];
+	static void*        data[BATCH_SIZE];
+	static fsm_result_t results[BATCH_SIZE];
+	size_t              mismatches = 0;
+
+	for (size_t i = 0; i < INSTANCE_COUNT; i++) {
+		fsm_init(&batched[i], def, STATE_IDLE);
+		fsm_init(&sequential[i], def, STATE_IDLE);
+	}
+	for (size_t round = 0; round < ROUND_COUNT; round++) {
+		for (size_t i = 0; i < BATCH_SIZE; i++) {
+			size_t target = next_random(&seed) % INSTANCE_COUNT;
+			items[i]      = &batched[target];
+			events[i]     = (fsm_event_t)(next_random(&seed) % (EVENT_COUNT + 2));
+			payloads[i]   = next_random(&seed);
+			data[i]       = &payloads[i];
+		}
+		fsm_process_events_batch(items, events, data, results, BATCH_SIZE);
+		for (size_t i = 0; i < BATCH_SIZE; i++) {
+			fsm_t*       twin     = &sequential[items[i] - batched];
+			fsm_result_t expected = fsm_process_event(twin, events[i], data[i]);
+			if (results[i] != expected) {
+				mismatches++;
+			}
+			counts[results[i]]++;
+		}
+		// Half of the waiting sends complete before the next round, the others stay busy.
+		for (size_t i = 0; i < INSTANCE_COUNT; i++) {
+			if (fsm_is_pending(&batched[i]) && next_random(&seed) % 2) {
+				fsm_resume(&batched[i], NULL);
+				fsm_resume(&sequential[i], NULL);
+			}
+			if (batched[i].current_state != sequential[i].current_state ||
+				fsm_is_pending(&batched[i]) != fsm_is_pending(&sequential[i])) {
+				mismatches++;
+			}
+		}
+	}
+	return mismatches;
+}
+
+int main(void) {
+	static uint16_t index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	fsm_def_t       flat;
+	fsm_def_t       compiled;
+
+	fsm_result_t result = fsm_def_init(&flat, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_init(&compiled, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&compiled, index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	const fsm_def_t* defs[]   = {&flat, &compiled};
+	const char*      names[]  = {"rule scan", "dispatch index"};
+	int              failures = 0;
+	for (size_t d = 0; d < 2; d++) {
+		size_t counts[FSM_RESULT_COUNT] = {0};
+		size_t mismatches               = compare(defs[d], 42u + (unsigned)d, counts);
+		printf("%s: %zu mismatches over %d items\n", names[d], mismatches, ROUND_COUNT * BATCH_SIZE);
+		for (int r = 0; r < FSM_RESULT_COUNT; r++) {
+			if (counts[r]) {
+				printf("  %-32s %zu\n", fsm_result_string((fsm_result_t)r), counts[r]);
+			}
+		}
+		failures += mismatches != 0;
+	}
+	return failures ? -1 : 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <cstdio>
+
+#include "fsm.hpp"
+
+// Turnstile states
+enum : fsm_state_t {
+	STATE_LOCKED,
+	STATE_UNLOCKED,
+	STATE_BROKEN,
+	STATE_COUNT,
+};
+
+// Turnstile events
+enum : fsm_event_t {
+	EVENT_COIN,
+	EVENT_PUSH,
+	EVENT_FAULT,
+	EVENT_REPAIR,
+	EVENT_COUNT,
+};
+
+// Turnstile context data
+struct turnstile_context {
+	int coins;   // Coins accepted
+	int passes;  // People let through
+};
+
+static int guard_coin(fsm_t *fsm, void *data) {
+	// Only whole coins unlock the turnstile
+	return data && *static_cast<int *>(data) == 1 ? 0 : 1;
+}
+
+static void action_unlock(fsm_t *fsm, void *data) {
+	turnstile_context *ctx = static_cast<turnstile_context *>(fsm_userdata(fsm));
+	ctx->coins++;
+	printf("+ Unlocked, coins: %d\n", ctx->coins);
+}
+
+static void action_lock(fsm_t *fsm, void *data) {
+	turnstile_context *ctx = static_cast<turnstile_context *>(fsm_userdata(fsm));
+	ctx->passes++;
+	printf("+ Locked, passes: %d\n", ctx->passes);
+}
+
+static void action_broken(fsm_t *fsm, void *data) {
+	printf("! Out of order\n");
+}
+
+// The whole machine is checked at compile time: a rule targeting STATE_COUNT, two EVENT_COIN rules sharing
+// STATE_LOCKED, or dropping the EVENT_FAULT rule (leaving STATE_BROKEN unreachable) fails to build.
+using turnstile = fsmpp::machine<STATE_COUNT, EVENT_COUNT, STATE_LOCKED,
+	fsmpp::rule<EVENT_COIN, fsmpp::from<STATE_LOCKED>, STATE_UNLOCKED, guard_coin, action_unlock>,
+	fsmpp::rule<EVENT_PUSH, fsmpp::from<STATE_UNLOCKED>, STATE_LOCKED, nullptr, action_lock>,
+	fsmpp::rule<EVENT_FAULT, fsmpp::from<STATE_LOCKED, STATE_UNLOCKED>, STATE_BROKEN, nullptr, action_broken>,
+	fsmpp::rule<EVENT_REPAIR, fsmpp::from<STATE_BROKEN>, STATE_LOCKED>>;
+
+int main(void) {
+	turnstile_context ctx = {0, 0};
+	fsm_t             fsm;
+	fsm_result_t      result = turnstile::init(fsm);
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	fsm_set_userdata(&fsm, &ctx);
+
+	int whole_coin = 1;
+	int bent_coin  = 0;
+
+	// Generated dispatcher: guards and actions are called directly
+	printf("Coin (bent): %s\n", fsm_result_string(turnstile::process(fsm, EVENT_COIN, &bent_coin)));
+	printf("Coin (whole): %s\n", fsm_result_string(turnstile::process(fsm, EVENT_COIN, &whole_coin)));
+	printf("Push: %s\n", fsm_result_string(turnstile::process(fsm, EVENT_PUSH)));
+
+	// The same instance keeps working through the C API, as code still written in C would drive it
+	printf("Fault (C API): %s\n", fsm_result_string(fsm_process_event(&fsm, EVENT_FAULT, NULL)));
+	printf("Push (C API): %s\n", fsm_result_string(fsm_process_event(&fsm, EVENT_PUSH, NULL)));
+	printf("Repair: %s\n", fsm_result_string(turnstile::process(fsm, EVENT_REPAIR)));
+
+	printf("Final state: %d, coins: %d, passes: %d\n", fsm_current_state(&fsm), ctx.coins, ctx.passes);
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm.h"
+
+// Connection states, IDLE and BUSY are nested in CONNECTED
+typedef enum {
+	STATE_DISCONNECTED,
+	STATE_CONNECTED,
+	STATE_IDLE,
+	STATE_BUSY,
+	STATE_COUNT,
+} state_t;
+
+// Connection events
+typedef enum {
+	EVENT_CONNECT,
+	EVENT_REQUEST,
+	EVENT_RESPONSE,
+	EVENT_DISCONNECT,
+	EVENT_COUNT,
+} event_t;
+
+static const char* state_names[] = {"DISCONNECTED", "CONNECTED", "IDLE", "BUSY"};
+static const char* event_names[] = {"CONNECT", "REQUEST", "RESPONSE", "DISCONNECT"};
+
+static void enter_connected(fsm_t* fsm, void* data) {
+	printf("  enter CONNECTED: open socket\n");
+}
+
+static void exit_connected(fsm_t* fsm, void* data) {
+	printf("  exit  CONNECTED: close socket\n");
+}
+
+static void enter_busy(fsm_t* fsm, void* data) {
+	printf("  enter BUSY: start request timer\n");
+}
+
+static void exit_busy(fsm_t* fsm, void* data) {
+	printf("  exit  BUSY: stop request timer\n");
+}
+
+static void action_disconnect(fsm_t* fsm, void* data) {
+	printf("  rule  DISCONNECT: notify peer\n");
+}
+
+// A single DISCONNECT rule on CONNECTED covers IDLE and BUSY, which inherit it.
+static const fsm_transition_t transitions[] = {
+	{
+		.event              = EVENT_CONNECT,
+		.source_states_mask = FSM_STATE_MASK(STATE_DISCONNECTED),
+		.target_state       = STATE_IDLE,
+	},
+	{
+		.event              = EVENT_REQUEST,
+		.source_states_mask = FSM_STATE_MASK(STATE_IDLE),
+		.target_state       = STATE_BUSY,
+	},
+	{
+		.event              = EVENT_RESPONSE,
+		.source_states_mask = FSM_STATE_MASK(STATE_BUSY),
+		.target_state       = STATE_IDLE,
+	},
+	{
+		.event              = EVENT_DISCONNECT,
+		.source_states_mask = FSM_STATE_MASK(STATE_CONNECTED),
+		.target_state       = STATE_DISCONNECTED,
+		.on_exit            = action_disconnect,
+	},
+};
+
+static const fsm_state_desc_t states[STATE_COUNT] = {
+	[STATE_CONNECTED] = {.on_entry = enter_connected, .on_exit = exit_connected},
+	[STATE_BUSY]      = {.on_entry = enter_busy, .on_exit = exit_busy},
+};
+
+static const fsm_state_t parents[STATE_COUNT] = {
+	[STATE_DISCONNECTED] = FSM_STATE_NONE,
+	[STATE_CONNECTED]    = FSM_STATE_NONE,
+	[STATE_IDLE]         = STATE_CONNECTED,
+	[STATE_BUSY]         = STATE_CONNECTED,
+};
+
+static void process(fsm_t* fsm, event_t event) {
+	fsm_state_t  from   = fsm_current_state(fsm);
+	fsm_result_t result = fsm_process_event(fsm, event, NULL);
+	printf("%s: %s -> %s (%s), connected: %s\n", event_names[event], state_names[from],
+		   state_names[fsm_current_state(fsm)], fsm_result_string(result),
+		   fsm_in_state(fsm, STATE_CONNECTED) ? "yes" : "no");
+}
+
+int main(void) {
+	static uint16_t     dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	static fsm_path_t   paths[FSM_PATH_TABLE_SIZE(STATE_COUNT)];
+	static fsm_action_t path_actions[32];
+	size_t              action_count = sizeof(path_actions) / sizeof(path_actions[0]);
+	fsm_def_t           def;
+	fsm_t               fsm;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_states(&def, states, STATE_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_hierarchy(&def, parents, paths, FSM_PATH_TABLE_SIZE(STATE_COUNT), path_actions,
+									   &action_count);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&fsm, &def, STATE_DISCONNECTED);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	printf("Path actions used: %zu\n", action_count);
+
+	process(&fsm, EVENT_CONNECT);
+	process(&fsm, EVENT_REQUEST);
+	process(&fsm, EVENT_DISCONNECT);  // Exits BUSY, then CONNECTED
+	process(&fsm, EVENT_CONNECT);
+	process(&fsm, EVENT_DISCONNECT);  // Same rule from IDLE
+	process(&fsm, EVENT_DISCONNECT);  // No rule in DISCONNECTED
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm.h"
+#include "fsm_queue.h"
+
+// Vending machine states
+typedef enum {
+	STATE_IDLE,
+	STATE_ACCEPTING,
+	STATE_DISPENSING,
+	STATE_OUT_OF_ORDER,
+	STATE_COUNT,
+} state_t;
+
+// Vending machine events
+typedef enum {
+	EVENT_INSERT_COIN,
+	EVENT_SELECT_ITEM,
+	EVENT_DISPENSE_DONE,
+	EVENT_EMERGENCY,
+	EVENT_RESET,
+	EVENT_COUNT,
+} event_t;
+
+static const char* state_names[] = {"IDLE", "ACCEPTING", "DISPENSING", "OUT_OF_ORDER"};
+static const char* event_names[] = {"INSERT_COIN", "SELECT_ITEM", "DISPENSE_DONE", "EMERGENCY", "RESET"};
+
+static const fsm_transition_t transitions[] = {
+	{
+		.event              = EVENT_INSERT_COIN,
+		.source_states_mask = FSM_STATES_MASK(STATE_IDLE, STATE_ACCEPTING),
+		.target_state       = STATE_ACCEPTING,
+	},
+	{
+		.event              = EVENT_SELECT_ITEM,
+		.source_states_mask = FSM_STATE_MASK(STATE_ACCEPTING),
+		.target_state       = STATE_DISPENSING,
+	},
+	{
+		.event              = EVENT_DISPENSE_DONE,
+		.source_states_mask = FSM_STATE_MASK(STATE_DISPENSING),
+		.target_state       = STATE_IDLE,
+	},
+	{
+		.event              = EVENT_EMERGENCY,
+		.source_states_mask = FSM_STATES_MASK(STATE_IDLE, STATE_ACCEPTING, STATE_DISPENSING),
+		.target_state       = STATE_OUT_OF_ORDER,
+	},
+	{
+		.event              = EVENT_RESET,
+		.source_states_mask = FSM_STATE_MASK(STATE_OUT_OF_ORDER),
+		.target_state       = STATE_IDLE,
+	},
+};
+
+// Customers keep inserting coins and pressing buttons while an item is dispensed or the machine is down;
+// those events wait for the next state change instead of being dropped.
+static const fsm_event_t busy_deferred[] = {EVENT_INSERT_COIN, EVENT_SELECT_ITEM};
+
+static const fsm_state_desc_t states[STATE_COUNT] = {
+	[STATE_DISPENSING]   = {.deferred_events = busy_deferred, .deferred_count = 2},
+	[STATE_OUT_OF_ORDER] = {.deferred_events = busy_deferred, .deferred_count = 2},
+};
+
+static void print_transition(void* context, fsm_t* fsm, fsm_state_t from, fsm_state_t to) {
+	(void)context;
+	(void)fsm;
+	printf("  %s -> %s\n", state_names[from], state_names[to]);
+}
+
+static void post(fsm_queue_t* queue, event_t event, int urgent) {
+	printf("post %s%s\n", event_names[event], urgent ? " (urgent)" : "");
+	if (urgent) {
+		fsm_post_urgent_event(queue, event, NULL);
+	} else {
+		fsm_post_event(queue, event, NULL);
+	}
+}
+
+static void drain(fsm_queue_t* queue) {
+	size_t processed = fsm_drain(queue);
+	printf("drained %zu events, %zu deferred, now %s\n\n", processed, fsm_queue_deferred_count(queue),
+		   state_names[fsm_current_state(queue->fsm)]);
+}
+
+int main(void) {
+	static uint16_t  dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	fsm_queue_slot_t slots[16];
+	fsm_queue_slot_t urgent_slots[4];
+	fsm_queue_slot_t deferred_slots[8];
+	fsm_queue_t      queue;
+	fsm_def_t        def;
+	fsm_t            fsm;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(transitions[0]));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_states(&def, states, STATE_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_observer(&def, print_transition, NULL);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&fsm, &def, STATE_IDLE);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_queue_init(&queue, &fsm, slots, 16);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_queue_set_urgent(&queue, urgent_slots, 4);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_queue_set_deferred(&queue, deferred_slots, 8);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	// The second purchase arrives while the first item is dispensed and is served right after it.
+	post(&queue, EVENT_INSERT_COIN, 0);
+	post(&queue, EVENT_SELECT_ITEM, 0);
+	post(&queue, EVENT_INSERT_COIN, 0);
+	post(&queue, EVENT_SELECT_ITEM, 0);
+	drain(&queue);
+	post(&queue, EVENT_DISPENSE_DONE, 0);
+	drain(&queue);
+
+	// An emergency overtakes the queued purchase, which then waits for the reset.
+	post(&queue, EVENT_DISPENSE_DONE, 0);
+	post(&queue, EVENT_INSERT_COIN, 0);
+	post(&queue, EVENT_SELECT_ITEM, 0);
+	post(&queue, EVENT_EMERGENCY, 1);
+	drain(&queue);
+	post(&queue, EVENT_RESET, 0);
+	drain(&queue);
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "fsm.h"
+#include "vending_machine_fsm.h"
+
+/**
+ * Generated dispatch example.
+ *
+ * vending_machine_fsm.c is generated at build time from vending_machine.fsm by fsm_generate() in
+ * CMakeLists.txt. This program checks that vending_dispatch() behaves exactly like fsm_process_event() on
+ * the generated tables, then compares their speed.
+ */
+
+#define CHECK_EVENTS 1000000
+#define BENCH_EVENTS 20000000
+
+static uint64_t callback_log;  // Hash of the callbacks called so far, in order.
+
+static void record_call(int id) {
+	callback_log = (callback_log ^ (uint64_t)id) * 0x100000001b3ull;
+}
+
+// The guard lets the selection through when data points to a non-zero flag.
+int can_dispense_guard(fsm_t* fsm, void* data) {
+	(void)fsm;
+	record_call(1);
+	return data && *(const int*)data ? 0 : 1;
+}
+
+void add_coin_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(2);
+}
+
+void start_dispense_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(3);
+}
+
+void return_change_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(4);
+}
+
+void refund_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(5);
+}
+
+void motor_on_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(6);
+}
+
+void motor_off_action(fsm_t* fsm, void* data) {
+	(void)fsm;
+	(void)data;
+	record_call(7);
+}
+
+int main(void) {
+	static fsm_event_t events[CHECK_EVENTS];
+	static int         flags[CHECK_EVENTS];
+	fsm_def_t          def;
+	fsm_t              generic, generated;
+	fsm_result_t       result = vending_def_init(&def);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&generic, &def, VENDING_INITIAL_STATE);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&generated, &def, VENDING_INITIAL_STATE);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return 1;
+	}
+
+	// Random events, including one past the last, and random guard outcomes.
+	srand(42);
+	for (size_t i = 0; i < CHECK_EVENTS; i++) {
+		events[i] = (fsm_event_t)(rand() % (VENDING_EVENT_COUNT + 1));
+		flags[i]  = rand() % 2;
+	}
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < CHECK_EVENTS; i++) {
+		callback_log          = 0;
+		fsm_result_t expected = fsm_process_event(&generic, events[i], &flags[i]);
+		uint64_t     calls    = callback_log;
+		callback_log          = 0;
+		fsm_result_t actual   = vending_dispatch(&generated, events[i], &flags[i]);
+		if (actual != expected || generated.current_state != generic.current_state || callback_log != calls) {
+			if (mismatches++ < 5) {
+				printf("Mismatch at event %zu (%s): %s vs %s\n", i,
+					   events[i] < VENDING_EVENT_COUNT ? vending_event_names[events[i]] : "out of range",
+					   fsm_result_string(expected), fsm_result_string(actual));
+			}
+		}
+	}
+	printf("Checked %d events: %zu mismatches\n", CHECK_EVENTS, mismatches);
+
+	// Throughput of both paths over the same stream.
+	const char* names[] = {"fsm_process_event", "vending_dispatch"};
+	for (int path = 0; path < 2; path++) {
+		fsm_t*  fsm   = path ? &generated : &generic;
+		clock_t start = clock();
+		for (size_t i = 0; i < BENCH_EVENTS; i++) {
+			size_t j = i % CHECK_EVENTS;
+			if (path) {
+				vending_dispatch(fsm, events[j], &flags[j]);
+			} else {
+				fsm_process_event(fsm, events[j], &flags[j]);
+			}
+		}
+		double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		printf("%-18s: %.2f ns/event\n", names[path], seconds * 1e9 / BENCH_EVENTS);
+	}
+	return mismatches ? 1 : 0;
+}
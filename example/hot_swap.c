@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm_executor.h"
+
+// Version 1 order states; version 2 inserts PACKED between PAID and SHIPPED, renumbering SHIPPED.
+enum { V1_NEW, V1_PAID, V1_SHIPPED, V1_STATE_COUNT };
+enum { V2_NEW, V2_PAID, V2_PACKED, V2_SHIPPED, V2_STATE_COUNT };
+
+// Order events, unchanged between versions
+typedef enum {
+	EVENT_PAY,
+	EVENT_SHIP,
+	EVENT_RESET,
+	EVENT_COUNT,
+} event_t;
+
+#define ORDER_COUNT  10000
+#define THREAD_COUNT 4
+#define ROUND_COUNT  200
+
+static const fsm_transition_t v1_transitions[] = {
+	{.source_states_mask = FSM_STATE_MASK(V1_NEW), .target_state = V1_PAID, .event = EVENT_PAY},
+	{.source_states_mask = FSM_STATE_MASK(V1_PAID), .target_state = V1_SHIPPED, .event = EVENT_SHIP},
+	{.source_states_mask = FSM_STATE_MASK(V1_SHIPPED), .target_state = V1_NEW, .event = EVENT_RESET},
+};
+
+// Shipping now takes two SHIP events.
+static const fsm_transition_t v2_transitions[] = {
+	{.source_states_mask = FSM_STATE_MASK(V2_NEW), .target_state = V2_PAID, .event = EVENT_PAY},
+	{.source_states_mask = FSM_STATE_MASK(V2_PAID), .target_state = V2_PACKED, .event = EVENT_SHIP},
+	{.source_states_mask = FSM_STATE_MASK(V2_PACKED), .target_state = V2_SHIPPED, .event = EVENT_SHIP},
+	{.source_states_mask = FSM_STATE_MASK(V2_SHIPPED), .target_state = V2_NEW, .event = EVENT_RESET},
+};
+
+static fsm_state_t remap_v1(void* context, fsm_state_t state) {
+	return state == V1_SHIPPED ? V2_SHIPPED : state;
+}
+
+static void release(void* context, fsm_version_t* version) {
+	printf("Version %llu released\n", (unsigned long long)version->number);
+}
+
+static fsm_result_t build(fsm_version_t* version, const fsm_transition_t* rules, size_t rule_count, uint16_t* index,
+						  uint16_t state_count) {
+	fsm_result_t result = fsm_def_init(&version->def, rules, rule_count);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&version->def, index, FSM_INDEX_SIZE(state_count, EVENT_COUNT), state_count,
+								 EVENT_COUNT);
+	}
+	version->release = release;
+	return result;
+}
+
+// Posts one event to every order, retrying while a shard queue is full.
+static void post_round(fsm_executor_t* executor, size_t round) {
+	for (size_t id = 0; id < ORDER_COUNT; id++) {
+		while (fsm_executor_post(executor, id, (fsm_event_t)((round + id) % EVENT_COUNT), NULL) != FSM_RESULT_SUCCESS) {
+			fsm_executor_wait_idle(executor);
+		}
+	}
+}
+
+int main(void) {
+	static uint16_t              v1_index[FSM_INDEX_SIZE(V1_STATE_COUNT, EVENT_COUNT)];
+	static uint16_t              v2_index[FSM_INDEX_SIZE(V2_STATE_COUNT, EVENT_COUNT)];
+	static fsm_t                 orders[ORDER_COUNT];
+	static fsm_versions_reader_t readers[THREAD_COUNT];
+	static fsm_version_t         v1;
+	static fsm_version_t         v2;
+	fsm_versions_t               versions;
+	fsm_executor_t*              executor = NULL;
+
+	fsm_result_t result = build(&v1, v1_transitions, sizeof(v1_transitions) / sizeof(fsm_transition_t), v1_index,
+								V1_STATE_COUNT);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = build(&v2, v2_transitions, sizeof(v2_transitions) / sizeof(fsm_transition_t), v2_index,
+					   V2_STATE_COUNT);
+		v2.remap = remap_v1;
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_versions_init(&versions, &v1, readers, THREAD_COUNT);
+	}
+	for (size_t id = 0; id < ORDER_COUNT && result == FSM_RESULT_SUCCESS; id++) {
+		result = fsm_versions_attach(&versions, &orders[id], V1_NEW);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		fsm_executor_config_t config = {.thread_count = THREAD_COUNT, .versions = &versions};
+		result                       = fsm_executor_create(&executor, orders, ORDER_COUNT, &config);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	// Publish while the workers are dispatching; each order moves to version 2 with its next event.
+	for (size_t round = 0; round < ROUND_COUNT; round++) {
+		post_round(executor, round);
+		if (round == ROUND_COUNT / 2) {
+			fsm_versions_publish(&versions, &v2);
+			printf("Version 2 published during round %zu\n", round);
+		}
+	}
+	fsm_executor_wait_idle(executor);
+	// Every order got events after the publication, so version 1 goes once each worker passed a quiescent state.
+	while (fsm_versions_reclaim(&versions) == 0) {
+		fsm_executor_wait_idle(executor);
+	}
+
+	fsm_executor_stats_t stats;
+	fsm_executor_stats(executor, &stats);
+	fsm_executor_destroy(executor);
+
+	size_t counts[V2_STATE_COUNT] = {0};
+	size_t stale                  = 0;
+	for (size_t id = 0; id < ORDER_COUNT; id++) {
+		stale += orders[id].def != &v2.def;
+		counts[orders[id].current_state]++;
+	}
+	printf("Processed %llu events, %zu orders left on version 1\n", (unsigned long long)stats.events_processed, stale);
+	printf("NEW %zu, PAID %zu, PACKED %zu, SHIPPED %zu\n", counts[V2_NEW], counts[V2_PAID], counts[V2_PACKED],
+		   counts[V2_SHIPPED]);
+	return 0;
+}
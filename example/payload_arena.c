@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm_arena.h"
+#include "fsm_queue.h"
+
+// Account states
+typedef enum {
+	STATE_IDLE,
+	STATE_ACTIVE,
+	STATE_COUNT,
+} state_t;
+
+// Account events
+typedef enum {
+	EVENT_ORDER,
+	EVENT_CLOSE,
+	EVENT_COUNT,
+} event_t;
+
+// Payload types carried in envelopes
+enum { PAYLOAD_ORDER = 1 };
+
+typedef struct order {
+	uint64_t id;
+	uint32_t quantity;
+	uint32_t price;
+} order_t;
+
+#define ACCOUNT_COUNT 64
+#define BURST_SIZE    256
+#define BURST_COUNT   400
+#define BATCH_SIZE    512
+#define BATCH_COUNT   200
+
+static uint64_t total_quantity;
+static uint64_t total_orders;
+
+static void on_order(fsm_t* fsm, void* data) {
+	const order_t* order = (const order_t*)fsm_envelope_payload(data, PAYLOAD_ORDER);
+	if (order) {
+		total_quantity += order->quantity;
+		total_orders++;
+	}
+}
+
+static const fsm_transition_t transitions[] = {
+	{
+		.event              = EVENT_ORDER,
+		.source_states_mask = FSM_STATES_MASK(STATE_IDLE, STATE_ACTIVE),
+		.target_state       = STATE_ACTIVE,
+		.on_entry           = on_order,
+	},
+	{
+		.event              = EVENT_CLOSE,
+		.source_states_mask = FSM_STATE_MASK(STATE_ACTIVE),
+		.target_state       = STATE_IDLE,
+	},
+};
+
+// Allocates an order envelope, NULL if the arena has no free block.
+static fsm_envelope_t* make_order(fsm_arena_t* arena, uint64_t id) {
+	fsm_envelope_t* envelope = fsm_arena_alloc(arena, PAYLOAD_ORDER, sizeof(order_t));
+	order_t*        order    = (order_t*)fsm_envelope_payload(envelope, PAYLOAD_ORDER);
+	if (order) {
+		order->id       = id;
+		order->quantity = (uint32_t)(id % 10 + 1);
+		order->price    = (uint32_t)(1000 + id % 50);
+	}
+	return envelope;
+}
+
+int main(void) {
+	static char         buffer[64 * 1024];
+	static fsm_t        accounts[ACCOUNT_COUNT];
+	static fsm_t*       instances[BATCH_SIZE];
+	static fsm_event_t  events[BATCH_SIZE];
+	static void*        payloads[BATCH_SIZE];
+	static fsm_result_t results[BATCH_SIZE];
+	fsm_queue_slot_t    slots[BURST_SIZE];
+	fsm_queue_t         queue;
+	fsm_arena_t         arena;
+	fsm_def_t           def;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	for (size_t i = 0; i < ACCOUNT_COUNT && result == FSM_RESULT_SUCCESS; i++) {
+		result = fsm_init(&accounts[i], &def, STATE_IDLE);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_queue_init(&queue, &accounts[0], slots, BURST_SIZE);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_arena_init(&arena, buffer, sizeof(buffer), 4096);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	printf("Arena: %zu blocks of %zu bytes\n", arena.block_count, arena.block_size);
+
+	// Queued events: the payload moves into the queue, which releases it after the action ran.
+	uint64_t id = 0;
+	for (size_t burst = 0; burst < BURST_COUNT; burst++) {
+		for (size_t i = 0; i < BURST_SIZE; i++) {
+			fsm_envelope_t* envelope = make_order(&arena, id++);
+			if (!envelope || fsm_post_envelope(&queue, EVENT_ORDER, envelope) != FSM_RESULT_SUCCESS) {
+				fsm_envelope_release(envelope);
+				break;
+			}
+		}
+		fsm_drain(&queue);
+	}
+	printf("Queue: %llu orders, quantity %llu\n", (unsigned long long)total_orders,
+		   (unsigned long long)total_quantity);
+
+	// Batched events: the whole batch is released at once after dispatch.
+	total_orders   = 0;
+	total_quantity = 0;
+	for (size_t batch = 0; batch < BATCH_COUNT; batch++) {
+		size_t count = 0;
+		while (count < BATCH_SIZE && (payloads[count] = make_order(&arena, id)) != NULL) {
+			instances[count] = &accounts[id % ACCOUNT_COUNT];
+			events[count]    = EVENT_ORDER;
+			count++;
+			id++;
+		}
+		fsm_process_events_batch(instances, events, payloads, results, count);
+		fsm_envelopes_release(payloads, count);
+	}
+	printf("Batch: %llu orders, quantity %llu\n", (unsigned long long)total_orders,
+		   (unsigned long long)total_quantity);
+	printf("Allocations refused for lack of a free block: %llu\n", (unsigned long long)arena.exhausted);
+	return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm_pool.h"
+
+// Worker states
+typedef enum {
+	STATE_IDLE,
+	STATE_BUSY,
+	STATE_COUNT,
+} state_t;
+
+// Worker events
+typedef enum {
+	EVENT_START,
+	EVENT_COUNT,
+} event_t;
+
+#define CAPACITY 8
+
+static fsm_pool_t   pool;
+static fsm_handle_t replacement;
+
+// Started with a victim handle, the worker retires the victim and creates a replacement, which the free
+// list places in the victim's slot.
+static void retire(fsm_t* fsm, void* data) {
+	if (data) {
+		fsm_pool_destroy(&pool, *(const fsm_handle_t*)data);
+		fsm_pool_create(&pool, fsm->def, STATE_IDLE, &replacement);
+	}
+}
+
+static const fsm_transition_t transitions[] = {
+	{
+		.on_entry           = retire,
+		.source_states_mask = FSM_STATE_MASK(STATE_IDLE),
+		.target_state       = STATE_BUSY,
+		.event              = EVENT_START,
+	},
+};
+
+static int check(const char* name, int ok) {
+	printf("%-28s %s\n", name, ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+// Fills the pool, then destroys a handle and checks that every use of it is rejected.
+static int check_stale(const fsm_def_t* def) {
+	fsm_handle_t handles[CAPACITY];
+	fsm_handle_t extra;
+	int          ok = 1;
+	for (int i = 0; i < CAPACITY; i++) {
+		ok = ok && fsm_pool_create(&pool, def, STATE_IDLE, &handles[i]) == FSM_RESULT_SUCCESS;
+	}
+	ok = ok && fsm_pool_create(&pool, def, STATE_IDLE, &extra) == FSM_RESULT_POOL_FULL;
+	ok = ok && fsm_pool_destroy(&pool, handles[3]) == FSM_RESULT_SUCCESS;
+	ok = ok && fsm_pool_get(&pool, handles[3]) == NULL;
+	ok = ok && fsm_pool_process_event(&pool, handles[3], EVENT_START, NULL) == FSM_RESULT_INVALID_HANDLE;
+	ok = ok && fsm_pool_destroy(&pool, handles[3]) == FSM_RESULT_INVALID_HANDLE;
+	// The slot is reused under a new generation, the old handle stays stale.
+	ok = ok && fsm_pool_create(&pool, def, STATE_IDLE, &extra) == FSM_RESULT_SUCCESS;
+	ok = ok && extra != handles[3] && fsm_pool_get(&pool, handles[3]) == NULL && fsm_pool_get(&pool, extra);
+	for (int i = 0; i < CAPACITY; i++) {
+		fsm_pool_destroy(&pool, i == 3 ? extra : handles[i]);
+	}
+	return check("create, destroy, stale", ok && pool.count == 0);
+}
+
+// Recycles one slot through every generation: the generation counts 1 to 2^FSM_HANDLE_GENERATION_BITS - 1 and
+// wraps back to 1, so handles only repeat after that many reuses and never equal FSM_HANDLE_NONE.
+static int check_wrap(const fsm_def_t* def) {
+	const unsigned generations = (1u << FSM_HANDLE_GENERATION_BITS) - 1;
+	fsm_handle_t   first       = FSM_HANDLE_NONE;
+	fsm_handle_t   previous    = FSM_HANDLE_NONE;
+	int            ok          = 1;
+	for (unsigned i = 0; i <= generations && ok; i++) {
+		fsm_handle_t handle;
+		ok = fsm_pool_create(&pool, def, STATE_IDLE, &handle) == FSM_RESULT_SUCCESS && handle != FSM_HANDLE_NONE;
+		if (i == 0) {
+			first = handle;
+		}
+		// Generations of the slot follow each other, starting wherever earlier checks left it.
+		unsigned expected = ((first >> FSM_HANDLE_INDEX_BITS) - 1 + i) % generations + 1;
+		ok                = ok && handle >> FSM_HANDLE_INDEX_BITS == expected;
+		ok                = ok && fsm_pool_get(&pool, previous) == NULL;
+		ok                = ok && fsm_pool_destroy(&pool, handle) == FSM_RESULT_SUCCESS;
+		previous          = handle;
+	}
+	ok = ok && previous == first;
+	return check("generation wrap", ok);
+}
+
+// Destroys instances in the middle and at the ends of the dense list and checks that iteration still visits
+// exactly the live instances, each resolvable through the handle it reports.
+static int check_dense(const fsm_def_t* def) {
+	static const int destroyed[] = {0, 4, 7, 2};
+	fsm_handle_t     handles[CAPACITY];
+	int              live[CAPACITY];
+	int              ok = 1;
+	for (int i = 0; i < CAPACITY; i++) {
+		ok      = ok && fsm_pool_create(&pool, def, STATE_IDLE, &handles[i]) == FSM_RESULT_SUCCESS;
+		live[i] = 1;
+	}
+	for (size_t d = 0; d < sizeof(destroyed) / sizeof(destroyed[0]); d++) {
+		fsm_pool_destroy(&pool, handles[destroyed[d]]);
+		live[destroyed[d]] = 0;
+
+		int seen[CAPACITY] = {0};
+		for (size_t position = 0; position < pool.count; position++) {
+			fsm_handle_t handle;
+			fsm_t*       fsm = fsm_pool_at(&pool, position, &handle);
+			ok               = ok && fsm && fsm_pool_get(&pool, handle) == fsm;
+			for (int i = 0; i < CAPACITY; i++) {
+				seen[i] += handle == handles[i];
+			}
+		}
+		for (int i = 0; i < CAPACITY; i++) {
+			ok = ok && seen[i] == live[i];
+		}
+		ok = ok && fsm_pool_at(&pool, pool.count, NULL) == NULL;
+	}
+	for (int i = 0; i < CAPACITY; i++) {
+		if (live[i]) {
+			fsm_pool_destroy(&pool, handles[i]);
+		}
+	}
+	return check("swap-remove iteration", ok && pool.count == 0);
+}
+
+// The first item's action destroys the instance of the second item and reuses its slot: the second item must
+// be rejected instead of reaching the replacement, and the third item runs normally.
+static int check_batch(const fsm_def_t* def) {
+	fsm_handle_t handles[3];
+	fsm_result_t results[3];
+	fsm_event_t  events[3] = {EVENT_START, EVENT_START, EVENT_START};
+	int          ok        = 1;
+	for (int i = 0; i < 3; i++) {
+		ok = ok && fsm_pool_create(&pool, def, STATE_IDLE, &handles[i]) == FSM_RESULT_SUCCESS;
+	}
+	void* data[3] = {&handles[1], NULL, NULL};
+	ok            = ok && fsm_pool_process_events_batch(&pool, handles, events, data, results, 3) == FSM_RESULT_SUCCESS;
+
+	fsm_t* reborn = fsm_pool_get(&pool, replacement);
+	ok            = ok && results[0] == FSM_RESULT_SUCCESS;
+	ok            = ok && results[1] == FSM_RESULT_INVALID_HANDLE;
+	ok            = ok && results[2] == FSM_RESULT_SUCCESS;
+	ok            = ok && (replacement & (FSM_POOL_MAX_CAPACITY - 1)) == (handles[1] & (FSM_POOL_MAX_CAPACITY - 1));
+	ok            = ok && reborn && fsm_current_state(reborn) == STATE_IDLE;
+	return check("batch handle check", ok);
+}
+
+int main(void) {
+	static fsm_t           instances[CAPACITY];
+	static fsm_pool_slot_t slots[CAPACITY];
+	static uint32_t        dense[CAPACITY];
+	fsm_def_t              def;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_pool_init(&pool, instances, slots, dense, CAPACITY);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("Pool init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	int failures = check_stale(&def);
+	failures += check_wrap(&def);
+	failures += check_dense(&def);
+	failures += check_batch(&def);
+	return failures ? -1 : 0;
+}
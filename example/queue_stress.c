@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "fsm_queue.h"
+
+// Sink states, every item is a self-transition
+typedef enum {
+	STATE_RECEIVING,
+	STATE_COUNT,
+} state_t;
+
+// Sink events
+typedef enum {
+	EVENT_ITEM,
+	EVENT_COUNT,
+} event_t;
+
+#define PRODUCER_COUNT 4
+#define ITEM_COUNT     200000
+#define QUEUE_CAPACITY 64
+
+// Items carry their producer in the high bits and a per-producer sequence number in the low ones.
+#define ITEM_SHIFT 24
+
+typedef struct producer {
+	fsm_queue_t* queue;
+	unsigned     id;
+	size_t       full;  // Posts refused with FSM_RESULT_QUEUE_FULL and retried.
+} producer_t;
+
+typedef struct tally {
+	fsm_queue_t* queue;
+	size_t       expected[PRODUCER_COUNT];  // Next sequence number of each producer.
+	size_t       out_of_order;              // Items lost, duplicated or reordered within a producer.
+	size_t       nested;                    // Events a nested fsm_drain() processed, must stay 0.
+	size_t       received;
+} tally_t;
+
+static void receive(fsm_t* fsm, void* data) {
+	tally_t*  tally    = fsm_userdata(fsm);
+	uintptr_t item     = (uintptr_t)data;
+	size_t    producer = (size_t)(item >> ITEM_SHIFT);
+	size_t    sequence = (size_t)(item & ((1u << ITEM_SHIFT) - 1));
+	if (producer >= PRODUCER_COUNT || sequence != tally->expected[producer]) {
+		tally->out_of_order++;
+	} else {
+		tally->expected[producer]++;
+	}
+	tally->received++;
+	// The outer fsm_drain() is running, a nested one must not dispatch.
+	tally->nested += fsm_drain(tally->queue);
+}
+
+static const fsm_transition_t transitions[] = {
+	{
+		.on_entry           = receive,
+		.source_states_mask = FSM_STATE_MASK(STATE_RECEIVING),
+		.target_state       = STATE_RECEIVING,
+		.event              = EVENT_ITEM,
+	},
+};
+
+static void* produce(void* arg) {
+	producer_t* producer = arg;
+	for (uintptr_t sequence = 0; sequence < ITEM_COUNT; sequence++) {
+		void* item = (void*)(((uintptr_t)producer->id << ITEM_SHIFT) | sequence);
+		while (fsm_post_event(producer->queue, EVENT_ITEM, item) == FSM_RESULT_QUEUE_FULL) {
+			producer->full++;
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+// A full queue refuses exactly the post past its capacity and drains everything it accepted.
+static int check_full(fsm_queue_t* queue, tally_t* tally) {
+	size_t accepted = 0;
+	while (fsm_post_event(queue, EVENT_ITEM, (void*)(uintptr_t)accepted) == FSM_RESULT_SUCCESS) {
+		accepted++;
+	}
+	size_t drained = fsm_drain(queue);
+	printf("Full queue: accepted %zu of %d slots, drained %zu\n", accepted, QUEUE_CAPACITY, drained);
+	int ok = accepted == QUEUE_CAPACITY && drained == QUEUE_CAPACITY && tally->expected[0] == accepted;
+	// Producer 0 starts over in the threaded run.
+	tally->expected[0] = 0;
+	tally->received    = 0;
+	return ok;
+}
+
+int main(void) {
+	static fsm_queue_slot_t slots[QUEUE_CAPACITY];
+	pthread_t               threads[PRODUCER_COUNT];
+	producer_t              producers[PRODUCER_COUNT];
+	tally_t                 tally = {0};
+	fsm_def_t               def;
+	fsm_t                   sink;
+	fsm_queue_t             queue;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&sink, &def, STATE_RECEIVING);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_queue_init(&queue, &sink, slots, QUEUE_CAPACITY);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	tally.queue = &queue;
+	fsm_set_userdata(&sink, &tally);
+
+	int ok = check_full(&queue, &tally);
+
+	for (unsigned i = 0; i < PRODUCER_COUNT; i++) {
+		producers[i] = (producer_t){.queue = &queue, .id = i};
+		pthread_create(&threads[i], NULL, produce, &producers[i]);
+	}
+	while (tally.received < (size_t)PRODUCER_COUNT * ITEM_COUNT) {
+		if (fsm_drain(&queue) == 0) {
+			sched_yield();
+		}
+	}
+	for (unsigned i = 0; i < PRODUCER_COUNT; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	size_t full = 0;
+	for (unsigned i = 0; i < PRODUCER_COUNT; i++) {
+		full += producers[i].full;
+	}
+	printf("%d producers x %d items: %zu out of order, %zu nested dispatches, %zu full retries\n", PRODUCER_COUNT,
+		   ITEM_COUNT, tally.out_of_order, tally.nested, full);
+	ok = ok && tally.out_of_order == 0 && tally.nested == 0 && fsm_drain(&queue) == 0;
+	for (unsigned i = 0; i < PRODUCER_COUNT; i++) {
+		ok = ok && tally.expected[i] == ITEM_COUNT;
+	}
+	printf("%s\n", ok ? "OK" : "FAILED");
+	return ok ? 0 : -1;
+}
@@ -0,0 +1,203 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "fsm_analyze.h"
+
+// Router states, a request is routed to one of the handlers and returns to WAITING when done
+typedef enum {
+	STATE_WAITING,
+	STATE_ADMIN,
+	STATE_STATIC,
+	STATE_API,
+	STATE_NOT_FOUND,
+	STATE_COUNT,
+} state_t;
+
+// Router events
+typedef enum {
+	EVENT_REQUEST,
+	EVENT_DONE,
+	EVENT_COUNT,
+} event_t;
+
+#define RULE_CAPACITY 8
+#define REQUEST_COUNT 100000
+
+static const char* state_names[] = {"WAITING", "ADMIN", "STATIC", "API", "NOT_FOUND"};
+
+static size_t guard_calls;
+
+static int has_prefix(void* data, const char* prefix) {
+	guard_calls++;
+	return strncmp((const char*)data, prefix, strlen(prefix)) == 0 ? 0 : 1;
+}
+
+static int is_admin(fsm_t* fsm, void* data) {
+	return has_prefix(data, "/admin/");
+}
+
+static int is_static(fsm_t* fsm, void* data) {
+	return has_prefix(data, "/static/");
+}
+
+static int is_api(fsm_t* fsm, void* data) {
+	return has_prefix(data, "/api/");
+}
+
+// Alternatives for one event, tried in order until a guard passes. The prefixes exclude each other, so the
+// order only decides how many guards a request costs; the last rule catches everything else.
+static const fsm_transition_t transitions[] = {
+	{
+		.guard              = is_admin,
+		.source_states_mask = FSM_STATE_MASK(STATE_WAITING),
+		.target_state       = STATE_ADMIN,
+		.event              = EVENT_REQUEST,
+	},
+	{
+		.guard              = is_static,
+		.source_states_mask = FSM_STATE_MASK(STATE_WAITING),
+		.target_state       = STATE_STATIC,
+		.event              = EVENT_REQUEST,
+	},
+	{
+		.guard              = is_api,
+		.source_states_mask = FSM_STATE_MASK(STATE_WAITING),
+		.target_state       = STATE_API,
+		.event              = EVENT_REQUEST,
+	},
+	{
+		.source_states_mask = FSM_STATE_MASK(STATE_WAITING),
+		.target_state       = STATE_NOT_FOUND,
+		.event              = EVENT_REQUEST,
+	},
+	{
+		.source_states_mask = FSM_STATES_MASK(STATE_ADMIN, STATE_STATIC, STATE_API, STATE_NOT_FOUND),
+		.target_state       = STATE_WAITING,
+		.event              = EVENT_DONE,
+	},
+};
+
+// Mostly API calls, some assets, rarely the admin pages.
+static const char* next_path(size_t i) {
+	static const char* paths[] = {"/api/orders", "/static/app.js", "/api/users", "/favicon.ico",
+								  "/api/orders", "/static/app.css", "/api/cart", "/admin/users"};
+	size_t             k       = i % 100;
+	return paths[k < 60 ? k % 2 * 2 : k < 90 ? 1 + k % 2 * 4 : k < 97 ? 6 : k < 99 ? 3 : 7];
+}
+
+static fsm_result_t build(fsm_def_t* def, const fsm_transition_t* rules, size_t rule_count, uint16_t* index,
+						  uint16_t* chain) {
+	fsm_result_t result = fsm_def_init(def, rules, rule_count);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(def, index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT, EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_fallthrough(def, chain, FSM_CHAIN_SIZE(STATE_COUNT, RULE_CAPACITY));
+	}
+	return result;
+}
+
+// Routes the requests, returns the number of guard calls they took.
+static size_t route(const fsm_def_t* def, size_t* routed) {
+	fsm_t fsm;
+	fsm_init(&fsm, def, STATE_WAITING);
+	guard_calls = 0;
+	memset(routed, 0, STATE_COUNT * sizeof(size_t));
+	for (size_t i = 0; i < REQUEST_COUNT; i++) {
+		fsm_process_event(&fsm, EVENT_REQUEST, (void*)next_path(i));
+		routed[fsm_current_state(&fsm)]++;
+		fsm_process_event(&fsm, EVENT_DONE, NULL);
+	}
+	return guard_calls;
+}
+
+static void print_rules(const fsm_transition_t* rules, size_t rule_count) {
+	for (size_t i = 0; i < rule_count; i++) {
+		const fsm_transition_t* rule  = &rules[i];
+		const char*             guard = rule->guard == is_admin    ? "is_admin"
+									  : rule->guard == is_static ? "is_static"
+									  : rule->guard == is_api    ? "is_api"
+																 : NULL;
+		printf("  %s -> %s", rule->event == EVENT_REQUEST ? "REQUEST" : "DONE", state_names[rule->target_state]);
+		if (guard) {
+			printf(" guard=%s", guard);
+		}
+		printf("\n");
+	}
+}
+
+int main(void) {
+	static uint16_t  index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	static uint16_t  chain[FSM_CHAIN_SIZE(STATE_COUNT, RULE_CAPACITY)];
+	static uint64_t  hits[RULE_CAPACITY];
+	static uint64_t  denials[RULE_CAPACITY];
+	fsm_transition_t reordered[RULE_CAPACITY];
+	size_t           origins[RULE_CAPACITY];
+	size_t           rule_count = 0;
+	size_t           routed[STATE_COUNT];
+	fsm_stats_t      profile;
+	fsm_def_t        def;
+
+	fsm_result_t result = build(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t), index, chain);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_stats_init(&profile, &def, hits, denials, RULE_CAPACITY);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	// Profiling run: the statistics count how often each rule fired.
+	fsm_stats_attach(&profile);
+	size_t before = route(&def, routed);
+	fsm_stats_attach(NULL);
+	printf("Declared order: %zu guard calls for %d requests\n", before, REQUEST_COUNT);
+	for (fsm_state_t state = STATE_ADMIN; state < STATE_COUNT; state++) {
+		printf("  %-9s %zu\n", state_names[state], routed[state]);
+	}
+	if (profile.results[FSM_RESULT_SUCCESS] == 0) {
+		printf("No profile, build with FSM_ENABLE_STATS=ON to reorder the rules\n");
+		return 0;
+	}
+
+	// Most frequent alternative first. A build would print this table with fsm_check -P and compile it in.
+	result = fsm_def_reorder(&def, &profile, reordered, origins, RULE_CAPACITY, &rule_count);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = build(&def, reordered, rule_count, index, chain);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("Reordering failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	printf("Reordered rules:\n");
+	print_rules(reordered, rule_count);
+	size_t after = route(&def, routed);
+	printf("Reordered: %zu guard calls for %d requests\n", after, REQUEST_COUNT);
+	for (fsm_state_t state = STATE_ADMIN; state < STATE_COUNT; state++) {
+		printf("  %-9s %zu\n", state_names[state], routed[state]);
+	}
+	return 0;
+}
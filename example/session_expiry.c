@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "fsm_members.h"
+
+// Session states
+typedef enum {
+	STATE_IDLE,
+	STATE_CONNECTING,
+	STATE_ACCEPTING,
+	STATE_ESTABLISHED,
+	STATE_CLOSED,
+	STATE_COUNT,
+} state_t;
+
+// Session events
+typedef enum {
+	EVENT_DIAL,
+	EVENT_OFFER,
+	EVENT_ACCEPT,
+	EVENT_EXPIRE,
+	EVENT_COUNT,
+} event_t;
+
+#define SESSION_COUNT 200000
+
+static const char* state_names[] = {"IDLE", "CONNECTING", "ACCEPTING", "ESTABLISHED", "CLOSED"};
+
+static const fsm_transition_t transitions[] = {
+	{
+		.event              = EVENT_DIAL,
+		.source_states_mask = FSM_STATE_MASK(STATE_IDLE),
+		.target_state       = STATE_CONNECTING,
+	},
+	{
+		.event              = EVENT_OFFER,
+		.source_states_mask = FSM_STATE_MASK(STATE_CONNECTING),
+		.target_state       = STATE_ACCEPTING,
+	},
+	{
+		.event              = EVENT_ACCEPT,
+		.source_states_mask = FSM_STATE_MASK(STATE_ACCEPTING),
+		.target_state       = STATE_ESTABLISHED,
+	},
+	{
+		.event              = EVENT_EXPIRE,
+		.source_states_mask = FSM_STATES_MASK(STATE_CONNECTING, STATE_ACCEPTING),
+		.target_state       = STATE_CLOSED,
+	},
+};
+
+static void print_counts(const fsm_members_t* members) {
+	for (fsm_state_t state = 0; state < STATE_COUNT; state++) {
+		printf("  %-12s %zu\n", state_names[state], fsm_members_count(members, state));
+	}
+}
+
+int main(void) {
+	static uint16_t          dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	static fsm_t             sessions[SESSION_COUNT];
+	static fsm_member_node_t nodes[SESSION_COUNT];
+	fsm_def_t                def;
+	fsm_members_t            members;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	for (size_t i = 0; i < SESSION_COUNT && result == FSM_RESULT_SUCCESS; i++) {
+		result = fsm_init(&sessions[i], &def, STATE_IDLE);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_members_init(&members, &def, sessions, nodes, SESSION_COUNT);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	// Regular traffic, most sessions get established; the index follows every transition
+	srand(42);
+	for (size_t i = 0; i < SESSION_COUNT; i++) {
+		int steps = rand() % 100 < 98 ? 3 : rand() % 3;
+		for (int step = 0; step < steps; step++) {
+			fsm_process_event(&sessions[i], (fsm_event_t)step, NULL);
+		}
+	}
+	printf("Sessions per state:\n");
+	print_counts(&members);
+
+	// The index answers without touching the population; a scan has to look at every session
+	clock_t start     = clock();
+	size_t  accepting = 0;
+	for (size_t i = 0; i < SESSION_COUNT; i++) {
+		accepting += fsm_current_state(&sessions[i]) == STATE_ACCEPTING;
+	}
+	double scan_us = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC;
+	printf("ACCEPTING by scan: %zu (%.0f us), by index: %zu\n", accepting, scan_us,
+		   fsm_members_count(&members, STATE_ACCEPTING));
+
+	// Expire everything still waiting for the peer, visiting only those sessions
+	static const fsm_states_mask_t waiting = FSM_STATES_MASK(STATE_CONNECTING, STATE_ACCEPTING);
+
+	start               = clock();
+	size_t expired      = fsm_broadcast(&members, &waiting, EVENT_EXPIRE, NULL);
+	double broadcast_us = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC;
+	printf("Expired: %zu (%.0f us)\n", expired, broadcast_us);
+	print_counts(&members);
+
+	fsm_members_deinit(&members);
+	return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fsm_shared.h"
+
+// Job states
+typedef enum {
+	STATE_QUEUED,
+	STATE_RUNNING,
+	STATE_DONE,
+	STATE_COUNT,
+} state_t;
+
+// Job events
+typedef enum {
+	EVENT_START,
+	EVENT_FINISH,
+	EVENT_RECYCLE,
+	EVENT_COUNT,
+} event_t;
+
+#define SEGMENT_NAME  "/fsm_shared_population"
+#define JOB_COUNT     1000
+#define PROCESS_COUNT 4
+#define ROUND_COUNT   300
+
+// No guards or actions, so every transition is a single compare-and-swap on the shared word.
+static const fsm_transition_t transitions[] = {
+	{.source_states_mask = FSM_STATE_MASK(STATE_QUEUED), .target_state = STATE_RUNNING, .event = EVENT_START},
+	{.source_states_mask = FSM_STATE_MASK(STATE_RUNNING), .target_state = STATE_DONE, .event = EVENT_FINISH},
+	{.source_states_mask = FSM_STATE_MASK(STATE_DONE), .target_state = STATE_QUEUED, .event = EVENT_RECYCLE},
+};
+
+static uint16_t  index_table[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+static fsm_def_t def;
+
+// Worker process: maps the segment with its own definition and drives every job.
+static unsigned long run_worker(size_t worker, const fsm_handle_t* jobs) {
+	fsm_shared_t  shared;
+	unsigned long transitions_done = 0;
+	if (fsm_shared_open(&shared, SEGMENT_NAME, &def) != FSM_RESULT_SUCCESS) {
+		return 0;
+	}
+	for (size_t round = 0; round < ROUND_COUNT; round++) {
+		for (size_t id = 0; id < JOB_COUNT; id++) {
+			fsm_event_t event = (fsm_event_t)((round + worker + id) % EVENT_COUNT);
+			transitions_done += fsm_shared_process(&shared, jobs[id], event, NULL) == FSM_RESULT_SUCCESS;
+		}
+	}
+	fsm_shared_close(&shared);
+	return transitions_done;
+}
+
+int main(void) {
+	static fsm_handle_t jobs[JOB_COUNT];
+	fsm_shared_t        shared;
+	int                 counts[2];
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, index_table, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		// Remove a segment left behind by an earlier run that was killed.
+		fsm_shared_unlink(SEGMENT_NAME);
+		result = fsm_shared_create(&shared, SEGMENT_NAME, &def, JOB_COUNT);
+	}
+	for (size_t id = 0; id < JOB_COUNT && result == FSM_RESULT_SUCCESS; id++) {
+		result = fsm_shared_alloc(&shared, STATE_QUEUED, &jobs[id]);
+	}
+	if (result != FSM_RESULT_SUCCESS || pipe(counts) != 0) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	printf("Shared population: %zu jobs, lock-free transitions: %s\n", (size_t)JOB_COUNT,
+		   shared.lock_free ? "yes" : "no");
+	fsm_shared_close(&shared);
+
+	// Each worker reports the number of transitions it made through the pipe.
+	for (size_t worker = 0; worker < PROCESS_COUNT; worker++) {
+		if (fork() == 0) {
+			unsigned long done = run_worker(worker, jobs);
+			ssize_t       size = write(counts[1], &done, sizeof(done));
+			_exit(size == sizeof(done) ? 0 : 1);
+		}
+	}
+	unsigned long total = 0;
+	for (size_t worker = 0; worker < PROCESS_COUNT; worker++) {
+		unsigned long done = 0;
+		if (read(counts[0], &done, sizeof(done)) == sizeof(done)) {
+			printf("Worker %zu made %lu transitions\n", worker, done);
+			total += done;
+		}
+		wait(NULL);
+	}
+
+	// An observer needs no definition and reads the words without system calls.
+	fsm_shared_t observer;
+	if (fsm_shared_open_readonly(&observer, SEGMENT_NAME) != FSM_RESULT_SUCCESS) {
+		printf("Observer failed to map the segment\n");
+		fsm_shared_unlink(SEGMENT_NAME);
+		return -1;
+	}
+	size_t             states[STATE_COUNT] = {0};
+	unsigned long      sequences           = 0;
+	fsm_shared_entry_t entry;
+	for (size_t i = 0; i < observer.header->capacity; i++) {
+		if (fsm_shared_read(&observer, i, &entry) == FSM_RESULT_SUCCESS && entry.live) {
+			states[entry.state]++;
+			sequences += entry.sequence;
+		}
+	}
+	fsm_shared_close(&observer);
+	fsm_shared_unlink(SEGMENT_NAME);
+
+	printf("QUEUED %zu, RUNNING %zu, DONE %zu\n", states[STATE_QUEUED], states[STATE_RUNNING], states[STATE_DONE]);
+	printf("Transitions made %lu, recorded in the segment %lu\n", total, sequences);
+	return 0;
+}
@@ -41,8 +41,12 @@ static const fsm_transition_t transitions[] = {
 };
 
 int main(void) {
+	fsm_def_t    def;
 	fsm_t        fsm;
-	fsm_result_t result = fsm_init(&fsm, STATE_INIT, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&fsm, &def, STATE_INIT);
+	}
 	if (result != FSM_RESULT_SUCCESS) {
 		printf("FSM init failed: %s\n", fsm_result_string(result));
 		return -1;
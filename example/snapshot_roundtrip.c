@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fsm_snapshot.h"
+
+// Account states
+typedef enum {
+	STATE_OPEN,
+	STATE_FROZEN,
+	STATE_CLOSED,
+	STATE_COUNT,
+} state_t;
+
+// Account events
+typedef enum {
+	EVENT_FREEZE,
+	EVENT_THAW,
+	EVENT_CLOSE,
+	EVENT_COUNT,
+} event_t;
+
+#define SNAPSHOT_PATH "snapshot_roundtrip.snap"
+#define ACCOUNT_COUNT 6
+// Index of the slot left unbound, like a free pool slot.
+#define UNBOUND_SLOT 2
+
+typedef struct account {
+	long balance;
+} account_t;
+
+// Closing waits for the ledger to settle, which suspends the transition.
+static void settle(fsm_t* fsm, void* data) {
+	fsm_suspend(fsm);
+}
+
+static const fsm_transition_t transitions[] = {
+	{.source_states_mask = FSM_STATE_MASK(STATE_OPEN), .target_state = STATE_FROZEN, .event = EVENT_FREEZE},
+	{.source_states_mask = FSM_STATE_MASK(STATE_FROZEN), .target_state = STATE_OPEN, .event = EVENT_THAW},
+	{
+		.on_exit            = settle,
+		.source_states_mask = FSM_STATES_MASK(STATE_OPEN, STATE_FROZEN),
+		.target_state       = STATE_CLOSED,
+		.event              = EVENT_CLOSE,
+	},
+};
+
+// A later revision lets frozen accounts close directly; its table hash differs.
+static const fsm_transition_t revised[] = {
+	{.source_states_mask = FSM_STATE_MASK(STATE_OPEN), .target_state = STATE_FROZEN, .event = EVENT_FREEZE},
+	{.source_states_mask = FSM_STATE_MASK(STATE_FROZEN), .target_state = STATE_CLOSED, .event = EVENT_CLOSE},
+};
+
+static void save_account(void* context, const fsm_t* fsm, void* record, size_t record_size) {
+	memcpy(record, fsm_userdata(fsm), record_size);
+}
+
+// Restored population, load_account() copies each record into the account of the same index.
+typedef struct population {
+	account_t accounts[ACCOUNT_COUNT];
+	fsm_t     instances[ACCOUNT_COUNT];
+} population_t;
+
+static void load_account(void* context, fsm_t* fsm, void* record, size_t record_size) {
+	population_t* restored = context;
+	account_t*    account  = &restored->accounts[fsm - restored->instances];
+	memcpy(account, record, record_size);
+	fsm_set_userdata(fsm, account);
+}
+
+static int check(const char* name, int ok) {
+	printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+// Compares restored instances with the originals: same state and balance, unbound slots stay unbound.
+static int same_population(const fsm_t* original, const fsm_t* restored) {
+	for (int i = 0; i < ACCOUNT_COUNT; i++) {
+		if (!original[i].def || !restored[i].def) {
+			if (original[i].def || restored[i].def) {
+				return 0;
+			}
+			continue;
+		}
+		const account_t* a = fsm_userdata(&original[i]);
+		const account_t* b = fsm_userdata(&restored[i]);
+		if (fsm_current_state(&original[i]) != fsm_current_state(&restored[i]) || a->balance != b->balance) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int main(void) {
+	static account_t    accounts[ACCOUNT_COUNT];
+	static fsm_t        population[ACCOUNT_COUNT];
+	static population_t restored;
+	fsm_t               zero_copy[ACCOUNT_COUNT];
+	fsm_def_t           def;
+	fsm_def_t           revised_def;
+	fsm_snapshot_map_t  map = {0};
+	fsm_snapshot_view_t view;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_init(&revised_def, revised, sizeof(revised) / sizeof(fsm_transition_t));
+	}
+	for (int i = 0; i < ACCOUNT_COUNT && result == FSM_RESULT_SUCCESS; i++) {
+		result              = fsm_init(&population[i], &def, STATE_OPEN);
+		accounts[i].balance = 100 * (i + 1);
+		fsm_set_userdata(&population[i], &accounts[i]);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+	population[UNBOUND_SLOT].def = NULL;
+	fsm_process_event(&population[1], EVENT_FREEZE, NULL);
+	fsm_process_event(&population[4], EVENT_FREEZE, NULL);
+
+	result = fsm_snapshot_write_file(SNAPSHOT_PATH, &def, population, ACCOUNT_COUNT, sizeof(account_t),
+									 save_account, NULL);
+	int failures = 0;
+	failures += check("write_file", result == FSM_RESULT_SUCCESS && access(SNAPSHOT_PATH ".tmp", F_OK) != 0);
+
+	result = fsm_snapshot_map_file(SNAPSHOT_PATH, &map);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_snapshot_view(&def, map.data, map.size, &view);
+	}
+	failures += check("map_file and view", result == FSM_RESULT_SUCCESS && view.count == ACCOUNT_COUNT &&
+											   view.states[UNBOUND_SLOT] == FSM_STATE_NONE);
+	if (result != FSM_RESULT_SUCCESS) {
+		unlink(SNAPSHOT_PATH);
+		return -1;
+	}
+
+	result = fsm_snapshot_restore(&view, &def, restored.instances, ACCOUNT_COUNT, load_account, &restored);
+	failures += check("restore with load",
+					  result == FSM_RESULT_SUCCESS && same_population(population, restored.instances));
+	result = fsm_snapshot_restore(&view, &def, zero_copy, ACCOUNT_COUNT, NULL, NULL);
+	failures += check("restore zero-copy", result == FSM_RESULT_SUCCESS && same_population(population, zero_copy));
+
+	result = fsm_snapshot_view(&revised_def, map.data, map.size, &view);
+	failures += check("view with another table", result == FSM_RESULT_DEFINITION_MISMATCH);
+	fsm_snapshot_unmap_file(&map);
+
+	// A suspended transition or an instance of another definition refuses the snapshot and keeps the file.
+	fsm_process_event(&population[0], EVENT_CLOSE, NULL);
+	result = fsm_snapshot_write_file(SNAPSHOT_PATH, &def, population, ACCOUNT_COUNT, sizeof(account_t),
+									 save_account, NULL);
+	failures += check("write with suspended transition", result == FSM_RESULT_BUSY);
+	fsm_resume(&population[0], NULL);
+	population[5].def = &revised_def;
+	result = fsm_snapshot_write_file(SNAPSHOT_PATH, &def, population, ACCOUNT_COUNT, sizeof(account_t),
+									 save_account, NULL);
+	failures += check("write with foreign instance", result == FSM_RESULT_DEFINITION_MISMATCH);
+	population[5].def = &def;
+
+	result = fsm_snapshot_map_file(SNAPSHOT_PATH, &map);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_snapshot_view(&def, map.data, map.size, &view);
+	}
+	// Account 0 has closed since, the file still holds it open.
+	failures += check("refused writes keep the file", result == FSM_RESULT_SUCCESS && view.states[0] == STATE_OPEN);
+	failures += check("no temporary file left", access(SNAPSHOT_PATH ".tmp", F_OK) != 0);
+	fsm_snapshot_unmap_file(&map);
+	unlink(SNAPSHOT_PATH);
+	return failures ? -1 : 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "fsm_stats.h"
+
+// Turnstile states
+typedef enum {
+	STATE_LOCKED,
+	STATE_UNLOCKED,
+	STATE_COUNT,
+} state_t;
+
+// Turnstile events, EVENT_ALARM has no rule
+typedef enum {
+	EVENT_COIN,
+	EVENT_PUSH,
+	EVENT_ALARM,
+	EVENT_COUNT,
+} event_t;
+
+// Turnstile rules, indices into transitions[]
+enum { RULE_UNLOCK, RULE_BLOCKED, RULE_REFUND, RULE_PASS, RULE_COUNT, RULE_NONE = RULE_COUNT };
+
+#define ROUND_COUNT 10
+// CPU time spent in UNLOCKED before each event, a lower bound of its dwell time.
+#define UNLOCKED_WAIT_NS 2000000
+
+static int valid_coin(fsm_t* fsm, void* data) {
+	return *(const int*)data ? 0 : 1;
+}
+
+static const fsm_transition_t transitions[RULE_COUNT] = {
+	[RULE_UNLOCK] =
+		{
+			.guard              = valid_coin,
+			.source_states_mask = FSM_STATE_MASK(STATE_LOCKED),
+			.target_state       = STATE_UNLOCKED,
+			.event              = EVENT_COIN,
+		},
+	[RULE_BLOCKED] =
+		{
+			.source_states_mask = FSM_STATE_MASK(STATE_LOCKED),
+			.target_state       = STATE_LOCKED,
+			.event              = EVENT_PUSH,
+		},
+	[RULE_REFUND] =
+		{
+			.source_states_mask = FSM_STATE_MASK(STATE_UNLOCKED),
+			.target_state       = STATE_UNLOCKED,
+			.event              = EVENT_COIN,
+		},
+	[RULE_PASS] =
+		{
+			.source_states_mask = FSM_STATE_MASK(STATE_UNLOCKED),
+			.target_state       = STATE_LOCKED,
+			.event              = EVENT_PUSH,
+		},
+};
+
+// One round of events with the outcome each one must be counted as.
+static const struct {
+	state_t      from;    // State the turnstile is in.
+	fsm_event_t  event;   // Event dispatched.
+	int          valid;   // Coin validity passed to the guard.
+	fsm_result_t result;  // Expected dispatch result.
+	int          rule;    // Rule expected to fire or be denied, RULE_NONE if none.
+} script[] = {
+	{STATE_LOCKED, EVENT_COIN, 0, FSM_RESULT_GUARD_DENIED, RULE_UNLOCK},
+	{STATE_LOCKED, EVENT_PUSH, 0, FSM_RESULT_SUCCESS, RULE_BLOCKED},
+	{STATE_LOCKED, EVENT_COIN, 1, FSM_RESULT_SUCCESS, RULE_UNLOCK},
+	{STATE_UNLOCKED, EVENT_COIN, 1, FSM_RESULT_SUCCESS, RULE_REFUND},
+	{STATE_UNLOCKED, EVENT_ALARM, 0, FSM_RESULT_NO_TRANSITION_FOR_STATE, RULE_NONE},
+	{STATE_UNLOCKED, EVENT_PUSH, 0, FSM_RESULT_SUCCESS, RULE_PASS},
+	{STATE_LOCKED, EVENT_COUNT, 0, FSM_RESULT_EVENT_OUT_OF_BOUNDS, RULE_NONE},
+};
+
+#define SCRIPT_LENGTH (sizeof(script) / sizeof(script[0]))
+
+static void spend_cpu(long ns) {
+	clock_t start = clock();
+	while ((double)(clock() - start) * 1e9 / CLOCKS_PER_SEC < (double)ns) {
+	}
+}
+
+static uint64_t histogram_total(const uint64_t* buckets) {
+	uint64_t total = 0;
+	for (int b = 0; b < FSM_STATS_LATENCY_BUCKETS; b++) {
+		total += buckets[b];
+	}
+	return total;
+}
+
+// Runs the script, half of the rounds counted in each block, and returns the number of script steps
+// that did not start in the expected state or returned an unexpected result.
+static size_t run(fsm_t* turnstile, fsm_stats_t* first, fsm_stats_t* second) {
+	size_t mismatches = 0;
+	for (int round = 0; round < ROUND_COUNT; round++) {
+		fsm_stats_attach(round < ROUND_COUNT / 2 ? first : second);
+		for (size_t i = 0; i < SCRIPT_LENGTH; i++) {
+			int valid = script[i].valid;
+			mismatches += fsm_current_state(turnstile) != script[i].from;
+			if (script[i].from == STATE_UNLOCKED) {
+				spend_cpu(UNLOCKED_WAIT_NS);
+			}
+			mismatches += fsm_process_event(turnstile, script[i].event, &valid) != script[i].result;
+		}
+	}
+	fsm_stats_attach(NULL);
+	return mismatches;
+}
+
+// Compares the merged counters with the totals the script implies.
+static size_t verify(const fsm_stats_t* stats) {
+	uint64_t results[FSM_RESULT_COUNT] = {0};
+	uint64_t hits[RULE_COUNT + 1]      = {0};
+	uint64_t denials[RULE_COUNT + 1]   = {0};
+	uint64_t exits[STATE_COUNT]        = {0};
+	uint64_t guards                    = 0;
+	for (size_t i = 0; i < SCRIPT_LENGTH; i++) {
+		results[script[i].result] += ROUND_COUNT;
+		if (script[i].result == FSM_RESULT_SUCCESS) {
+			hits[script[i].rule] += ROUND_COUNT;
+			exits[script[i].from] += ROUND_COUNT;
+		} else if (script[i].result == FSM_RESULT_GUARD_DENIED) {
+			denials[script[i].rule] += ROUND_COUNT;
+		}
+		if (script[i].rule != RULE_NONE && transitions[script[i].rule].guard) {
+			guards += ROUND_COUNT;
+		}
+	}
+
+	size_t failures = 0;
+	for (int r = 0; r < FSM_RESULT_COUNT; r++) {
+		failures += stats->results[r] != results[r];
+	}
+	for (int r = 0; r < RULE_COUNT; r++) {
+		printf("  rule %d: %llu hits, %llu denials\n", r, (unsigned long long)stats->rule_hits[r],
+			   (unsigned long long)stats->rule_denials[r]);
+		failures += stats->rule_hits[r] != hits[r] || stats->rule_denials[r] != denials[r];
+	}
+	for (int s = 0; s < STATE_COUNT; s++) {
+		printf("  state %d: %llu exits, %.1f ms dwell\n", s, (unsigned long long)stats->state_exits[s],
+			   (double)stats->state_dwell_ns[s] / 1e6);
+		failures += stats->state_exits[s] != exits[s];
+	}
+	// Every UNLOCKED visit spends the wait before the event that leaves it, LOCKED visits do not wait.
+	failures += stats->state_dwell_ns[STATE_UNLOCKED] < exits[STATE_UNLOCKED] * UNLOCKED_WAIT_NS;
+	failures += stats->state_dwell_ns[STATE_LOCKED] >= stats->state_dwell_ns[STATE_UNLOCKED];
+	failures += histogram_total(stats->callback_latency[FSM_STATS_GUARD]) != guards;
+	return failures;
+}
+
+int main(void) {
+	static uint64_t hits[2][RULE_COUNT];
+	static uint64_t denials[2][RULE_COUNT];
+	fsm_stats_t     stats[2];
+	fsm_def_t       def;
+	fsm_t           turnstile;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, RULE_COUNT);
+	if (result == FSM_RESULT_SUCCESS) {
+		static uint16_t index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+		result = fsm_def_compile(&def, index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT, EVENT_COUNT);
+	}
+	for (int i = 0; i < 2 && result == FSM_RESULT_SUCCESS; i++) {
+		result = fsm_stats_init(&stats[i], &def, hits[i], denials[i], RULE_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&turnstile, &def, STATE_LOCKED);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	size_t mismatches = run(&turnstile, &stats[0], &stats[1]);
+	fsm_stats_merge(&stats[0], &stats[1]);
+	if (!FSM_STATS_ENABLED) {
+		printf("Built without FSM_ENABLE_STATS, the counters stay at zero\n");
+		return mismatches || stats[0].results[FSM_RESULT_SUCCESS] ? -1 : 0;
+	}
+	printf("%d rounds of %zu events:\n", ROUND_COUNT, SCRIPT_LENGTH);
+	size_t failures = mismatches + verify(&stats[0]);
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? -1 : 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm.h"
+
+// Door states
+typedef enum {
+	STATE_CLOSED,
+	STATE_OPEN,
+	STATE_COUNT,
+} state_t;
+
+// Door events
+typedef enum {
+	EVENT_KNOCK,
+	EVENT_OPEN,
+	EVENT_CLOSE,
+	EVENT_COUNT,
+} event_t;
+
+// Set to make the observer call fsm_suspend().
+static int observer_suspends;
+
+// Guard that calls fsm_suspend() and refuses the knock.
+static int refuse_knock(fsm_t* fsm, void* data) {
+	fsm_suspend(fsm);
+	return 1;
+}
+
+// Guard that calls fsm_suspend() and lets the door open.
+static int allow_open(fsm_t* fsm, void* data) {
+	fsm_suspend(fsm);
+	return 0;
+}
+
+// Action that suspends until the latch reports it engaged.
+static void engage_latch(fsm_t* fsm, void* data) {
+	fsm_suspend(fsm);
+}
+
+static void notify(void* context, fsm_t* fsm, fsm_state_t from, fsm_state_t to) {
+	if (observer_suspends) {
+		fsm_suspend(fsm);
+	}
+}
+
+static const fsm_transition_t transitions[] = {
+	{
+		.guard              = refuse_knock,
+		.source_states_mask = FSM_STATE_MASK(STATE_CLOSED),
+		.target_state       = STATE_CLOSED,
+		.event              = EVENT_KNOCK,
+	},
+	{
+		.guard              = allow_open,
+		.source_states_mask = FSM_STATE_MASK(STATE_CLOSED),
+		.target_state       = STATE_OPEN,
+		.event              = EVENT_OPEN,
+	},
+	{
+		.on_entry           = engage_latch,
+		.source_states_mask = FSM_STATE_MASK(STATE_OPEN),
+		.target_state       = STATE_CLOSED,
+		.event              = EVENT_CLOSE,
+	},
+};
+
+#define TRANSITION_COUNT (sizeof(transitions) / sizeof(transitions[0]))
+
+// Prints one step and returns 1 if its result, pending flag or state is not the expected one.
+static int check(const char* step, const fsm_t* door, fsm_result_t result, fsm_result_t expected, int pending,
+				 state_t state) {
+	int failed = result != expected || !fsm_is_pending(door) != !pending || fsm_current_state(door) != state;
+	printf("%-28s %-36s %s\n", step, fsm_result_string(result), failed ? "FAILED" : "OK");
+	return failed;
+}
+
+// Only actions suspend a transition, a guard or the observer calling fsm_suspend() must not leave the door busy.
+static int run_events(fsm_t* door) {
+	int failures = 0;
+
+	fsm_result_t result = fsm_process_event(door, EVENT_KNOCK, NULL);
+	failures += check("guard suspends, denies", door, result, FSM_RESULT_GUARD_DENIED, 0, STATE_CLOSED);
+	result = fsm_process_event(door, EVENT_OPEN, NULL);
+	failures += check("guard suspends, allows", door, result, FSM_RESULT_SUCCESS, 0, STATE_OPEN);
+	result = fsm_process_event(door, EVENT_CLOSE, NULL);
+	failures += check("action suspends", door, result, FSM_RESULT_PENDING, 1, STATE_CLOSED);
+	result = fsm_process_event(door, EVENT_KNOCK, NULL);
+	failures += check("event while pending", door, result, FSM_RESULT_BUSY, 1, STATE_CLOSED);
+
+	observer_suspends = 1;
+	result = fsm_resume(door, NULL);
+	failures += check("resume, observer suspends", door, result, FSM_RESULT_SUCCESS, 0, STATE_CLOSED);
+	result = fsm_process_event(door, EVENT_OPEN, NULL);
+	failures += check("observer suspends", door, result, FSM_RESULT_SUCCESS, 0, STATE_OPEN);
+	observer_suspends = 0;
+
+	result = fsm_process_event(door, EVENT_CLOSE, NULL);
+	failures += check("action suspends", door, result, FSM_RESULT_PENDING, 1, STATE_CLOSED);
+	result = fsm_resume(door, NULL);
+	failures += check("resume", door, result, FSM_RESULT_SUCCESS, 0, STATE_CLOSED);
+	return failures;
+}
+
+// The same sequence in one batch, where a request left by a guard would turn the later items into BUSY.
+static int run_batch(fsm_t* door) {
+	static const fsm_event_t  events[]   = {EVENT_KNOCK, EVENT_OPEN, EVENT_CLOSE, EVENT_KNOCK};
+	static const fsm_result_t expected[] = {
+		FSM_RESULT_GUARD_DENIED,
+		FSM_RESULT_SUCCESS,
+		FSM_RESULT_PENDING,
+		FSM_RESULT_BUSY,
+	};
+	fsm_t* const instances[] = {door, door, door, door};
+	fsm_result_t results[4];
+	int          failures = 0;
+
+	fsm_result_t result = fsm_process_events_batch(instances, events, NULL, results, 4);
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("Batch failed: %s\n", fsm_result_string(result));
+		return 1;
+	}
+	for (int i = 0; i < 4; i++) {
+		if (results[i] != expected[i]) {
+			printf("batch item %d: %s, expected %s\n", i, fsm_result_string(results[i]),
+				   fsm_result_string(expected[i]));
+			failures++;
+		}
+	}
+	failures += check("batch, then pending", door, FSM_RESULT_SUCCESS, FSM_RESULT_SUCCESS, 1, STATE_CLOSED);
+	result = fsm_resume(door, NULL);
+	failures += check("batch, resume", door, result, FSM_RESULT_SUCCESS, 0, STATE_CLOSED);
+	return failures;
+}
+
+int main(void) {
+	fsm_def_t def;
+	fsm_t     door;
+
+	fsm_result_t result = fsm_def_init(&def, transitions, TRANSITION_COUNT);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_observer(&def, notify, NULL);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&door, &def, STATE_CLOSED);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("FSM init failed: %s\n", fsm_result_string(result));
+		return -1;
+	}
+
+	int failures = run_events(&door) + run_batch(&door);
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? -1 : 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fsm.h"
+#include "fsm_trace.h"
+
+// Door states
+typedef enum {
+	STATE_CLOSED,
+	STATE_OPEN,
+	STATE_LOCKED,
+	STATE_COUNT,
+} state_t;
+
+// Door events
+typedef enum {
+	EVENT_OPEN,
+	EVENT_CLOSE,
+	EVENT_LOCK,
+	EVENT_UNLOCK,
+	EVENT_COUNT,
+} event_t;
+
+#define DOOR_COUNT     1024
+#define EVENT_STREAM   200000
+#define TRACE_CAPACITY 65536  // Power of two, the flight recorder keeps the newest records.
+
+static const fsm_transition_t transitions[] = {
+	{.event = EVENT_OPEN, .source_states_mask = FSM_STATE_MASK(STATE_CLOSED), .target_state = STATE_OPEN},
+	{.event = EVENT_CLOSE, .source_states_mask = FSM_STATE_MASK(STATE_OPEN), .target_state = STATE_CLOSED},
+	{.event = EVENT_LOCK, .source_states_mask = FSM_STATE_MASK(STATE_CLOSED), .target_state = STATE_LOCKED},
+	{.event = EVENT_UNLOCK, .source_states_mask = FSM_STATE_MASK(STATE_LOCKED), .target_state = STATE_CLOSED},
+};
+
+// Same machine with a regression: unlocking leaves the door open.
+static const fsm_transition_t regressed[] = {
+	{.event = EVENT_OPEN, .source_states_mask = FSM_STATE_MASK(STATE_CLOSED), .target_state = STATE_OPEN},
+	{.event = EVENT_CLOSE, .source_states_mask = FSM_STATE_MASK(STATE_OPEN), .target_state = STATE_CLOSED},
+	{.event = EVENT_LOCK, .source_states_mask = FSM_STATE_MASK(STATE_CLOSED), .target_state = STATE_LOCKED},
+	{.event = EVENT_UNLOCK, .source_states_mask = FSM_STATE_MASK(STATE_LOCKED), .target_state = STATE_OPEN},
+};
+
+static fsm_t              doors[DOOR_COUNT];
+static fsm_t              replayed[DOOR_COUNT];
+static fsm_trace_record_t ring_records[TRACE_CAPACITY];
+static fsm_trace_record_t dump[TRACE_CAPACITY];
+
+static void replay(const char* name, const fsm_transition_t* rules, size_t rule_count,
+				   const fsm_trace_record_t* records, size_t count) {
+	fsm_def_t                 def;
+	fsm_trace_replay_report_t report;
+	fsm_def_init(&def, rules, rule_count);
+	for (size_t i = 0; i < DOOR_COUNT; i++) {
+		replayed[i].def = NULL;  // Initialized from the first record of each door.
+	}
+	fsm_result_t result = fsm_trace_replay(&def, records, count, replayed, DOOR_COUNT, &report);
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("Replay failed: %s\n", fsm_result_string(result));
+		return;
+	}
+	printf("%-9s: %zu events, %zu mismatches, %zu skipped, %.3g events/sec\n", name, report.events,
+		   report.mismatches, report.skipped, report.events_per_sec);
+}
+
+int main(int argc, char** argv) {
+	const char* path = argc > 1 ? argv[1] : "door.trace";
+	if (!FSM_TRACE_ENABLED) {
+		printf("Tracing is compiled out, reconfigure with -DFSM_ENABLE_TRACE=ON to record events.\n");
+	}
+
+	fsm_def_t        def;
+	fsm_trace_ring_t ring;
+	fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(transitions[0]));
+	for (size_t i = 0; i < DOOR_COUNT; i++) {
+		fsm_init(&doors[i], &def, STATE_CLOSED);
+	}
+	fsm_trace_init(&ring, ring_records, TRACE_CAPACITY, doors, DOOR_COUNT);
+
+	// Record a random event stream; rejected events are traced too.
+	fsm_trace_attach(&ring);
+	srand(7);
+	for (size_t i = 0; i < EVENT_STREAM; i++) {
+		fsm_process_event(&doors[rand() % DOOR_COUNT], (fsm_event_t)(rand() % EVENT_COUNT), NULL);
+	}
+	fsm_trace_attach(NULL);
+
+	// Dump the retained records and load them back, as an offline tool would.
+	size_t count = fsm_trace_copy(&ring, dump, TRACE_CAPACITY);
+	FILE*  file  = fopen(path, "wb");
+	if (!file || fwrite(dump, sizeof(dump[0]), count, file) != count) {
+		printf("Cannot write %s\n", path);
+		return 1;
+	}
+	fclose(file);
+	printf("Recorded %zu events, dumped the newest %zu to %s\n", (size_t)EVENT_STREAM, count, path);
+
+	file = fopen(path, "rb");
+	if (!file) {
+		printf("Cannot read %s\n", path);
+		return 1;
+	}
+	count = fread(dump, sizeof(dump[0]), TRACE_CAPACITY, file);
+	fclose(file);
+
+	for (size_t i = 0; i < count && i < 4; i++) {
+		printf("  door %4u: %d -> %d on event %d (%s)\n", (unsigned)dump[i].instance, dump[i].from, dump[i].to,
+			   (int)FSM_TRACE_RECORD_EVENT(&dump[i]), fsm_result_string(FSM_TRACE_RECORD_RESULT(&dump[i])));
+	}
+	replay("original", transitions, sizeof(transitions) / sizeof(transitions[0]), dump, count);
+	replay("regressed", regressed, sizeof(regressed) / sizeof(regressed[0]), dump, count);
+	return 0;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include "fsm.h"
+#include "fsm_timer.h"
 
 // Traffic light states
 typedef enum {
@@ -128,9 +129,34 @@ int main(void) {
 		},
 	};
 
-	fsm_t        fsm;
-	fsm_result_t result;
-	result = fsm_init(&fsm, STATE_RED, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	// Each light times out on its own: entering the state arms the timer, leaving it cancels the timer
+	const fsm_state_desc_t states[STATE_COUNT] = {
+		[STATE_RED]    = {.timeout = (uint32_t)light_ctx.red_duration, .timeout_event = EVENT_TIMEOUT},
+		[STATE_GREEN]  = {.timeout = (uint32_t)light_ctx.green_duration, .timeout_event = EVENT_TIMEOUT},
+		[STATE_YELLOW] = {.timeout = (uint32_t)light_ctx.yellow_duration, .timeout_event = EVENT_TIMEOUT},
+	};
+
+	static uint16_t   dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	fsm_def_t         def;
+	fsm_t             fsm;
+	fsm_timer_node_t  timer_node;
+	fsm_timer_wheel_t wheel;
+	uint64_t          now = 0;  // Simulated clock, one tick per second
+	fsm_result_t      result;
+	result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_states(&def, states, STATE_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_init(&fsm, &def, STATE_RED);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_timer_init(&wheel, &def, &fsm, &timer_node, 1, now);
+	}
 	if (result != FSM_RESULT_SUCCESS) {
 		printf("FSM initialization failed: %s\n", fsm_result_string(result));
 		return -1;
@@ -140,7 +166,8 @@ int main(void) {
 	char cmd[20];
 	printf("-- Traffic Light Control --\n");
 	printf("Available commands:\n");
-	printf("  timeout  - Trigger timer timeout\n");
+	printf("  tick     - Advance the clock by 1 second\n");
+	printf("  wait     - Advance the clock by 10 seconds\n");
 	printf("  emergency - Trigger emergency mode\n");
 	printf("  reset    - Reset traffic light\n");
 	printf("  help     - Show this help\n");
@@ -160,15 +187,20 @@ int main(void) {
 			break;
 		}
 
-		if (strcmp(cmd, "timeout") == 0) {
-			result = fsm_process_event(&fsm, EVENT_TIMEOUT, NULL);
+		result = FSM_RESULT_SUCCESS;
+		if (strcmp(cmd, "tick") == 0 || strcmp(cmd, "wait") == 0) {
+			// Timeouts are delivered by the wheel as EVENT_TIMEOUT
+			now += strcmp(cmd, "tick") == 0 ? 1 : 10;
+			fsm_tick(&wheel, now);
+			printf("Clock: %llu s\n", (unsigned long long)now);
 		} else if (strcmp(cmd, "reset") == 0) {
 			result = fsm_process_event(&fsm, EVENT_RESET, NULL);
 		} else if (strcmp(cmd, "emergency") == 0) {
 			result = fsm_process_event(&fsm, EVENT_EMERGENCY, NULL);
 		} else if (strcmp(cmd, "help") == 0) {
 			printf("Available commands:\n");
-			printf("  timeout  - Trigger timer timeout\n");
+			printf("  tick     - Advance the clock by 1 second\n");
+			printf("  wait     - Advance the clock by 10 seconds\n");
 			printf("  emergency - Trigger emergency mode\n");
 			printf("  reset    - Reset traffic light\n");
 			printf("  help     - Show this help\n");
@@ -185,6 +217,7 @@ int main(void) {
 		}
 	}
 
+	fsm_timer_deinit(&wheel);
 	printf("Program exited.\n");
 	return 0;
 }
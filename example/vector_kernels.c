@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+
+#include "fsm.h"
+#include "fsm_vector.h"
+
+// Largest table dimensions checked, within the limits of both narrow and wide builds.
+#define MAX_STATES 32
+#define MAX_EVENTS 256
+#define MAX_RULES  (2 * MAX_EVENTS)
+#define MAX_LANES  1031
+#define STEP_COUNT 16
+
+// Table shapes, most of them not a multiple of the 16 byte lanes of SSE4.1 or the 8 gathers of AVX2.
+static const uint16_t shapes[][2] = {
+	{1, 1}, {3, 5}, {5, 16}, {13, 11}, {16, 16}, {17, 9}, {31, 200}, {32, 256},
+};
+
+// Lane counts, exercising the scalar tail after the last full vector.
+static const size_t lane_counts[] = {1, 7, 15, 17, 33, 1000, MAX_LANES};
+
+static const char* const kernel_names[FSM_KERNEL_COUNT] = {"scalar", "SSE4.1", "AVX2"};
+
+static unsigned next_random(unsigned* seed) {
+	*seed = *seed * 1103515245u + 12345u;
+	return *seed >> 16;
+}
+
+// Random callback-free rules, about half of the [state][event] slots end up with a transition.
+static size_t make_rules(fsm_transition_t* rules, uint16_t state_count, uint16_t event_count, unsigned* seed) {
+	size_t count = 0;
+	for (uint16_t event = 0; event < event_count; event++) {
+		for (int r = 0; r < 2; r++) {
+			fsm_transition_t rule = {0};
+			for (uint16_t state = 0; state < state_count; state++) {
+				if (next_random(seed) % 3 == 0) {
+#ifdef FSM_WIDE
+					rule.source_states_mask[state / 64] |= 1ULL << (state % 64);
+#else
+					rule.source_states_mask |= FSM_STATE_MASK(state);
+#endif
+				}
+			}
+			rule.target_state = (fsm_state_t)(next_random(seed) % state_count);
+			rule.event        = (fsm_event_t)event;
+			rules[count++]    = rule;
+		}
+	}
+	return count;
+}
+
+// Replays random event streams on one kernel and on one fsm_process_event() call per lane, and counts the
+// lanes whose states differ. Streams include events past event_count, start states include one past
+// state_count, both of which leave a lane unchanged.
+static size_t replay(const fsm_def_t* def, fsm_kernel_t kernel, size_t lanes, unsigned seed) {
+	static fsm_state_t states[MAX_LANES];
+	static fsm_event_t events[MAX_LANES];
+	static fsm_t       reference[MAX_LANES];
+	size_t             mismatches = 0;
+
+	for (size_t i = 0; i < lanes; i++) {
+		fsm_init(&reference[i], def, 0);
+		states[i]                  = (fsm_state_t)(next_random(&seed) % (def->state_count + 1u));
+		reference[i].current_state = states[i];
+	}
+	for (int step = 0; step < STEP_COUNT; step++) {
+		for (size_t i = 0; i < lanes; i++) {
+			events[i] = (fsm_event_t)(next_random(&seed) % (def->event_count + 2u));
+			fsm_process_event(&reference[i], events[i], NULL);
+		}
+		if (fsm_advance_states_kernel(def, kernel, states, events, lanes) != FSM_RESULT_SUCCESS) {
+			return lanes;
+		}
+		for (size_t i = 0; i < lanes; i++) {
+			mismatches += states[i] != reference[i].current_state;
+		}
+	}
+	return mismatches;
+}
+
+int main(void) {
+	static fsm_transition_t rules[MAX_RULES];
+	static uint16_t         index[FSM_INDEX_SIZE(MAX_STATES, MAX_EVENTS)];
+	static fsm_state_t      table[FSM_NEXT_TABLE_SIZE(MAX_STATES, MAX_EVENTS)];
+	unsigned                seed     = 7;
+	int                     failures = 0;
+
+	for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+		uint16_t     state_count = shapes[s][0];
+		uint16_t     event_count = shapes[s][1];
+		size_t       rule_count  = make_rules(rules, state_count, event_count, &seed);
+		fsm_def_t    def;
+		fsm_result_t result = fsm_def_init(&def, rules, rule_count);
+		if (result == FSM_RESULT_SUCCESS) {
+			result = fsm_def_compile(&def, index, sizeof(index) / sizeof(index[0]), state_count, event_count);
+		}
+		if (result == FSM_RESULT_SUCCESS) {
+			result = fsm_def_compile_next_table(&def, table, sizeof(table) / sizeof(table[0]));
+		}
+		if (result != FSM_RESULT_SUCCESS) {
+			printf("%ux%u: build failed: %s\n", state_count, event_count, fsm_result_string(result));
+			return -1;
+		}
+
+		printf("%ux%u:", state_count, event_count);
+		for (int k = 0; k < FSM_KERNEL_COUNT; k++) {
+			if (!fsm_kernel_usable(&def, (fsm_kernel_t)k)) {
+				printf(" %s skipped", kernel_names[k]);
+				continue;
+			}
+			size_t mismatches = 0;
+			for (size_t l = 0; l < sizeof(lane_counts) / sizeof(lane_counts[0]); l++) {
+				mismatches += replay(&def, (fsm_kernel_t)k, lane_counts[l], seed + (unsigned)l);
+			}
+			printf(" %s %s", kernel_names[k], mismatches ? "MISMATCH" : "ok");
+			failures += mismatches != 0;
+		}
+		printf("\n");
+	}
+	return failures ? -1 : 0;
+}
@@ -65,6 +65,8 @@ static void add_coin_action(struct fsm* fsm, void* data);
 static void start_dispense_action(struct fsm* fsm, void* data);
 static void return_change_action(struct fsm* fsm, void* data);
 static void refund_action(struct fsm* fsm, void* data);
+static void motor_on_action(struct fsm* fsm, void* data);
+static void motor_off_action(struct fsm* fsm, void* data);
 static void process_event_and_display_status(fsm_t* fsm, Event event, void* data);
 
 /**
@@ -87,7 +89,7 @@ static const fsm_transition_t transitions[] = {
 		.event              = EVENT_SELECT_ITEM,
 		.guard              = can_dispense_guard,  // Must pass guard check (stock/balance)
 		.on_entry           = start_dispense_action,
-		.on_exit            = NULL,                             // Use on_exit here
+		.on_exit            = NULL,
 		.source_states_mask = FSM_STATE_MASK(STATE_ACCEPTING),  // Can only select item in ACCEPTING state
 		.target_state       = STATE_DISPENSING,                 // Enter DISPENSING state after successful selection
 	},
@@ -103,14 +105,23 @@ static const fsm_transition_t transitions[] = {
 		.event              = EVENT_CANCEL,
 		.guard              = NULL,
 		.on_entry           = refund_action,
-		.on_exit            = NULL,                             // Use on_exit here
+		.on_exit            = NULL,
 		.source_states_mask = FSM_STATE_MASK(STATE_ACCEPTING),  // Can only cancel in ACCEPTING state
 		.target_state       = STATE_IDLE,                       // Return to IDLE state after cancellation
 	},
 };
 
+/**
+ * @brief Per-state actions for the vending machine
+ * @note Run on every transition into or out of a state, after the rule's on_entry and before its on_exit.
+ */
+static const fsm_state_desc_t states[STATE_COUNT] = {
+	[STATE_DISPENSING] = {.on_entry = motor_on_action, .on_exit = motor_off_action},
+};
+
 int main(void) {
-	fsm_t fsm;
+	fsm_def_t def;
+	fsm_t     fsm;
 
 	VendingMachineContext context = {
 		.current_balance  = 0,
@@ -124,8 +135,24 @@ int main(void) {
 		.message = "Welcome! Please insert coins.",
 	};
 
+	// Initialize the shared definition and compile a [state][event] dispatch index,
+	// so each event is resolved with a single lookup
+	static uint16_t dispatch_index[FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT)];
+	fsm_result_t    result = fsm_def_init(&def, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_compile(&def, dispatch_index, FSM_INDEX_SIZE(STATE_COUNT, EVENT_COUNT), STATE_COUNT,
+								 EVENT_COUNT);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_set_states(&def, states, STATE_COUNT);
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("ERROR: FSM definition failed: %s\n", fsm_result_string(result));
+		return 1;
+	}
+
 	// Initialize FSM
-	fsm_result_t result = fsm_init(&fsm, STATE_IDLE, transitions, sizeof(transitions) / sizeof(fsm_transition_t));
+	result = fsm_init(&fsm, &def, STATE_IDLE);
 	if (result != FSM_RESULT_SUCCESS) {
 		printf("ERROR: FSM initialization failed: %s\n", fsm_result_string(result));
 		return 1;
@@ -237,14 +264,22 @@ static void refund_action(struct fsm* fsm, void* data) {
 	printf("  Action: Transaction cancelled.\n");
 }
 
+static void motor_on_action(struct fsm* fsm, void* data) {
+	printf("  State: Dispenser motor on.\n");
+}
+
+static void motor_off_action(struct fsm* fsm, void* data) {
+	printf("  State: Dispenser motor off.\n");
+}
+
 static void process_event_and_display_status(fsm_t* fsm, Event event, void* data) {
 	VendingMachineContext* context   = (VendingMachineContext*)fsm_userdata(fsm);
-	uint8_t                old_state = fsm_current_state(fsm);
+	fsm_state_t            old_state = fsm_current_state(fsm);
 	context->message                 = NULL;  // Clear previous message before processing an event
 
 	printf("\n---> EVENT: %s\n", event_names[event]);  // Made it more prominent
 	fsm_result_t result    = fsm_process_event(fsm, event, data);
-	uint8_t      new_state = fsm_current_state(fsm);
+	fsm_state_t  new_state = fsm_current_state(fsm);
 
 	printf("     Result:  %s (%d)\n", fsm_result_string(result), result);
 	printf("     State:   %s -> %s\n", state_names[old_state], state_names[new_state]);
@@ -38,7 +38,14 @@ extern "C" {
 	F(0x02, NO_TRANSITION_FOR_STATE, "No transition for state") /* Current status and events are not defined. */ \
 	F(0x03, EVENT_OUT_OF_BOUNDS, "Event out of bounds")         /* Event ID is out of valid range. */            \
 	F(0x04, STATE_OUT_OF_BOUNDS, "State out of bounds") /* Internal FSM state is invalid (should not happen). */ \
-	F(0x05, INVALID_PARAMS, "Invalid parameters")       /* Invalid parameters provided to an FSM function. */
+	F(0x05, INVALID_PARAMS, "Invalid parameters")       /* Invalid parameters provided to an FSM function. */    \
+	F(0x06, QUEUE_FULL, "Queue full")                   /* Event queue has no free slot. */                      \
+	F(0x07, INVALID_HANDLE, "Invalid handle")           /* Handle is stale or was never issued. */               \
+	F(0x08, POOL_FULL, "Pool full")                     /* Instance pool has no free slot. */                    \
+	F(0x09, DEFINITION_MISMATCH, "Definition mismatch") /* Data was produced for another transition table. */    \
+	F(0x0A, IO_ERROR, "I/O error")                      /* A file operation failed. */                           \
+	F(0x0B, PENDING, "Transition pending")              /* An action suspended the transition. */                \
+	F(0x0C, BUSY, "Transition in progress")             /* Instance is waiting for fsm_resume(). */
 
 /**
  * @brief Result codes for FSM operations.
@@ -49,10 +56,64 @@ typedef enum {
 #undef F
 } fsm_result_t;
 
+// Number of result codes in FSM_RESULT_FOREACH.
+#define F(code, name, description) +1
+enum { FSM_RESULT_COUNT = 0 FSM_RESULT_FOREACH(F) };
+#undef F
+
 struct fsm;
 
+#ifdef FSM_WIDE
+// Maximum number of states supported by the FSM in wide mode, a multiple of 64 up to 256.
+#ifndef FSM_MAX_STATES
+#define FSM_MAX_STATES 256
+#endif
+// Maximum number of events supported by the FSM in wide mode, bounds the size of a dispatch index.
+#ifndef FSM_MAX_EVENTS
+#define FSM_MAX_EVENTS 4096
+#endif
+// Number of 64-bit words in a source states mask.
+#define FSM_MASK_WORDS (FSM_MAX_STATES / 64)
+#if FSM_MAX_STATES % 64 != 0 || FSM_MASK_WORDS < 1 || FSM_MASK_WORDS > 4
+#error "FSM_MAX_STATES must be a multiple of 64 between 64 and 256 in wide mode"
+#endif
+typedef uint16_t fsm_state_t;  ///< State enum value.
+typedef uint16_t fsm_event_t;  ///< Event ID.
+#else
 // Maximum number of states supported by the FSM.
 #define FSM_MAX_STATES 32
+// Maximum number of events supported by the FSM.
+#define FSM_MAX_EVENTS 256
+typedef uint8_t fsm_state_t;  ///< State enum value.
+typedef uint8_t fsm_event_t;  ///< Event ID.
+#endif
+
+// Assumed cache line size, used to keep data written by different threads apart.
+#define FSM_CACHE_LINE_SIZE 64
+
+// Marks a [state][event] slot of a dispatch index that has no matching rule.
+#define FSM_INDEX_NONE 0xFFFF
+
+// Marks a state without a parent in a hierarchy.
+#define FSM_STATE_NONE ((fsm_state_t)-1)
+
+/**
+ * @brief Number of entries a dispatch index needs for the given dimensions.
+ * @param state_count Number of states covered by the index.
+ * @param event_count Number of events covered by the index.
+ */
+#define FSM_INDEX_SIZE(state_count, event_count) ((size_t)(state_count) * (size_t)(event_count))
+
+// Trailing entries a next-state table reserves so vector kernels can load whole words past its last entry.
+#define FSM_NEXT_TABLE_PADDING 16
+
+/**
+ * @brief Number of entries a next-state table needs for the given dimensions.
+ * @param state_count Number of states covered by the table.
+ * @param event_count Number of events covered by the table.
+ */
+#define FSM_NEXT_TABLE_SIZE(state_count, event_count) \
+	(FSM_INDEX_SIZE(state_count, event_count) + FSM_NEXT_TABLE_PADDING)
 
 /**
  * @brief Action function executed during a state transition.
@@ -69,6 +130,15 @@ typedef void (*fsm_action_t)(struct fsm* fsm, void* data);
  */
 typedef int (*fsm_guard_t)(struct fsm* fsm, void* data);
 
+/**
+ * @brief Observer notified after each completed transition of an instance.
+ * @param context Context registered with the observer.
+ * @param fsm Pointer to the FSM instance that transitioned.
+ * @param from State left.
+ * @param to State entered.
+ */
+typedef void (*fsm_observer_t)(void* context, struct fsm* fsm, fsm_state_t from, fsm_state_t to);
+
 /**
  * @brief Defines a single transition rule in the FSM.
  * @note Specifies target state, guard, and action for an event from source states.
@@ -77,23 +147,123 @@ typedef struct fsm_transition {
 	fsm_guard_t  guard;               ///< Optional guard function (NULL if none).
 	fsm_action_t on_exit;             ///< Optional action executed when exiting the source state (NULL if none).
 	fsm_action_t on_entry;            ///< Optional action executed when entering the target state (NULL if none).
-	uint32_t     source_states_mask;  ///< Bitmask of source states.
-	uint8_t      target_state;        ///< Target state enum value.
-	uint8_t      event;               ///< The event that triggers this transition.
+#ifdef FSM_WIDE
+	uint64_t source_states_mask[FSM_MASK_WORDS];  ///< Multi-word bitmask of source states.
+#else
+	uint32_t source_states_mask;  ///< Bitmask of source states.
+#endif
+	fsm_state_t target_state;  ///< Target state enum value.
+	fsm_event_t event;         ///< The event that triggers this transition.
 } fsm_transition_t;
 
 /**
- * @brief FSM instance.
- * @note Holds the current state, transition table, and user-defined data.
+ * @brief Per-state actions.
+ * @note Entry and exit actions belong to the state rather than to a rule, so they run for every transition
+ * that enters or leaves the state, including self-transitions. Deferred events are inherited by child states.
  */
-typedef struct fsm {
-	void*                   userdata;          ///< Pointer to user-defined data.
-	fsm_action_t            cleanup;           ///< Pointer to the cleanup function.
+typedef struct fsm_state_desc {
+	fsm_action_t       on_entry;         ///< Optional action executed after entering the state (NULL if none).
+	fsm_action_t       on_exit;          ///< Optional action executed before leaving the state (NULL if none).
+	const fsm_event_t* deferred_events;  ///< Events kept for the next state change when unhandled, see fsm_queue.h.
+	uint32_t           timeout;          ///< Ticks from entry until timeout_event fires, see fsm_timer.h (0 if none).
+	fsm_event_t        timeout_event;    ///< Event delivered when the state times out.
+	uint16_t           deferred_count;   ///< Number of entries in deferred_events.
+} fsm_state_desc_t;
+
+/**
+ * @brief Precomputed exit/entry path between two states of a hierarchy.
+ * @note Refers to a run of state actions: exit_count exit actions from the source up to the least common
+ * ancestor, followed by entry_count entry actions from below it down to the target.
+ */
+typedef struct fsm_path {
+	uint32_t offset;       ///< Index of the first action in the path action list.
+	uint16_t exit_count;   ///< Number of exit actions.
+	uint16_t entry_count;  ///< Number of entry actions.
+} fsm_path_t;
+
+/**
+ * @brief Compiled FSM definition.
+ * @note Holds the transition table and its optional dispatch index. A definition is set up once and then
+ * shared read-only by any number of FSM instances, so it must outlive them and not be modified afterward.
+ */
+typedef struct fsm_def {
 	const fsm_transition_t* transition_rules;  ///< Pointer to the FSM transition rules list.
 	size_t                  transition_count;  ///< Number of rules in the transition_rules list.
-	uint8_t                 current_state;     ///< Current state of the FSM.
+	const uint16_t*         dispatch_index;    ///< Optional [state][event] rule index (NULL if not compiled).
+	const uint16_t*         chain_next;        ///< Optional [state][rule] fall-through chains (NULL if disabled).
+	const fsm_state_t*      next_table;        ///< Optional [state][event] next-state table for callback-free rules.
+	const fsm_state_desc_t* states;            ///< Optional per-state actions, state_count entries (NULL if none).
+	const fsm_state_t*      parents;           ///< Optional parent of each state (NULL if flat).
+	const fsm_path_t*       paths;             ///< Optional [source][target] exit/entry paths (NULL if flat).
+	const fsm_action_t*     path_actions;      ///< Actions referenced by paths.
+	fsm_observer_t          observer;          ///< Optional transition observer (NULL if none).
+	void*                   observer_context;  ///< Context passed to observer.
+	uint16_t                event_count;       ///< Number of events covered by dispatch_index.
+	uint16_t                state_count;       ///< Number of states covered by dispatch_index.
+} fsm_def_t;
+
+/**
+ * @brief FSM instance.
+ * @note Holds only per-instance data: the current state, user-defined data and a reference to the shared
+ * definition, so large populations can be packed into flat arrays.
+ */
+typedef struct fsm {
+	void*            userdata;       ///< Pointer to user-defined data.
+	const fsm_def_t* def;            ///< Shared definition driving this instance.
+	fsm_state_t      current_state;  ///< Current state of the FSM.
+	fsm_state_t      pending_from;   ///< Source state of a suspended transition.
+	uint16_t         pending_rule;   ///< Rule of a suspended transition.
+	uint16_t         pending_step;   ///< Step + 1 a suspended transition resumes at, 0 if none.
+#ifdef FSM_STATS
+	uint64_t entered_ns;  ///< Time the current state was entered, for dwell statistics.
+#endif
 } fsm_t;
 
+#ifdef FSM_WIDE
+// Bit of a state within one word of a multi-word mask.
+#define __FSM_MASK_BIT(word, state) (((state) / 64 == (word)) ? (1ULL << ((state) % 64)) : 0ULL)
+
+/**
+ * @brief Converts a state enum value to a multi-word mask initializer.
+ * @param state State enum value (0 to FSM_MAX_STATES - 1).
+ * @return Brace initializer for a source_states_mask holding only that state.
+ */
+#define FSM_STATE_MASK(state) __FSM_MASK_WORDS(__FSM_MASK_BIT, state)
+
+/**
+ * @brief Converts a list of up to 16 state enum values to a multi-word mask initializer.
+ * @param ... State enum values.
+ * @return Brace initializer for a source_states_mask holding the states.
+ */
+#define FSM_STATES_MASK(...) __FSM_MASK_WORDS(__FSM_STATES_WORD, __VA_ARGS__)
+#define __FSM_STATES_WORD(word, ...) \
+	__FSM_STATES_WORD_HELPER(word, __VA_ARGS__, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+#define __FSM_STATES_WORD_HELPER(w, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15, s16, ...)     \
+	(__FSM_MASK_BIT(w, s1) | ((s2) ? __FSM_MASK_BIT(w, s2) : 0) | ((s3) ? __FSM_MASK_BIT(w, s3) : 0) |               \
+	 ((s4) ? __FSM_MASK_BIT(w, s4) : 0) | ((s5) ? __FSM_MASK_BIT(w, s5) : 0) | ((s6) ? __FSM_MASK_BIT(w, s6) : 0) |   \
+	 ((s7) ? __FSM_MASK_BIT(w, s7) : 0) | ((s8) ? __FSM_MASK_BIT(w, s8) : 0) | ((s9) ? __FSM_MASK_BIT(w, s9) : 0) |   \
+	 ((s10) ? __FSM_MASK_BIT(w, s10) : 0) | ((s11) ? __FSM_MASK_BIT(w, s11) : 0) |                                   \
+	 ((s12) ? __FSM_MASK_BIT(w, s12) : 0) | ((s13) ? __FSM_MASK_BIT(w, s13) : 0) |                                   \
+	 ((s14) ? __FSM_MASK_BIT(w, s14) : 0) | ((s15) ? __FSM_MASK_BIT(w, s15) : 0) |                                   \
+	 ((s16) ? __FSM_MASK_BIT(w, s16) : 0))
+
+#if FSM_MASK_WORDS == 1
+#define __FSM_MASK_WORDS(F, ...) {F(0, __VA_ARGS__)}
+#elif FSM_MASK_WORDS == 2
+#define __FSM_MASK_WORDS(F, ...) {F(0, __VA_ARGS__), F(1, __VA_ARGS__)}
+#elif FSM_MASK_WORDS == 3
+#define __FSM_MASK_WORDS(F, ...) {F(0, __VA_ARGS__), F(1, __VA_ARGS__), F(2, __VA_ARGS__)}
+#else
+#define __FSM_MASK_WORDS(F, ...) {F(0, __VA_ARGS__), F(1, __VA_ARGS__), F(2, __VA_ARGS__), F(3, __VA_ARGS__)}
+#endif
+
+/**
+ * @brief Checks whether a state is set in a source_states_mask.
+ * @param state State enum value.
+ * @param mask Multi-word source_states_mask.
+ */
+#define FSM_STATE_IN_MASK(state, mask) ((((mask)[(state) / 64] >> ((state) % 64)) & 1ULL) != 0)
+#else
 /**
  * @brief Converts a state enum value to its corresponding bit in a mask.
  * @param state State enum value (0 to FSM_MAX_STATES - 1).
@@ -102,37 +272,250 @@ typedef struct fsm {
 #define FSM_STATE_MASK(state) (1UL << (state))
 
 /**
- * @brief Converts a list of state enum values to a mask.
+ * @brief Converts a list of up to 16 state enum values to a mask.
  * @param ... State enum values.
  * @return Bitmask representing the states.
  */
-#define FSM_STATES_MASK(...) __FSM_STATE_MASK_HELPER(__VA_ARGS__, 0, 0, 0, 0, 0, 0, 0)
-#define __FSM_STATE_MASK_HELPER(s1, s2, s3, s4, s5, s6, s7, s8, ...)                                       \
-	(FSM_STATE_MASK(s1) | ((s2) ? FSM_STATE_MASK(s2) : 0) | ((s3) ? FSM_STATE_MASK(s3) : 0) |              \
-	 ((s4) ? FSM_STATE_MASK(s4) : 0) | ((s5) ? FSM_STATE_MASK(s5) : 0) | ((s6) ? FSM_STATE_MASK(s6) : 0) | \
-	 ((s7) ? FSM_STATE_MASK(s7) : 0) | ((s8) ? FSM_STATE_MASK(s8) : 0))
+#define FSM_STATES_MASK(...) __FSM_STATE_MASK_HELPER(__VA_ARGS__, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+#define __FSM_STATE_MASK_HELPER(s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15, s16, ...)        \
+	(FSM_STATE_MASK(s1) | ((s2) ? FSM_STATE_MASK(s2) : 0) | ((s3) ? FSM_STATE_MASK(s3) : 0) |                      \
+	 ((s4) ? FSM_STATE_MASK(s4) : 0) | ((s5) ? FSM_STATE_MASK(s5) : 0) | ((s6) ? FSM_STATE_MASK(s6) : 0) |         \
+	 ((s7) ? FSM_STATE_MASK(s7) : 0) | ((s8) ? FSM_STATE_MASK(s8) : 0) | ((s9) ? FSM_STATE_MASK(s9) : 0) |         \
+	 ((s10) ? FSM_STATE_MASK(s10) : 0) | ((s11) ? FSM_STATE_MASK(s11) : 0) | ((s12) ? FSM_STATE_MASK(s12) : 0) |   \
+	 ((s13) ? FSM_STATE_MASK(s13) : 0) | ((s14) ? FSM_STATE_MASK(s14) : 0) | ((s15) ? FSM_STATE_MASK(s15) : 0) |   \
+	 ((s16) ? FSM_STATE_MASK(s16) : 0))
+
+/**
+ * @brief Checks whether a state is set in a source_states_mask.
+ * @param state State enum value.
+ * @param mask Source states bitmask.
+ */
+#define FSM_STATE_IN_MASK(state, mask) (((mask) & FSM_STATE_MASK(state)) != 0)
+#endif
+
+/**
+ * @brief Standalone source_states_mask, for functions that select instances by state.
+ * @note Initialize with FSM_STATE_MASK() or FSM_STATES_MASK() and pass its address.
+ */
+#ifdef FSM_WIDE
+typedef uint64_t fsm_states_mask_t[FSM_MASK_WORDS];
+#else
+typedef uint32_t fsm_states_mask_t;
+#endif
+
+/**
+ * @brief Initializes an FSM definition.
+ *
+ * @param def Pointer to the definition to initialize.
+ * @param transition_rules Pointer to the array of transition rules, must outlive the definition.
+ * @param transition_count Number of rules in the transition_rules array.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_def_init(fsm_def_t* def, const fsm_transition_t* transition_rules, size_t transition_count);
+
+/**
+ * @brief Compiles the transition rules into a dense [state][event] dispatch index.
+ * @note After compiling, fsm_process_event() resolves a rule with a single lookup instead of scanning
+ * the rule list. Each slot refers to the first matching rule, so first-match-wins is preserved.
+ * Events >= event_count are then reported as FSM_RESULT_EVENT_OUT_OF_BOUNDS.
+ * Compile the definition before initializing any instance with it.
+ *
+ * @param def Pointer to an initialized FSM definition.
+ * @param index Caller-provided storage for the index, must outlive the definition.
+ * @param index_size Number of entries in index, at least FSM_INDEX_SIZE(state_count, event_count).
+ * @param state_count Number of states (1 to FSM_MAX_STATES).
+ * @param event_count Number of events (1 to FSM_MAX_EVENTS).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS if a rule falls outside the given dimensions.
+ */
+fsm_result_t fsm_def_compile(fsm_def_t* def, uint16_t* index, size_t index_size, uint16_t state_count,
+							 uint16_t event_count);
+
+/**
+ * @brief Builds a flat [state][event] next-state table for a callback-free definition.
+ * @note Intended for pure classifiers: every rule must have no guard, on_entry or on_exit, and no state
+ * actions may be attached. The table stores the target of the first matching rule, or the state itself
+ * when no rule matches, and enables fsm_advance_states(). The definition must be compiled with
+ * fsm_def_compile() first.
+ *
+ * @param def Pointer to a compiled FSM definition.
+ * @param table Caller-provided storage for the table, must outlive the definition.
+ * @param table_size Number of entries in table, at least FSM_NEXT_TABLE_SIZE(state_count, event_count).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS if the definition is not compiled,
+ * the table is too small or a rule or state has callbacks.
+ */
+fsm_result_t fsm_def_compile_next_table(fsm_def_t* def, fsm_state_t* table, size_t table_size);
+
+/**
+ * @brief Number of entries the fall-through chains of a definition need.
+ * @param state_count Number of states covered by the chains.
+ * @param transition_count Number of rules of the definition.
+ */
+#define FSM_CHAIN_SIZE(state_count, transition_count) ((size_t)(state_count) * (size_t)(transition_count))
+
+/**
+ * @brief Lets a denied guard fall through to the next rule matching the same state and event.
+ * @note Opt-in. By default dispatch stops at the first matching rule and reports FSM_RESULT_GUARD_DENIED if its
+ * guard denies. With chains, the matching rules of a (state, event) pair are tried in table order until a guard
+ * passes or a rule without guard is reached, so alternatives are written as several guarded rules for one event.
+ * FSM_RESULT_GUARD_DENIED is reported only when every candidate denied. A state inheriting a rule through a
+ * hierarchy uses the chain of the ancestor the rule belongs to. fsm_def_reorder() puts the most likely rule of
+ * each chain first.
+ *
+ * @param def Pointer to a compiled FSM definition.
+ * @param chain Caller-provided storage for the chains, must outlive the definition.
+ * @param chain_size Number of entries in chain, at least FSM_CHAIN_SIZE(state_count, transition_count).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_def_set_fallthrough(fsm_def_t* def, uint16_t* chain, size_t chain_size);
+
+/**
+ * @brief Attaches per-state entry and exit actions to a compiled definition.
+ * @note A transition runs, in order: the exit action of the source state, the rule's on_exit, the state
+ * change, the rule's on_entry and the entry action of the target state. The table is indexed by state, so
+ * dispatch reads it without further indirection. Definitions with a next-state table cannot have state actions.
+ *
+ * @param def Pointer to a compiled FSM definition.
+ * @param states Caller-provided table indexed by state, must outlive the definition.
+ * @param state_count Number of entries in states, at least the compiled state count.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_def_set_states(fsm_def_t* def, const fsm_state_desc_t* states, size_t state_count);
+
+/**
+ * @brief Registers the transition observer of a definition.
+ * @note Intended for modules that track instances, such as the timer wheel. There is one observer per
+ * definition; a module that installs itself should keep the previous observer and forward to it.
+ *
+ * @param def Pointer to an initialized FSM definition.
+ * @param observer Function called after each transition, or NULL to remove.
+ * @param context Context passed to observer.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_def_set_observer(fsm_def_t* def, fsm_observer_t observer, void* context);
+
+/**
+ * @brief Computes a 64-bit fingerprint of the transition table of a definition.
+ * @note FNV-1a over the event, source states mask and target state of every rule, in order. Callbacks are not
+ * included, so the hash is stable across processes and builds; it identifies which states and events the
+ * table uses, for example to reject persisted states taken against another table.
+ *
+ * @param def Pointer to an initialized FSM definition.
+ * @return The fingerprint, or 0 if def is NULL.
+ */
+uint64_t fsm_def_hash(const fsm_def_t* def);
+
+/**
+ * @brief Number of entries the path table of a hierarchy needs.
+ * @param state_count Number of states covered by the table.
+ */
+#define FSM_PATH_TABLE_SIZE(state_count) ((size_t)(state_count) * (size_t)(state_count))
+
+/**
+ * @brief Nests states into a hierarchy and precomputes the exit/entry path between every pair of states.
+ * @note A state without a rule for an event inherits the rule of its nearest ancestor that has one, so rules
+ * shared by all children of a parent are written once on the parent. The dispatch index is updated in place.
+ * A transition exits from the current state up to the least common ancestor with the target and enters
+ * down to the target; when the target is the current state or one of its ancestors, the target itself is
+ * exited and re-entered. Only non-NULL state actions are stored, so dispatch walks a flat action list.
+ * Call after fsm_def_compile() and fsm_def_set_states() (if any), and before fsm_def_compile_next_table().
+ *
+ * @param def Pointer to a compiled FSM definition.
+ * @param parents Caller-provided parent of each state (FSM_STATE_NONE for top-level states), state_count
+ * entries, must outlive the definition.
+ * @param paths Caller-provided storage for the path table, must outlive the definition.
+ * @param path_count Number of entries in paths, at least FSM_PATH_TABLE_SIZE(state_count).
+ * @param actions Caller-provided storage for the path action list, must outlive the definition.
+ * @param action_count On input the number of entries in actions; on output the number needed.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters, cyclic parents
+ * or if actions is too small (action_count then holds the required size).
+ */
+fsm_result_t fsm_def_set_hierarchy(fsm_def_t* def, const fsm_state_t* parents, fsm_path_t* paths, size_t path_count,
+								   fsm_action_t* actions, size_t* action_count);
+
+/**
+ * @brief Advances many independent states of a callback-free definition by one event each.
+ * @note Computes states[i] = next(states[i], events[i]) with the table built by fsm_def_compile_next_table().
+ * States or events outside the compiled dimensions, and pairs without a rule, leave the state unchanged.
+ * An AVX2 or SSE4.1 kernel is selected at runtime when the CPU supports it, with a scalar fallback
+ * (wide mode always uses the scalar kernel).
+ *
+ * @param def Pointer to a definition with a next-state table.
+ * @param states Array of count states, updated in place.
+ * @param events Array of count event IDs.
+ * @param count Number of states to advance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_advance_states(const fsm_def_t* def, fsm_state_t* states, const fsm_event_t* events, size_t count);
 
 /**
  * @brief Initializes an FSM instance.
  *
  * @param self Pointer to the FSM instance to initialize.
+ * @param def Pointer to the shared definition, must outlive the instance.
  * @param initial_state The starting state for the FSM.
- * @param transition_rules Pointer to the array of transition rules.
- * @param num_transition_rules Number of rules in the transition_rules array.
  * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
  */
-fsm_result_t fsm_init(fsm_t* self, uint8_t initial_state, const fsm_transition_t* transition_rules,
-					  size_t num_transition_rules);
+fsm_result_t fsm_init(fsm_t* self, const fsm_def_t* def, fsm_state_t initial_state);
 
 /**
  * @brief Processes an event for the FSM.
+ * @note While a transition suspended by fsm_suspend() waits for fsm_resume(), the event is rejected with
+ * FSM_RESULT_BUSY.
  *
  * @param self Pointer to the FSM instance.
  * @param event The event ID to process.
  * @param data Optional data associated with the event, passed to guard and action functions.
  * @return fsm_result_t indicating the result of event processing.
  */
-fsm_result_t fsm_process_event(fsm_t* self, uint8_t event, void* data);
+fsm_result_t fsm_process_event(fsm_t* self, fsm_event_t event, void* data);
+
+/**
+ * @brief Processes a batch of (instance, event, data) tuples.
+ * @note Items are dispatched in array order with the same guard and action semantics as
+ * fsm_process_event(), so an instance may appear several times. Instance state and index slots
+ * are prefetched ahead of dispatch.
+ *
+ * @param instances Array of count FSM instances.
+ * @param events Array of count event IDs.
+ * @param data Optional array of count event data pointers (NULL passes NULL to every item).
+ * @param results Array receiving the fsm_result_t of each item.
+ * @param count Number of items in the batch.
+ * @return FSM_RESULT_SUCCESS if the batch was dispatched, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_process_events_batch(fsm_t* const* instances, const fsm_event_t* events, void* const* data,
+									  fsm_result_t* results, size_t count);
+
+/**
+ * @brief Suspends the transition that is running on an instance.
+ * @note Call from a guard-approved action, typically one that starts I/O: the transition stops right after
+ * the calling action returns, the dispatch reports FSM_RESULT_PENDING and further events are rejected with
+ * FSM_RESULT_BUSY until fsm_resume() runs the remaining actions. Suspending in an exit action or a rule's
+ * on_exit leaves the instance in the source state, later actions have already moved it to the target.
+ * Calls from guards and observers are ignored. Dispatch through generated code or fsmpp::machine::process
+ * does not support suspension.
+ *
+ * @param self Pointer to the FSM instance whose action is running.
+ */
+void fsm_suspend(fsm_t* self);
+
+/**
+ * @brief Resumes a transition suspended by fsm_suspend().
+ * @note Runs the actions left after the suspending one, then the observer. Any of them may suspend again.
+ *
+ * @param self Pointer to the FSM instance.
+ * @param data Data passed to the remaining actions, e.g. the completed I/O, in place of the event data.
+ * @return FSM_RESULT_SUCCESS once the transition completed, FSM_RESULT_PENDING if it was suspended again,
+ * FSM_RESULT_INVALID_PARAMS if no transition is pending.
+ */
+fsm_result_t fsm_resume(fsm_t* self, void* data);
+
+/**
+ * @brief Checks whether an instance waits in a suspended transition.
+ *
+ * @param self Pointer to the FSM instance.
+ * @return Non-zero between fsm_suspend() and the fsm_resume() that completes the transition, 0 otherwise.
+ */
+int fsm_is_pending(const fsm_t* self);
 
 /**
  * @brief Gets the current state of the FSM.
@@ -140,7 +523,16 @@ fsm_result_t fsm_process_event(fsm_t* self, uint8_t event, void* data);
  * @param self Pointer to the FSM instance.
  * @return The current state enum value.
  */
-uint8_t fsm_current_state(const fsm_t* self);
+fsm_state_t fsm_current_state(const fsm_t* self);
+
+/**
+ * @brief Checks whether the FSM is in a state or nested in it.
+ *
+ * @param self Pointer to the FSM instance.
+ * @param state State to test, usually a parent state.
+ * @return Non-zero if the current state is state or one of its descendants, 0 otherwise.
+ */
+int fsm_in_state(const fsm_t* self, fsm_state_t state);
 
 /**
  * @brief Gets the user-defined data from the FSM.
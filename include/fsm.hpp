@@ -0,0 +1,299 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_HPP
+#define FSM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fsm.h"
+
+#if __cplusplus < 201703L && (!defined(_MSVC_LANG) || _MSVC_LANG < 201703L)
+#error "fsm.hpp requires C++17 or later"
+#endif
+
+/**
+ * @brief Header-only C++17 front end for compile-time FSM definitions.
+ * @note A machine is described entirely in template arguments. Its table is validated by static_assert, its
+ * dispatch index is computed at compile time, and guards and actions are called directly so the compiler can
+ * inline them. The same machine also exports a regular fsm_def_t, so instances can be driven from C through
+ * fsm_process_event and from C++ through machine::process interchangeably.
+ */
+namespace fsmpp {
+
+/**
+ * @brief Set of source states of a rule.
+ * @tparam States State enum values.
+ */
+template <fsm_state_t... States>
+struct from {
+	static constexpr bool contains(std::size_t state) {
+		return ((state == States) || ... || false);
+	}
+	static constexpr bool below(std::size_t state_count) {
+		return ((States < state_count) && ... && true);
+	}
+	static constexpr bool empty = sizeof...(States) == 0;
+};
+
+/**
+ * @brief Transition rule.
+ * @tparam Event The event that triggers this transition.
+ * @tparam Sources Source states, a fsmpp::from<...> list.
+ * @tparam Target Target state enum value.
+ * @tparam Guard Optional guard function, int(fsm_t*, void*) returning 0 to allow (nullptr if none).
+ * @tparam OnEntry Optional action executed when entering the target state (nullptr if none).
+ * @tparam OnExit Optional action executed when exiting the source state (nullptr if none).
+ */
+template <fsm_event_t Event, typename Sources, fsm_state_t Target, auto Guard = nullptr, auto OnEntry = nullptr,
+		  auto OnExit = nullptr>
+struct rule {
+	using sources = Sources;
+
+	static constexpr fsm_event_t event    = Event;
+	static constexpr fsm_state_t target   = Target;
+	static constexpr auto        guard    = Guard;
+	static constexpr auto        on_entry = OnEntry;
+	static constexpr auto        on_exit  = OnExit;
+
+	static constexpr bool has_guard    = !std::is_same_v<decltype(Guard), std::nullptr_t>;
+	static constexpr bool has_on_entry = !std::is_same_v<decltype(OnEntry), std::nullptr_t>;
+	static constexpr bool has_on_exit  = !std::is_same_v<decltype(OnExit), std::nullptr_t>;
+};
+
+/**
+ * @brief Compile-time FSM definition.
+ * @tparam StateCount Number of states, ids 0 to StateCount - 1.
+ * @tparam EventCount Number of events, ids 0 to EventCount - 1.
+ * @tparam Initial Initial state enum value, the root of the reachability check.
+ * @tparam Rules Transition rules, fsmpp::rule<...> types in first-match-wins order.
+ */
+template <std::size_t StateCount, std::size_t EventCount, fsm_state_t Initial, typename... Rules>
+class machine {
+public:
+	static constexpr std::size_t state_count = StateCount;
+	static constexpr std::size_t event_count = EventCount;
+	static constexpr std::size_t rule_count  = sizeof...(Rules);
+
+private:
+	template <std::size_t I>
+	using rule_at = std::tuple_element_t<I, std::tuple<Rules...>>;
+
+	static constexpr bool targets_in_range() {
+		return ((Rules::target < StateCount) && ...);
+	}
+
+	static constexpr bool sources_in_range() {
+		return ((Rules::sources::below(StateCount) && !Rules::sources::empty) && ...);
+	}
+
+	static constexpr bool events_in_range() {
+		return ((Rules::event < EventCount) && ...);
+	}
+
+	// Two rules for the same event sharing a source state leave the later one dead for that state.
+	static constexpr bool masks_disjoint() {
+		constexpr fsm_event_t events[] = {Rules::event...};
+		using checker                  = bool (*)(std::size_t);
+		constexpr checker contains[]   = {&Rules::sources::contains...};
+		for (std::size_t a = 0; a < rule_count; a++) {
+			for (std::size_t b = a + 1; b < rule_count; b++) {
+				if (events[a] != events[b]) {
+					continue;
+				}
+				for (std::size_t state = 0; state < StateCount; state++) {
+					if (contains[a](state) && contains[b](state)) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	static constexpr bool all_reachable() {
+		constexpr fsm_state_t targets[] = {Rules::target...};
+		using checker                   = bool (*)(std::size_t);
+		constexpr checker contains[]    = {&Rules::sources::contains...};
+		bool              reached[StateCount] = {};
+		reached[Initial]                      = true;
+		for (bool grown = true; grown;) {
+			grown = false;
+			for (std::size_t i = 0; i < rule_count; i++) {
+				if (reached[targets[i]]) {
+					continue;
+				}
+				for (std::size_t state = 0; state < StateCount; state++) {
+					if (reached[state] && contains[i](state)) {
+						reached[targets[i]] = grown = true;
+						break;
+					}
+				}
+			}
+		}
+		for (std::size_t state = 0; state < StateCount; state++) {
+			if (!reached[state]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(rule_count > 0 && rule_count < FSM_INDEX_NONE, "rule count out of range");
+	static_assert(StateCount > 0 && StateCount <= FSM_MAX_STATES, "state count out of range");
+	static_assert(EventCount > 0 && EventCount <= FSM_MAX_EVENTS, "event count out of range");
+	static_assert(Initial < StateCount, "initial state out of range");
+	static_assert(targets_in_range(), "a rule targets a state outside [0, StateCount)");
+	static_assert(sources_in_range(), "a rule has no source states or one outside [0, StateCount)");
+	static_assert(events_in_range(), "a rule is triggered by an event outside [0, EventCount)");
+	static_assert(masks_disjoint(), "two rules for the same event overlap in source states");
+	static_assert(all_reachable(), "a state is unreachable from the initial state");
+
+	static constexpr std::array<uint16_t, StateCount * EventCount> make_index() {
+		constexpr fsm_event_t events[] = {Rules::event...};
+		using checker                  = bool (*)(std::size_t);
+		constexpr checker contains[]   = {&Rules::sources::contains...};
+		std::array<uint16_t, StateCount * EventCount> index{};
+		for (std::size_t i = 0; i < index.size(); i++) {
+			index[i] = FSM_INDEX_NONE;
+		}
+		for (std::size_t i = 0; i < rule_count; i++) {
+			for (std::size_t state = 0; state < StateCount; state++) {
+				uint16_t& slot = index[state * EventCount + events[i]];
+				if (slot == FSM_INDEX_NONE && contains[i](state)) {
+					slot = static_cast<uint16_t>(i);
+				}
+			}
+		}
+		return index;
+	}
+
+	template <typename Rule>
+	static constexpr fsm_transition_t make_transition() {
+		fsm_transition_t transition{};
+		if constexpr (Rule::has_guard) {
+			transition.guard = Rule::guard;
+		}
+		if constexpr (Rule::has_on_entry) {
+			transition.on_entry = Rule::on_entry;
+		}
+		if constexpr (Rule::has_on_exit) {
+			transition.on_exit = Rule::on_exit;
+		}
+		for (std::size_t state = 0; state < StateCount; state++) {
+			if (Rule::sources::contains(state)) {
+#ifdef FSM_WIDE
+				transition.source_states_mask[state / 64] |= 1ULL << (state % 64);
+#else
+				transition.source_states_mask |= 1U << state;
+#endif
+			}
+		}
+		transition.target_state = Rule::target;
+		transition.event        = Rule::event;
+		return transition;
+	}
+
+	template <std::size_t I>
+	static inline fsm_result_t fire(fsm_t& self, void* data) {
+		using r = rule_at<I>;
+		if constexpr (r::has_guard) {
+			if (r::guard(&self, data) != 0) {
+				return FSM_RESULT_GUARD_DENIED;
+			}
+		}
+		if constexpr (r::has_on_exit) {
+			r::on_exit(&self, data);
+		}
+		self.current_state = r::target;
+		if constexpr (r::has_on_entry) {
+			r::on_entry(&self, data);
+		}
+		return FSM_RESULT_SUCCESS;
+	}
+
+	template <std::size_t... I>
+	static inline fsm_result_t dispatch(fsm_t& self, uint16_t rule, void* data, std::index_sequence<I...>) {
+		fsm_result_t result = FSM_RESULT_NO_TRANSITION_FOR_STATE;
+		(void)((rule == I && (result = fire<I>(self, data), true)) || ...);
+		return result;
+	}
+
+public:
+	/// Compile-time [state][event] rule index, FSM_INDEX_NONE where no rule matches.
+	static constexpr std::array<uint16_t, StateCount * EventCount> index = make_index();
+
+	/// The rules as a C transition table, in the same order.
+	static constexpr std::array<fsm_transition_t, sizeof...(Rules)> table = {make_transition<Rules>()...};
+
+	/// Compiled C definition sharing the table and index, usable with the whole C API (no state actions).
+	static constexpr fsm_def_t def = {table.data(), table.size(), index.data(), nullptr, nullptr, nullptr, nullptr,
+									  nullptr, nullptr, nullptr, nullptr, static_cast<uint16_t>(EventCount),
+									  static_cast<uint16_t>(StateCount)};
+
+	/**
+	 * @brief Initializes an FSM instance bound to this machine.
+	 * @param self Instance to initialize.
+	 * @param initial_state Initial state, defaults to the Initial template argument.
+	 * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+	 */
+	static fsm_result_t init(fsm_t& self, fsm_state_t initial_state = Initial) {
+		return fsm_init(&self, &def, initial_state);
+	}
+
+	/**
+	 * @brief Processes an event with the generated dispatcher.
+	 * @note Behaves exactly like fsm_process_event on an instance bound to def, minus the FSM_STATS hooks.
+	 * def is a compile-time constant, so it never has state actions, a hierarchy or an observer. Actions may
+	 * not call fsm_suspend(), but an instance suspended by fsm_process_event() is rejected with FSM_RESULT_BUSY.
+	 * @param self Instance bound to this machine.
+	 * @param event The event to be processed.
+	 * @param data Optional data associated with the event.
+	 * @return Result code of the event processing.
+	 */
+	static fsm_result_t process(fsm_t& self, fsm_event_t event, void* data = nullptr) {
+		if (self.pending_step) {
+			return FSM_RESULT_BUSY;
+		}
+		if (event >= EventCount) {
+			return FSM_RESULT_EVENT_OUT_OF_BOUNDS;
+		}
+		if (self.current_state >= StateCount) {
+			return FSM_RESULT_STATE_OUT_OF_BOUNDS;
+		}
+		uint16_t rule = index[static_cast<std::size_t>(self.current_state) * EventCount + event];
+		if (rule == FSM_INDEX_NONE) {
+			return FSM_RESULT_NO_TRANSITION_FOR_STATE;
+		}
+		return dispatch(self, rule, data, std::index_sequence_for<Rules...>{});
+	}
+};
+
+}  // namespace fsmpp
+
+#endif  // FSM_HPP
@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_ANALYZE_H
+#define FSM_ANALYZE_H
+
+#include "fsm.h"
+#include "fsm_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Findings about a single transition rule.
+ */
+typedef enum {
+	FSM_RULE_SHADOWED           = 1 << 0,  ///< Never selected: every source state is claimed by an earlier rule.
+	FSM_RULE_PARTIALLY_SHADOWED = 1 << 1,  ///< Some source states are claimed by an earlier rule.
+	FSM_RULE_OUT_OF_RANGE       = 1 << 2,  ///< Source state, target or event beyond the definition's dimensions.
+	FSM_RULE_NO_SOURCE          = 1 << 3,  ///< Source state mask holds no valid state.
+} fsm_rule_flag_t;
+
+/**
+ * @brief Findings about a single state.
+ */
+typedef enum {
+	FSM_STATE_UNREACHABLE = 1 << 0,  ///< Not reachable from the initial state, assuming every guard can pass.
+	FSM_STATE_DEAD_END    = 1 << 1,  ///< No rule leads out of the state.
+} fsm_state_flag_t;
+
+/**
+ * @brief Result of a table analysis.
+ * @note A rule that is shadowed is also never counted as partially shadowed. Guards are ignored for shadowing
+ * since dispatch stops at the first matching rule whether or not its guard passes. With fall-through chains
+ * (fsm_def_set_fallthrough()), only a matching rule without guard shadows the rules after it.
+ */
+typedef struct fsm_analysis {
+	uint16_t state_count;                     ///< Number of states analyzed.
+	uint16_t event_count;                     ///< Number of events analyzed.
+	size_t   shadowed_rules;                  ///< Rules flagged FSM_RULE_SHADOWED or FSM_RULE_NO_SOURCE.
+	size_t   partially_shadowed_rules;        ///< Rules flagged FSM_RULE_PARTIALLY_SHADOWED.
+	size_t   out_of_range_rules;              ///< Rules flagged FSM_RULE_OUT_OF_RANGE.
+	size_t   unreachable_states;              ///< States flagged FSM_STATE_UNREACHABLE.
+	size_t   dead_end_states;                 ///< States flagged FSM_STATE_DEAD_END.
+	size_t   unhandled_events;                ///< Events no state has a rule for.
+	size_t   handled_pairs;                   ///< (state, event) pairs resolved to a rule.
+	uint8_t  state_flags[FSM_MAX_STATES];     ///< fsm_state_flag_t bits of each state.
+	uint16_t state_coverage[FSM_MAX_STATES];  ///< Number of events handled in each state.
+	uint16_t event_coverage[FSM_MAX_EVENTS];  ///< Number of states handling each event.
+} fsm_analysis_t;
+
+/**
+ * @brief Analyzes the transition table of a definition.
+ * @note Meant to run once after the definition is set up, e.g. in debug builds or from a CI check. A
+ * compiled definition is analyzed as dispatched, including rules inherited through a hierarchy, and its
+ * state_count and event_count bound the valid states and events. For a definition that is not compiled
+ * they are derived from the highest state and event the rules refer to, so nothing is out of range.
+ *
+ * @param def Pointer to an initialized definition.
+ * @param initial_state State reachability is computed from.
+ * @param analysis Receives the findings.
+ * @param rule_flags Optional array of transition_count entries receiving the fsm_rule_flag_t bits of each rule.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_def_analyze(const fsm_def_t* def, fsm_state_t initial_state, fsm_analysis_t* analysis,
+							 uint8_t* rule_flags);
+
+/**
+ * @brief Emits an equivalent rule set without shadowed rules or overlapping source states.
+ * @note Each emitted rule keeps only the source states it is actually selected for, so the rules of an event
+ * are disjoint and their order no longer matters; they are grouped by event, the rules covering the most
+ * states first. Rules that can never fire are dropped. Dispatching with the emitted table gives the same
+ * results as the original one. Rules inherited through a hierarchy stay on the parent state. With fall-through
+ * chains, rules only lose the states where they are never tried and keep their order.
+ *
+ * @param def Pointer to an initialized definition.
+ * @param rules Destination array.
+ * @param origins Optional array receiving the index of the original rule of each emitted rule.
+ * @param capacity Number of entries in rules (and origins).
+ * @param rule_count Receives the number of emitted rules, or the number needed when capacity is too small.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or too small storage.
+ */
+fsm_result_t fsm_def_optimize(const fsm_def_t* def, fsm_transition_t* rules, size_t* origins, size_t capacity,
+							  size_t* rule_count);
+
+/**
+ * @brief Emits the rule set of a fall-through definition with the most likely rule of each chain first.
+ * @note Rules are grouped by event. Within a group the guarded rules are sorted by the hits recorded in profile,
+ * most first, and rules without guard close the group; every rule keeps only the states where it is still
+ * tried. With mutually exclusive guards, the usual way of writing alternatives, a rule's hits do not depend on
+ * its position, so the emitted table dispatches like the original one while evaluating fewer guards. If several
+ * guards of a chain can pass for the same event, the reordered table may select another of them. Load the
+ * emitted table with fsm_def_set_fallthrough() as well, or print it for the build (see fsm_check -P).
+ *
+ * @param def Pointer to a definition with fall-through chains.
+ * @param profile Statistics set up for def with fsm_stats_init() and filled by a profiling run (FSM_STATS),
+ * possibly merged from several threads.
+ * @param rules Destination array.
+ * @param origins Array receiving the index of the original rule of each emitted rule.
+ * @param capacity Number of entries in rules and origins.
+ * @param rule_count Receives the number of emitted rules, or the number needed when capacity is too small.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or too small storage.
+ */
+fsm_result_t fsm_def_reorder(const fsm_def_t* def, const fsm_stats_t* profile, fsm_transition_t* rules,
+							 size_t* origins, size_t capacity, size_t* rule_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_ANALYZE_H
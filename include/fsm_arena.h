@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_ARENA_H
+#define FSM_ARENA_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Alignment of every payload allocated from an arena.
+#define FSM_ARENA_ALIGN 16
+
+/**
+ * @brief Header of an event payload allocated from an arena.
+ * @note Posted as the data of an event, the envelope moves into the consumer, which releases it after dispatch.
+ * The payload follows the header and is reached with fsm_envelope_payload().
+ */
+typedef struct fsm_envelope {
+	size_t*  live;  ///< Release counter of the arena block holding the envelope.
+	uint32_t type;  ///< Caller-defined payload type.
+	uint32_t size;  ///< Payload size in bytes.
+} fsm_envelope_t;
+
+/**
+ * @brief Bump allocator for event payloads, owned by one producer thread.
+ * @note The caller-provided buffer is split into blocks. fsm_arena_alloc() bumps a pointer through the current
+ * block and moves to the next block when it is full; a block is reused only once every envelope allocated from
+ * it has been released, so payloads are reclaimed a block at a time and no memory is freed per event.
+ * Envelopes may be released from any thread. Each release is a single atomic decrement of its block counter,
+ * and fsm_envelopes_release() combines the releases of consecutive envelopes of the same block.
+ */
+typedef struct fsm_arena {
+	char*    base;         ///< First block, aligned to a cache line.
+	size_t   block_size;   ///< Size of each block, counter included.
+	size_t   block_count;  ///< Number of blocks.
+	size_t   block;        ///< Index of the block being filled.
+	size_t   offset;       ///< Next free offset in the block being filled.
+	size_t   allocated;    ///< Envelopes allocated from the block being filled.
+	uint64_t exhausted;    ///< Allocations refused because the next block still held payloads.
+} fsm_arena_t;
+
+/**
+ * @brief Initializes an arena over a caller-provided buffer.
+ *
+ * @param arena Pointer to the arena to initialize.
+ * @param buffer Caller-provided storage, must outlive every envelope allocated from the arena.
+ * @param size Size of buffer in bytes.
+ * @param block_size Size of each block, a multiple of FSM_CACHE_LINE_SIZE larger than one cache line.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or if buffer does not
+ * hold a single block.
+ */
+fsm_result_t fsm_arena_init(fsm_arena_t* arena, void* buffer, size_t size, size_t block_size);
+
+/**
+ * @brief Allocates an envelope with room for a payload.
+ * @note Only the thread owning the arena may allocate.
+ *
+ * @param arena Pointer to the arena.
+ * @param type Caller-defined payload type, checked by fsm_envelope_payload().
+ * @param size Payload size in bytes.
+ * @return The envelope, or NULL if the payload does not fit in a block or the next block still holds
+ * unreleased payloads.
+ */
+fsm_envelope_t* fsm_arena_alloc(fsm_arena_t* arena, uint32_t type, size_t size);
+
+/**
+ * @brief Gets the payload of an envelope, for the producer filling it or the action reading it.
+ *
+ * @param data Event data holding an envelope, may be NULL.
+ * @param type Expected payload type.
+ * @return The payload, aligned to FSM_ARENA_ALIGN, or NULL if data is NULL or holds another type.
+ */
+void* fsm_envelope_payload(void* data, uint32_t type);
+
+/**
+ * @brief Releases an envelope. The payload must not be used afterwards.
+ * @param envelope Envelope to release, may be NULL.
+ */
+void fsm_envelope_release(fsm_envelope_t* envelope);
+
+/**
+ * @brief Releases the envelopes of a batch, one atomic operation per run of envelopes from the same block.
+ * @note Pass the data array given to fsm_process_events_batch() once the batch returns.
+ *
+ * @param envelopes Envelopes to release, NULL entries are skipped.
+ * @param count Number of entries.
+ */
+void fsm_envelopes_release(void* const* envelopes, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_ARENA_H
@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_CORO_HPP
+#define FSM_CORO_HPP
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "fsm.h"
+
+#if __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#error "fsm_coro.hpp requires C++20 or later"
+#endif
+
+/**
+ * @brief C++20 coroutine adapter for actions that wait on I/O.
+ * @note A coroutine action is written as `fsmpp::task name(fsm_t* self, void* data)` and put into a
+ * transition table as `fsmpp::async_action<name>`. It runs synchronously up to its first co_await that
+ * actually suspends; at that point the transition is suspended with fsm_suspend(), and when the coroutine
+ * finishes, the transition continues with fsm_resume(). The dispatching thread never blocks, so a single
+ * thread can keep thousands of instances in flight, each waiting on its own I/O. Everything runs on the thread
+ * owning the instances: coroutines must be resumed there.
+ */
+namespace fsmpp {
+
+/**
+ * @brief Return type of a coroutine action.
+ * @note Owns the coroutine frame until fsmpp::async_action hands it over to the suspended transition.
+ */
+class task {
+public:
+	struct promise_type;
+	using handle_type = std::coroutine_handle<promise_type>;
+
+	/// Destroys a finished frame and resumes the transition if async_action detached the coroutine.
+	struct final_awaiter {
+		bool await_ready() const noexcept {
+			return false;
+		}
+		void await_suspend(handle_type handle) noexcept {
+			promise_type& promise = handle.promise();
+			promise.finished      = true;
+			if (promise.detached) {
+				fsm_t* self = promise.self;
+				void*  data = promise.data;
+				handle.destroy();
+				fsm_resume(self, data);
+			}
+		}
+		void await_resume() const noexcept {}
+	};
+
+	struct promise_type {
+		fsm_t* self;              ///< Instance whose transition runs the coroutine.
+		void*  data;              ///< Event data, passed again to the actions after the coroutine.
+		bool   finished = false;  ///< Set when the body has run to completion.
+		bool   detached = false;  ///< Set when the transition was suspended on the coroutine.
+
+		promise_type(fsm_t* self, void* data) : self(self), data(data) {}
+
+		task get_return_object() noexcept {
+			return task(handle_type::from_promise(*this));
+		}
+		std::suspend_never initial_suspend() const noexcept {
+			return {};
+		}
+		final_awaiter final_suspend() const noexcept {
+			return {};
+		}
+		void return_void() const noexcept {}
+		void unhandled_exception() const noexcept {
+			std::terminate();
+		}
+	};
+
+	task(task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+	task(const task&)            = delete;
+	task& operator=(const task&) = delete;
+	task& operator=(task&&)      = delete;
+	~task() {
+		if (handle_) {
+			handle_.destroy();
+		}
+	}
+
+	/// Gives up ownership of the coroutine frame.
+	handle_type release() noexcept {
+		return std::exchange(handle_, nullptr);
+	}
+
+private:
+	explicit task(handle_type handle) noexcept : handle_(handle) {}
+
+	handle_type handle_;
+};
+
+/**
+ * @brief Adapts a coroutine action to a regular fsm_action_t.
+ * @note If the coroutine completes without suspending, the transition goes on as with a plain action.
+ * Otherwise the transition is suspended and the dispatch reports FSM_RESULT_PENDING; when the coroutine
+ * finishes, the remaining actions run from there with the original event data, which must stay valid until
+ * then.
+ * @tparam Action Coroutine function, task(fsm_t*, void*).
+ */
+template <task (*Action)(fsm_t*, void*)>
+void async_action(fsm_t* self, void* data) {
+	task::handle_type handle = Action(self, data).release();
+	if (handle.promise().finished) {
+		handle.destroy();
+	} else {
+		handle.promise().detached = true;
+		fsm_suspend(self);
+	}
+}
+
+/**
+ * @brief Single-shot completion a coroutine action can co_await.
+ * @note Typically owned by the instance's userdata and completed from the I/O callback. Awaiting a completed
+ * one does not suspend.
+ */
+class completion {
+public:
+	bool await_ready() const noexcept {
+		return done_;
+	}
+	void await_suspend(std::coroutine_handle<> waiter) noexcept {
+		waiter_ = waiter;
+	}
+	void await_resume() const noexcept {}
+
+	/// Marks the completion done and resumes the waiting coroutine, if any, on the calling thread.
+	void complete() {
+		done_ = true;
+		if (std::coroutine_handle<> waiter = std::exchange(waiter_, nullptr)) {
+			waiter.resume();
+		}
+	}
+
+	/// Rearms the completion for another wait.
+	void reset() noexcept {
+		done_ = false;
+	}
+
+	bool done() const noexcept {
+		return done_;
+	}
+
+private:
+	std::coroutine_handle<> waiter_ = nullptr;
+	bool                    done_   = false;
+};
+
+}  // namespace fsmpp
+
+#endif  // FSM_CORO_HPP
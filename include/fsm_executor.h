@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_EXECUTOR_H
+#define FSM_EXECUTOR_H
+
+#include "fsm.h"
+#include "fsm_arena.h"
+#include "fsm_version.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of log2 buckets in the executor latency histogram (bucket i counts latencies below 2^i ns).
+#define FSM_EXECUTOR_LATENCY_BUCKETS 40
+
+/**
+ * @brief Executor configuration.
+ */
+typedef struct fsm_executor_config {
+	size_t          thread_count;    ///< Number of worker threads (at least 1).
+	size_t          shard_count;     ///< Number of shards, 0 selects four shards per thread.
+	size_t          queue_capacity;  ///< Per-shard event queue capacity, a power of two (0 selects 1024).
+	fsm_versions_t* versions;        ///< Optional version set the instances are attached to (NULL if fixed).
+} fsm_executor_config_t;
+
+/**
+ * @brief Throughput and latency counters of an executor.
+ * @note Latency is measured from fsm_executor_post() to the end of fsm_process_event().
+ */
+typedef struct fsm_executor_stats {
+	uint64_t events_posted;     ///< Events accepted by fsm_executor_post().
+	uint64_t events_rejected;   ///< Events rejected because the shard queue was full.
+	uint64_t events_processed;  ///< Events dispatched to their instance.
+	uint64_t steals;            ///< Shard runs performed by a worker other than the shard's home worker.
+	uint64_t elapsed_ns;        ///< Time since the executor was created.
+	uint64_t latency_total_ns;  ///< Sum of event latencies.
+	uint64_t latency_max_ns;    ///< Largest observed event latency.
+	uint64_t latency_histogram[FSM_EXECUTOR_LATENCY_BUCKETS];  ///< Log2-bucketed event latencies.
+} fsm_executor_stats_t;
+
+/**
+ * @brief Multi-threaded executor for a population of FSM instances.
+ * @note Instances are partitioned into shards by instance id. Each shard has a lock-free event queue
+ * and is drained by one worker at a time, so events of an instance are processed in posting order.
+ * Idle workers steal whole shards from busy ones. With a version set in the configuration, events are
+ * dispatched with fsm_versions_process(), worker i uses reader slot i and reports a quiescent state after
+ * every shard run, so new versions can be published from another thread while the executor runs.
+ */
+typedef struct fsm_executor fsm_executor_t;
+
+/**
+ * @brief Creates an executor and starts its worker threads.
+ *
+ * @param out Receives the executor.
+ * @param instances Initialized FSM instances; the executor has exclusive use of them until destroyed.
+ * @param instance_count Number of instances, used as the range of instance ids.
+ * @param config Executor configuration, versions needs at least thread_count reader slots.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or if resources
+ * could not be allocated.
+ */
+fsm_result_t fsm_executor_create(fsm_executor_t** out, fsm_t* instances, size_t instance_count,
+								 const fsm_executor_config_t* config);
+
+/**
+ * @brief Posts an event to an instance. Safe to call from any thread, including worker threads.
+ *
+ * @param self Pointer to the executor.
+ * @param instance_id Index of the instance in the array given at creation.
+ * @param event The event ID to post.
+ * @param data Optional data delivered with the event, must stay valid until it is processed.
+ * @return FSM_RESULT_SUCCESS if queued, FSM_RESULT_QUEUE_FULL if the shard queue is full,
+ * FSM_RESULT_INVALID_PARAMS if instance_id is out of range.
+ */
+fsm_result_t fsm_executor_post(fsm_executor_t* self, size_t instance_id, fsm_event_t event, void* data);
+
+/**
+ * @brief Posts an event whose payload moves into the executor, which releases it after dispatch.
+ * @note Same guarantees as fsm_executor_post(). Give each posting thread its own fsm_arena_t; the workers
+ * release the envelopes as soon as the dispatch returns, so actions that suspend the transition (see
+ * fsm_suspend()) must copy what they need from the payload first.
+ *
+ * @param self Pointer to the executor.
+ * @param instance_id Index of the instance in the array given at creation.
+ * @param event The event ID to post.
+ * @param envelope Envelope from fsm_arena_alloc(), owned by the executor once posted.
+ * @return FSM_RESULT_SUCCESS if queued, FSM_RESULT_QUEUE_FULL if the shard queue is full,
+ * FSM_RESULT_INVALID_PARAMS if instance_id is out of range; on failure the caller keeps the envelope.
+ */
+fsm_result_t fsm_executor_post_envelope(fsm_executor_t* self, size_t instance_id, fsm_event_t event,
+										fsm_envelope_t* envelope);
+
+/**
+ * @brief Waits until every posted event has been processed.
+ * @param self Pointer to the executor.
+ */
+void fsm_executor_wait_idle(fsm_executor_t* self);
+
+/**
+ * @brief Reads the executor counters.
+ * @param self Pointer to the executor.
+ * @param stats Receives the counters.
+ */
+void fsm_executor_stats(const fsm_executor_t* self, fsm_executor_stats_t* stats);
+
+/**
+ * @brief Processes the remaining events, stops the worker threads and frees the executor.
+ * @param self Pointer to the executor.
+ */
+void fsm_executor_destroy(fsm_executor_t* self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_EXECUTOR_H
@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_MEMBERS_H
+#define FSM_MEMBERS_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks an empty list link.
+#define FSM_MEMBERS_NONE 0xFFFFFFFFu
+
+/**
+ * @brief Membership of one instance, linked into the list of its state.
+ */
+typedef struct fsm_member_node {
+	uint32_t    next;   ///< Next instance in the same state, FSM_MEMBERS_NONE at the end.
+	uint32_t    prev;   ///< Previous instance in the same state, FSM_MEMBERS_NONE at the head.
+	uint32_t    epoch;  ///< Last broadcast that reached the instance.
+	fsm_state_t state;  ///< State whose list holds the instance, FSM_STATE_NONE if not indexed.
+} fsm_member_node_t;
+
+/**
+ * @brief Per-state membership index of a population.
+ * @note Instances live in one caller-provided array and share a definition; the index keeps one intrusive
+ * list node per instance, indexed like the array. It observes the definition, so every completed transition
+ * moves the instance to the list of its new state in O(1). Counting or visiting the instances of a state then
+ * costs O(members) instead of O(population). Not thread-safe: query and dispatch from the same thread.
+ */
+typedef struct fsm_members {
+	fsm_def_t*         def;                    ///< Observed definition.
+	fsm_t*             instances;              ///< Caller-provided instances.
+	fsm_member_node_t* nodes;                  ///< Caller-provided nodes, one per instance.
+	size_t             count;                  ///< Number of instances.
+	uint32_t           epoch;                  ///< Number of the running or last broadcast.
+	fsm_observer_t     next_observer;          ///< Observer installed before the index.
+	void*              next_context;           ///< Context of next_observer.
+	uint32_t           heads[FSM_MAX_STATES];  ///< First instance of each state.
+	uint32_t           sizes[FSM_MAX_STATES];  ///< Number of instances in each state.
+} fsm_members_t;
+
+/**
+ * @brief Initializes a membership index over a population and files every instance under its current state.
+ * @note Instances must already be initialized with def; entries with a NULL def, such as free slots of an
+ * fsm_pool_t, are skipped until added with fsm_members_add(). The index registers itself as the observer of
+ * def, keeping the previous observer in the chain. A suspended transition (see fsm_suspend()) moves the
+ * instance once it completes.
+ *
+ * @param members Pointer to the index.
+ * @param def Definition shared by all instances.
+ * @param instances Array of count initialized instances, must outlive the index.
+ * @param nodes Caller-provided array of count nodes, must outlive the index.
+ * @param count Number of instances (below FSM_MEMBERS_NONE).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_members_init(fsm_members_t* members, fsm_def_t* def, fsm_t* instances, fsm_member_node_t* nodes,
+							  size_t count);
+
+/**
+ * @brief Detaches the index from its definition, restoring the previous observer.
+ * @note Observers chain in installation order, so modules sharing a definition (timer wheels, membership
+ * indexes) must be detached in reverse order of initialization.
+ *
+ * @param members Pointer to the index.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS if an observer installed after the index
+ * is still attached, in which case the index stays attached.
+ */
+fsm_result_t fsm_members_deinit(fsm_members_t* members);
+
+/**
+ * @brief Files an instance under its current state, e.g. after fsm_pool_create(). O(1).
+ *
+ * @param members Pointer to the index.
+ * @param id Index of an instance initialized with the index's definition and not indexed yet.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_members_add(fsm_members_t* members, size_t id);
+
+/**
+ * @brief Removes an instance from the index, e.g. before fsm_pool_destroy(). O(1).
+ *
+ * @param members Pointer to the index.
+ * @param id Index of an indexed instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_members_remove(fsm_members_t* members, size_t id);
+
+/**
+ * @brief Gets the number of indexed instances in a state. O(1).
+ *
+ * @param members Pointer to the index.
+ * @param state State to count, nested states are counted separately.
+ * @return Number of instances whose current state is state.
+ */
+size_t fsm_members_count(const fsm_members_t* members, fsm_state_t state);
+
+/**
+ * @brief Gets the first instance of a state.
+ * @note Visit a state with `for (id = fsm_members_first(m, s); id != FSM_MEMBERS_NONE; id = fsm_members_next(m,
+ * id))`, in no particular order. The list must not change during the walk; use fsm_broadcast() to dispatch.
+ *
+ * @param members Pointer to the index.
+ * @param state State to visit.
+ * @return Index of an instance in state, FSM_MEMBERS_NONE if there is none.
+ */
+uint32_t fsm_members_first(const fsm_members_t* members, fsm_state_t state);
+
+/**
+ * @brief Gets the next instance in the same state.
+ *
+ * @param members Pointer to the index.
+ * @param id Index of an indexed instance.
+ * @return Index of the next instance, FSM_MEMBERS_NONE at the end.
+ */
+uint32_t fsm_members_next(const fsm_members_t* members, uint32_t id);
+
+/**
+ * @brief Delivers one event to every indexed instance whose current state is in a mask.
+ * @note Each instance is dispatched with fsm_process_event() exactly once, even if its transition takes it
+ * to another state of the mask. Costs O(members of the masked states). Guards and actions must not dispatch
+ * events to other instances of the population while the broadcast runs.
+ *
+ * @param members Pointer to the index.
+ * @param mask States to deliver to, built with FSM_STATE_MASK() or FSM_STATES_MASK().
+ * @param event Event to deliver.
+ * @param data Optional data passed to every dispatch.
+ * @return Number of instances whose transition ran (FSM_RESULT_SUCCESS or FSM_RESULT_PENDING).
+ */
+size_t fsm_broadcast(fsm_members_t* members, const fsm_states_mask_t* mask, fsm_event_t event, void* data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_MEMBERS_H
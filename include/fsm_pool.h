@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_POOL_H
+#define FSM_POOL_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bits of a handle holding the slot index.
+#define FSM_HANDLE_INDEX_BITS 22
+// Bits of a handle holding the slot generation.
+#define FSM_HANDLE_GENERATION_BITS 10
+// Maximum number of instances in a pool.
+#define FSM_POOL_MAX_CAPACITY (1u << FSM_HANDLE_INDEX_BITS)
+// Never issued by a pool, generations start at 1.
+#define FSM_HANDLE_NONE 0u
+
+/**
+ * @brief Generational handle to a pooled FSM instance.
+ * @note Low FSM_HANDLE_INDEX_BITS bits select the slot, the rest is the generation of the slot when the handle
+ * was issued. Destroying an instance bumps the generation, so every older handle to the slot goes stale.
+ */
+typedef uint32_t fsm_handle_t;
+
+/**
+ * @brief Bookkeeping of one pool slot.
+ */
+typedef struct fsm_pool_slot {
+	uint32_t link;        ///< Dense position while live, next free slot while free.
+	uint16_t generation;  ///< Current generation, 1 to 2^FSM_HANDLE_GENERATION_BITS - 1.
+	uint16_t live;        ///< Non-zero while the slot holds an instance.
+} fsm_pool_slot_t;
+
+/**
+ * @brief Fixed-capacity pool of FSM instances.
+ * @note All storage is caller-provided, so create and destroy are O(1) and never call an allocator.
+ * Instances never move: instances[handle index] stays valid for the life of the instance, which lets other
+ * modules such as fsm_timer.h use the instance array directly. A dense array of live slots supports bulk
+ * iteration. Not thread-safe.
+ */
+typedef struct fsm_pool {
+	fsm_t*           instances;  ///< Caller-provided instances, capacity entries.
+	fsm_pool_slot_t* slots;      ///< Caller-provided slot bookkeeping, capacity entries.
+	uint32_t*        dense;      ///< Caller-provided live slot list, capacity entries.
+	size_t           capacity;   ///< Number of slots.
+	size_t           count;      ///< Number of live instances.
+	uint32_t         free_head;  ///< First free slot, capacity when full.
+} fsm_pool_t;
+
+/**
+ * @brief Initializes an empty pool.
+ *
+ * @param pool Pointer to the pool.
+ * @param instances Caller-provided instance storage, capacity entries.
+ * @param slots Caller-provided slot storage, capacity entries.
+ * @param dense Caller-provided dense list storage, capacity entries.
+ * @param capacity Number of slots (1 to FSM_POOL_MAX_CAPACITY).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_pool_init(fsm_pool_t* pool, fsm_t* instances, fsm_pool_slot_t* slots, uint32_t* dense,
+						   size_t capacity);
+
+/**
+ * @brief Creates an instance in a free slot. O(1).
+ *
+ * @param pool Pointer to the pool.
+ * @param def Shared definition of the instance.
+ * @param initial_state The starting state.
+ * @param out_handle Receives the handle of the new instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_POOL_FULL if no slot is free,
+ * FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_pool_create(fsm_pool_t* pool, const fsm_def_t* def, fsm_state_t initial_state,
+							 fsm_handle_t* out_handle);
+
+/**
+ * @brief Destroys an instance and invalidates its handles. O(1).
+ *
+ * @param pool Pointer to the pool.
+ * @param handle Handle of the instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_HANDLE if the handle is stale.
+ */
+fsm_result_t fsm_pool_destroy(fsm_pool_t* pool, fsm_handle_t handle);
+
+/**
+ * @brief Resolves a handle.
+ *
+ * @param pool Pointer to the pool.
+ * @param handle Handle of the instance.
+ * @return Pointer to the instance, or NULL if the handle is stale.
+ */
+fsm_t* fsm_pool_get(const fsm_pool_t* pool, fsm_handle_t handle);
+
+/**
+ * @brief Processes an event on a pooled instance.
+ *
+ * @param pool Pointer to the pool.
+ * @param handle Handle of the instance.
+ * @param event The event to be processed.
+ * @param data Optional data associated with the event.
+ * @return Result of fsm_process_event(), or FSM_RESULT_INVALID_HANDLE if the handle is stale.
+ */
+fsm_result_t fsm_pool_process_event(fsm_pool_t* pool, fsm_handle_t handle, fsm_event_t event, void* data);
+
+/**
+ * @brief Processes a batch of events on pooled instances.
+ * @note Items are dispatched in order with the semantics of fsm_pool_process_event(). Each handle is checked
+ * right before its item is dispatched, so actions may create and destroy pooled instances: items whose handle
+ * is stale by then get FSM_RESULT_INVALID_HANDLE and do not stop the batch.
+ *
+ * @param pool Pointer to the pool.
+ * @param handles Array of count handles.
+ * @param events Array of count event IDs.
+ * @param data Optional array of count event data pointers (NULL passes NULL to every item).
+ * @param results Array receiving the fsm_result_t of each item.
+ * @param count Number of items in the batch.
+ * @return FSM_RESULT_SUCCESS if the batch was dispatched, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_pool_process_events_batch(fsm_pool_t* pool, const fsm_handle_t* handles, const fsm_event_t* events,
+										   void* const* data, fsm_result_t* results, size_t count);
+
+/**
+ * @brief Gets the live instance at a dense position, for bulk iteration over 0 to pool->count - 1.
+ * @note Destroying an instance moves the last dense entry into its position.
+ *
+ * @param pool Pointer to the pool.
+ * @param position Dense position, below pool->count.
+ * @param out_handle Optional, receives the handle of the instance.
+ * @return Pointer to the instance, or NULL if position is out of range.
+ */
+fsm_t* fsm_pool_at(const fsm_pool_t* pool, size_t position, fsm_handle_t* out_handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_POOL_H
@@ -0,0 +1,188 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_QUEUE_H
+#define FSM_QUEUE_H
+
+#include "fsm.h"
+#include "fsm_arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Slot of an FSM event queue.
+ * @note Storage for slots is provided by the caller; the fields are managed by the queue.
+ */
+typedef struct fsm_queue_slot {
+	size_t      sequence;  ///< Slot sequence number, tells producers and the consumer whose turn it is.
+	void*       data;      ///< Data posted with the event.
+	fsm_event_t event;     ///< Posted event ID.
+	uint8_t     owned;     ///< Non-zero if data is an envelope released by the queue after dispatch.
+} fsm_queue_slot_t;
+
+/**
+ * @brief Bounded lock-free multi-producer single-consumer event queue attached to an FSM.
+ * @note Any thread may post events with fsm_post_event(). Only the thread owning the FSM may call
+ * fsm_drain(), which processes queued events one at a time, each running to completion before the next.
+ * An optional urgent lane (fsm_queue_set_urgent()) is drained before the normal one, and an optional
+ * deferred ring (fsm_queue_set_deferred()) parks events the current state declares as deferred until the
+ * next transition.
+ */
+typedef struct fsm_queue {
+	fsm_t*            fsm;               ///< FSM instance the events are delivered to.
+	fsm_queue_slot_t* slots;             ///< Caller-provided slot storage.
+	size_t            mask;              ///< Capacity - 1, capacity is a power of two.
+	fsm_queue_slot_t* urgent_slots;      ///< Optional slot storage of the urgent lane (NULL if none).
+	size_t            urgent_mask;       ///< Urgent lane capacity - 1.
+	fsm_queue_slot_t* deferred;          ///< Optional storage of the deferred ring (NULL if none).
+	size_t            deferred_mask;     ///< Deferred ring capacity - 1.
+	size_t            deferred_head;     ///< Position of the oldest deferred event.
+	size_t            deferred_tail;     ///< Next free position of the deferred ring.
+	size_t            deferred_dropped;  ///< Deferrable events dropped because the deferred ring was full.
+	int               draining;          ///< Non-zero while fsm_drain() is running.
+	int               recall;            ///< Non-zero if parked events wait for a suspended transition.
+	fsm_envelope_t*   suspended;         ///< Envelope of the event whose transition is suspended (NULL if none).
+	char              _pad0[FSM_CACHE_LINE_SIZE];
+	size_t            tail;  ///< Next position claimed by producers.
+	char              _pad1[FSM_CACHE_LINE_SIZE];
+	size_t            urgent_tail;  ///< Next position claimed by producers of the urgent lane.
+	char              _pad2[FSM_CACHE_LINE_SIZE];
+	size_t            head;         ///< Next position read by the consumer.
+	size_t            urgent_head;  ///< Next position of the urgent lane read by the consumer.
+} fsm_queue_t;
+
+/**
+ * @brief Initializes an event queue for an FSM.
+ *
+ * @param queue Pointer to the queue to initialize.
+ * @param fsm Pointer to the FSM instance that receives drained events.
+ * @param slots Caller-provided slot storage, must outlive the queue.
+ * @param capacity Number of slots, a power of two and at least 2.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_queue_init(fsm_queue_t* queue, fsm_t* fsm, fsm_queue_slot_t* slots, size_t capacity);
+
+/**
+ * @brief Posts an event to the queue.
+ * @note Safe to call from any thread, and from guards and actions of the FSM itself, in which case
+ * the event is processed after the current one completes.
+ *
+ * @param queue Pointer to the queue.
+ * @param event The event ID to post.
+ * @param data Optional data delivered with the event, must stay valid until it is processed.
+ * @return FSM_RESULT_SUCCESS if the event was queued, FSM_RESULT_QUEUE_FULL if no slot is free.
+ */
+fsm_result_t fsm_post_event(fsm_queue_t* queue, fsm_event_t event, void* data);
+
+/**
+ * @brief Posts an event whose payload moves into the queue.
+ * @note Same guarantees as fsm_post_event(). The actions receive the envelope as data and read the payload
+ * with fsm_envelope_payload(); the queue releases it once the dispatch returns. If an action suspends the
+ * transition (see fsm_suspend()), the envelope stays valid until the transition completes and is released by
+ * the first fsm_drain() after that. An event parked in the deferred ring keeps its envelope until it is
+ * dispatched again or dropped.
+ *
+ * @param queue Pointer to the queue.
+ * @param event The event ID to post.
+ * @param envelope Envelope from fsm_arena_alloc(), owned by the queue once posted.
+ * @return FSM_RESULT_SUCCESS if the event was queued, FSM_RESULT_QUEUE_FULL if no slot is free, in which
+ * case the caller keeps the envelope.
+ */
+fsm_result_t fsm_post_envelope(fsm_queue_t* queue, fsm_event_t event, fsm_envelope_t* envelope);
+
+/**
+ * @brief Adds an urgent lane to a queue.
+ * @note Events posted with fsm_post_urgent_event() preempt every event waiting in the normal lane: fsm_drain()
+ * takes them first, between two normal events. Call before any event is posted.
+ *
+ * @param queue Pointer to an initialized queue.
+ * @param slots Caller-provided slot storage, must outlive the queue.
+ * @param capacity Number of slots, a power of two and at least 2.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_queue_set_urgent(fsm_queue_t* queue, fsm_queue_slot_t* slots, size_t capacity);
+
+/**
+ * @brief Adds a deferred ring to a queue.
+ * @note When fsm_drain() delivers an event that has no transition in the current state and the state (or one
+ * of its ancestors) lists it in deferred_events of its fsm_state_desc_t, the event is parked in this ring
+ * instead of being dropped. After the next successful transition the parked events are dispatched again,
+ * oldest first, before any further queued event; those still deferred in the new state stay parked. When
+ * the ring is full the event is dropped and counted in deferred_dropped. Only events delivered through the
+ * queue are deferred, fsm_process_event() is unaffected.
+ *
+ * @param queue Pointer to an initialized queue.
+ * @param slots Caller-provided storage, must outlive the queue.
+ * @param capacity Number of slots, a power of two.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_queue_set_deferred(fsm_queue_t* queue, fsm_queue_slot_t* slots, size_t capacity);
+
+/**
+ * @brief Posts an event to the urgent lane of the queue.
+ * @note Same guarantees as fsm_post_event(). Urgent events are processed in the order they were posted.
+ *
+ * @param queue Pointer to a queue with an urgent lane.
+ * @param event The event ID to post.
+ * @param data Optional data delivered with the event, must stay valid until it is processed.
+ * @return FSM_RESULT_SUCCESS if the event was queued, FSM_RESULT_QUEUE_FULL if no slot is free,
+ * FSM_RESULT_INVALID_PARAMS if the queue has no urgent lane.
+ */
+fsm_result_t fsm_post_urgent_event(fsm_queue_t* queue, fsm_event_t event, void* data);
+
+/**
+ * @brief Posts an event to the urgent lane, moving its payload into the queue as with fsm_post_envelope().
+ *
+ * @param queue Pointer to a queue with an urgent lane.
+ * @param event The event ID to post.
+ * @param envelope Envelope from fsm_arena_alloc(), owned by the queue once posted.
+ * @return FSM_RESULT_SUCCESS if the event was queued, FSM_RESULT_QUEUE_FULL if no slot is free,
+ * FSM_RESULT_INVALID_PARAMS if the queue has no urgent lane; on failure the caller keeps the envelope.
+ */
+fsm_result_t fsm_post_urgent_envelope(fsm_queue_t* queue, fsm_event_t event, fsm_envelope_t* envelope);
+
+/**
+ * @brief Gets the number of events parked in the deferred ring.
+ * @param queue Pointer to the queue.
+ * @return Number of deferred events.
+ */
+size_t fsm_queue_deferred_count(const fsm_queue_t* queue);
+
+/**
+ * @brief Processes queued events until the queue is empty.
+ * @note Must be called from the thread owning the FSM. A nested call from a guard or action returns 0
+ * immediately; the events it would have processed are handled by the outer call. While a transition is
+ * suspended (see fsm_suspend()), the drain stops and the remaining events stay queued; call it again after
+ * fsm_resume().
+ *
+ * @param queue Pointer to the queue.
+ * @return Number of events taken from the lanes, not counting deferred events dispatched again.
+ */
+size_t fsm_drain(fsm_queue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_QUEUE_H
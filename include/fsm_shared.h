@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_SHARED_H
+#define FSM_SHARED_H
+
+#include "fsm.h"
+#include "fsm_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "FMSH" read as a little-endian 32-bit word.
+#define FSM_SHARED_MAGIC 0x48534D46u
+// Segment layout version, bumped on incompatible changes.
+#define FSM_SHARED_VERSION 1
+
+/**
+ * @brief Header at offset 0 of a shared segment.
+ * @note Followed by capacity 64-bit state words at words_offset and capacity free list links at links_offset.
+ * The creator writes magic last, so a segment with a valid magic is fully initialized.
+ */
+typedef struct fsm_shared_header {
+	uint32_t magic;         ///< FSM_SHARED_MAGIC.
+	uint16_t version;       ///< FSM_SHARED_VERSION.
+	uint16_t state_size;    ///< sizeof(fsm_state_t) of the creator.
+	uint64_t def_hash;      ///< fsm_def_hash() of the definition the states belong to.
+	uint64_t capacity;      ///< Number of instance slots.
+	uint64_t words_offset;  ///< Offset of the state words.
+	uint64_t links_offset;  ///< Offset of the free list links.
+	uint64_t total_size;    ///< Size of the segment.
+	uint64_t free_head;     ///< First free slot in the low 32 bits, ABA tag in the high ones.
+	uint64_t count;         ///< Number of live instances.
+} fsm_shared_header_t;
+
+/**
+ * @brief Decoded state word of one shared instance.
+ */
+typedef struct fsm_shared_entry {
+	fsm_state_t state;       ///< Current state.
+	uint16_t    generation;  ///< Slot generation, as in the handles of the instance.
+	uint32_t    sequence;    ///< Number of transitions the slot went through, wrapping.
+	uint8_t     live;        ///< Non-zero while the slot holds an instance.
+	uint8_t     busy;        ///< Non-zero while a process runs the callbacks of a transition.
+} fsm_shared_entry_t;
+
+/**
+ * @brief Population of FSM instances in a POSIX shared-memory segment, used by several processes.
+ * @note Only the data path is shared: each instance is one 64-bit word holding its state, generation, sequence
+ * number and flags, so every change is a single atomic operation. Definitions and callbacks stay local to each
+ * process, which opens the segment with its own copy of the definition (checked by fsm_def_hash()). When the
+ * definition has no guards, actions, hierarchy or observer, a transition is one compare-and-swap and never
+ * blocks. Otherwise the dispatching process claims the instance by setting its busy flag, runs the callbacks on
+ * a local fsm_t and publishes the new state; other processes get FSM_RESULT_BUSY meanwhile, and an instance
+ * stays busy if its process dies mid-transition. Actions must not call fsm_suspend(). Read-only observers map
+ * the segment without a definition and scan the words with plain loads. Instances are addressed with
+ * fsm_handle_t, as in fsm_pool.h. POSIX only; other platforms return FSM_RESULT_IO_ERROR.
+ */
+typedef struct fsm_shared {
+	fsm_shared_header_t* header;     ///< Mapped segment.
+	uint64_t*            words;      ///< State word of each slot.
+	uint32_t*            links;      ///< Free list link of each slot.
+	size_t               size;       ///< Size of the mapping.
+	const fsm_def_t*     def;        ///< Process-local definition, NULL for read-only observers.
+	void*                userdata;   ///< Process-local userdata of the fsm_t passed to callbacks.
+	int                  lock_free;  ///< Non-zero if transitions are a single compare-and-swap.
+} fsm_shared_t;
+
+/**
+ * @brief Creates a named segment with every slot free and maps it.
+ *
+ * @param shared Receives the mapping.
+ * @param name Segment name for shm_open(), e.g. "/orders".
+ * @param def Compiled definition of the instances.
+ * @param capacity Number of slots (1 to FSM_POOL_MAX_CAPACITY).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_IO_ERROR if the segment exists or cannot be created,
+ * FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_shared_create(fsm_shared_t* shared, const char* name, const fsm_def_t* def, size_t capacity);
+
+/**
+ * @brief Maps an existing segment for dispatching.
+ *
+ * @param shared Receives the mapping.
+ * @param name Segment name.
+ * @param def This process' copy of the definition the segment was created with, compiled.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_DEFINITION_MISMATCH if the definition or state size differs,
+ * FSM_RESULT_IO_ERROR if the segment cannot be mapped or is not initialized yet, FSM_RESULT_INVALID_PARAMS on
+ * invalid parameters.
+ */
+fsm_result_t fsm_shared_open(fsm_shared_t* shared, const char* name, const fsm_def_t* def);
+
+/**
+ * @brief Maps an existing segment read-only, for observers.
+ *
+ * @param shared Receives the mapping, its def is NULL.
+ * @param name Segment name.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_DEFINITION_MISMATCH if the state size differs,
+ * FSM_RESULT_IO_ERROR if the segment cannot be mapped or is not initialized yet, FSM_RESULT_INVALID_PARAMS on
+ * invalid parameters.
+ */
+fsm_result_t fsm_shared_open_readonly(fsm_shared_t* shared, const char* name);
+
+/**
+ * @brief Unmaps a segment. The segment itself lives on until fsm_shared_unlink().
+ * @param shared Mapping to release.
+ */
+void fsm_shared_close(fsm_shared_t* shared);
+
+/**
+ * @brief Removes a named segment; mappings that are still open stay valid.
+ * @param name Segment name.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_IO_ERROR otherwise.
+ */
+fsm_result_t fsm_shared_unlink(const char* name);
+
+/**
+ * @brief Creates an instance in a free slot. Lock-free, safe from any process.
+ *
+ * @param shared Writable mapping.
+ * @param initial_state The starting state.
+ * @param out_handle Receives the handle of the new instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_POOL_FULL if no slot is free,
+ * FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_shared_alloc(fsm_shared_t* shared, fsm_state_t initial_state, fsm_handle_t* out_handle);
+
+/**
+ * @brief Destroys an instance and invalidates its handles.
+ *
+ * @param shared Writable mapping.
+ * @param handle Handle of the instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_HANDLE if the handle is stale, FSM_RESULT_BUSY if
+ * another process is running a transition of the instance.
+ */
+fsm_result_t fsm_shared_free(fsm_shared_t* shared, fsm_handle_t handle);
+
+/**
+ * @brief Processes an event on a shared instance.
+ *
+ * @param shared Writable mapping.
+ * @param handle Handle of the instance.
+ * @param event The event to be processed.
+ * @param data Optional data passed to the guard and actions.
+ * @return Result of the dispatch as for fsm_process_event(), FSM_RESULT_INVALID_HANDLE if the handle is stale,
+ * FSM_RESULT_BUSY if another process is running a transition of the instance.
+ */
+fsm_result_t fsm_shared_process(fsm_shared_t* shared, fsm_handle_t handle, fsm_event_t event, void* data);
+
+/**
+ * @brief Reads the state word of a slot without any system call.
+ * @note Works on read-only mappings. Comparing sequence numbers of two reads tells whether the instance moved.
+ *
+ * @param shared Mapping.
+ * @param index Slot index, below header->capacity.
+ * @param entry Receives the decoded word.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS if index is out of range.
+ */
+fsm_result_t fsm_shared_read(const fsm_shared_t* shared, size_t index, fsm_shared_entry_t* entry);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_SHARED_H
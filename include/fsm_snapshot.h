@@ -0,0 +1,193 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_SNAPSHOT_H
+#define FSM_SNAPSHOT_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// "FSMS" read as a little-endian 32-bit word; a byte-swapped magic means a foreign byte order.
+#define FSM_SNAPSHOT_MAGIC 0x534D5346u
+// Format version, bumped on incompatible layout changes.
+#define FSM_SNAPSHOT_VERSION 1
+// Alignment of the sections following the header.
+#define FSM_SNAPSHOT_ALIGN 64
+
+/**
+ * @brief Snapshot header, at offset 0 of a snapshot buffer.
+ * @note Followed by count states at states_offset and, if record_size is non-zero, count userdata records
+ * of record_size bytes each at records_offset. An instance that was unbound (NULL def) when written, such as
+ * a free pool slot, has the state FSM_STATE_NONE and a zeroed record. Values are in native byte order.
+ */
+typedef struct fsm_snapshot_header {
+	uint32_t magic;           ///< FSM_SNAPSHOT_MAGIC.
+	uint16_t version;         ///< FSM_SNAPSHOT_VERSION.
+	uint16_t state_size;      ///< sizeof(fsm_state_t) of the writer, tells narrow and wide builds apart.
+	uint64_t def_hash;        ///< fsm_def_hash() of the definition the states belong to.
+	uint64_t count;           ///< Number of instances.
+	uint64_t record_size;     ///< Bytes of userdata per instance (0 if none).
+	uint64_t states_offset;   ///< Offset of the states array.
+	uint64_t records_offset;  ///< Offset of the records array.
+	uint64_t total_size;      ///< Size of the whole snapshot.
+	uint64_t reserved;        ///< Zero.
+} fsm_snapshot_header_t;
+
+/**
+ * @brief Zero-copy view of a validated snapshot buffer.
+ */
+typedef struct fsm_snapshot_view {
+	const fsm_snapshot_header_t* header;       ///< Header at the start of the buffer.
+	const fsm_state_t*           states;       ///< States of the instances, FSM_STATE_NONE if unbound.
+	void*                        records;      ///< Userdata records, count * record_size bytes (NULL if none).
+	size_t                       count;        ///< Number of instances.
+	size_t                       record_size;  ///< Bytes per record.
+} fsm_snapshot_view_t;
+
+/**
+ * @brief Serializes the userdata of one instance into its fixed-size record.
+ * @param context Context passed to fsm_snapshot_write().
+ * @param fsm Instance being saved.
+ * @param record Record of record_size bytes to fill.
+ * @param record_size Size of the record.
+ */
+typedef void (*fsm_snapshot_save_t)(void* context, const struct fsm* fsm, void* record, size_t record_size);
+
+/**
+ * @brief Restores the userdata of one instance from its record.
+ * @param context Context passed to fsm_snapshot_restore().
+ * @param fsm Instance being restored, already in its saved state.
+ * @param record Record of record_size bytes, inside the snapshot buffer.
+ * @param record_size Size of the record.
+ */
+typedef void (*fsm_snapshot_load_t)(void* context, struct fsm* fsm, void* record, size_t record_size);
+
+/**
+ * @brief Number of bytes a snapshot of count instances needs.
+ * @param count Number of instances.
+ * @param record_size Bytes of userdata per instance (0 if none).
+ * @return Size of the snapshot buffer.
+ */
+size_t fsm_snapshot_size(size_t count, size_t record_size);
+
+/**
+ * @brief Writes a snapshot of a population into one contiguous buffer.
+ * @note Instances with a NULL def are recorded as unbound and save is not called for them. Nothing is written
+ * if an instance belongs to another definition or has a suspended transition, whose remaining actions a
+ * snapshot cannot capture.
+ *
+ * @param def Definition shared by the instances.
+ * @param instances Array of count instances.
+ * @param count Number of instances.
+ * @param record_size Bytes of userdata per instance (0 if none).
+ * @param save Fills the record of each instance, required if record_size is non-zero.
+ * @param context Context passed to save.
+ * @param buffer Destination, at least fsm_snapshot_size(count, record_size) bytes, aligned to 8 bytes.
+ * @param buffer_size Size of buffer.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_DEFINITION_MISMATCH if an instance uses another definition,
+ * FSM_RESULT_BUSY if an instance has a suspended transition, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_snapshot_write(const fsm_def_t* def, const fsm_t* instances, size_t count, size_t record_size,
+								fsm_snapshot_save_t save, void* context, void* buffer, size_t buffer_size);
+
+/**
+ * @brief Validates a snapshot buffer against a definition and exposes it without copying.
+ *
+ * @param def Definition the snapshot must have been taken against.
+ * @param buffer Snapshot buffer, for example a mapped file, aligned to 8 bytes.
+ * @param buffer_size Size of buffer.
+ * @param view Receives pointers into buffer.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_DEFINITION_MISMATCH if the table hash or state size differs,
+ * FSM_RESULT_INVALID_PARAMS if the buffer is not a well-formed snapshot.
+ */
+fsm_result_t fsm_snapshot_view(const fsm_def_t* def, void* buffer, size_t buffer_size, fsm_snapshot_view_t* view);
+
+/**
+ * @brief Restores instances from a snapshot view.
+ * @note Each instance is initialized with def in its saved state. With a load callback, the callback sets up
+ * the userdata from the record; without one, userdata points straight at the record inside the buffer,
+ * so the buffer must stay mapped while the instances use it. Instances recorded as unbound are skipped and
+ * only get a NULL def, like free pool slots.
+ *
+ * @param view Validated snapshot view.
+ * @param def Definition the view was validated against.
+ * @param instances Array receiving the instances, at least view->count entries.
+ * @param count Number of entries in instances.
+ * @param load Optional record decoder (NULL for zero-copy userdata, or no userdata if records are absent).
+ * @param context Context passed to load.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or a saved state
+ * outside the definition.
+ */
+fsm_result_t fsm_snapshot_restore(const fsm_snapshot_view_t* view, const fsm_def_t* def, fsm_t* instances,
+								  size_t count, fsm_snapshot_load_t load, void* context);
+
+/**
+ * @brief Memory-mapped snapshot file.
+ */
+typedef struct fsm_snapshot_map {
+	void*  data;  ///< Start of the mapping.
+	size_t size;  ///< Size of the mapping.
+} fsm_snapshot_map_t;
+
+/**
+ * @brief Writes a snapshot straight into a file through a shared mapping.
+ * @note The snapshot is written to path with ".tmp" appended, flushed to disk and then renamed over path, so
+ * a crash leaves either the previous file or the complete new one. POSIX only; other platforms return
+ * FSM_RESULT_IO_ERROR.
+ *
+ * @param path File to create or replace.
+ * @param def Definition shared by the instances.
+ * @param instances Array of count instances.
+ * @param count Number of instances.
+ * @param record_size Bytes of userdata per instance (0 if none).
+ * @param save Fills the record of each instance, required if record_size is non-zero.
+ * @param context Context passed to save.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_IO_ERROR if the file cannot be written, otherwise the
+ * result of fsm_snapshot_write(); path is left unchanged on failure.
+ */
+fsm_result_t fsm_snapshot_write_file(const char* path, const fsm_def_t* def, const fsm_t* instances, size_t count,
+									 size_t record_size, fsm_snapshot_save_t save, void* context);
+
+/**
+ * @brief Maps a snapshot file copy-on-write, so restored userdata records can be modified in place.
+ * @note POSIX only; other platforms return FSM_RESULT_IO_ERROR.
+ *
+ * @param path Snapshot file.
+ * @param map Receives the mapping, pass map->data and map->size to fsm_snapshot_view().
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_IO_ERROR if the file cannot be mapped.
+ */
+fsm_result_t fsm_snapshot_map_file(const char* path, fsm_snapshot_map_t* map);
+
+/**
+ * @brief Unmaps a snapshot file.
+ * @param map Mapping from fsm_snapshot_map_file().
+ */
+void fsm_snapshot_unmap_file(fsm_snapshot_map_t* map);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_SNAPSHOT_H
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_STATS_H
+#define FSM_STATS_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Whether the instrumentation layer is compiled into the dispatch path (CMake option FSM_ENABLE_STATS).
+#ifdef FSM_STATS
+#define FSM_STATS_ENABLED 1
+#else
+#define FSM_STATS_ENABLED 0
+#endif
+
+// Number of log2 buckets in a callback latency histogram (bucket i counts durations below 2^i ns).
+#define FSM_STATS_LATENCY_BUCKETS 32
+
+/**
+ * @brief Callback kinds with a latency histogram.
+ */
+typedef enum {
+	FSM_STATS_GUARD,     ///< Guard functions.
+	FSM_STATS_EXIT,      ///< Exit actions of the source state and on_exit actions of the fired rule.
+	FSM_STATS_ENTRY,     ///< on_entry actions of the fired rule and entry actions of the target state.
+	FSM_STATS_CALLBACKS  ///< Number of callback kinds.
+} fsm_stats_callback_t;
+
+/**
+ * @brief Per-thread dispatch counters.
+ * @note A thread attaches a block with fsm_stats_attach(); every event it dispatches afterwards is counted
+ * there without atomics or locks. Blocks of several threads can be combined with fsm_stats_merge().
+ * Per-rule counters are only kept for events of the definition given to fsm_stats_init().
+ */
+typedef struct fsm_stats {
+	const fsm_def_t* def;            ///< Definition whose rules are counted.
+	uint64_t*        rule_hits;      ///< Caller-provided, transitions fired per rule.
+	uint64_t*        rule_denials;   ///< Caller-provided, guard denials per rule.
+	size_t           rule_capacity;  ///< Number of entries in rule_hits and rule_denials.
+	uint64_t         results[FSM_RESULT_COUNT];       ///< Events per fsm_result_t returned by dispatch.
+	uint64_t         state_dwell_ns[FSM_MAX_STATES];  ///< Time spent in each state, summed over left visits.
+	uint64_t         state_exits[FSM_MAX_STATES];     ///< Number of times each state was left.
+	uint64_t         callback_latency[FSM_STATS_CALLBACKS][FSM_STATS_LATENCY_BUCKETS];  ///< Latency histograms.
+} fsm_stats_t;
+
+/**
+ * @brief Initializes a statistics block with all counters at zero.
+ *
+ * @param stats Pointer to the block.
+ * @param def Definition whose rules are counted (NULL to skip per-rule counters).
+ * @param rule_hits Storage for per-rule hit counters, may be NULL when def is NULL.
+ * @param rule_denials Storage for per-rule guard denial counters, may be NULL when def is NULL.
+ * @param rule_capacity Number of entries in each per-rule array, at least def->transition_count.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_stats_init(fsm_stats_t* stats, const fsm_def_t* def, uint64_t* rule_hits, uint64_t* rule_denials,
+							size_t rule_capacity);
+
+/**
+ * @brief Attaches a statistics block to the calling thread.
+ * @note Has no effect on dispatch when the library is built without FSM_STATS.
+ * @param stats Pointer to the block, or NULL to detach.
+ */
+void fsm_stats_attach(fsm_stats_t* stats);
+
+/**
+ * @brief Gets the statistics block attached to the calling thread.
+ * @return Pointer to the attached block, or NULL.
+ */
+fsm_stats_t* fsm_stats_current(void);
+
+/**
+ * @brief Adds the counters of one block to another.
+ * @note Per-rule counters are merged only when both blocks count the same definition.
+ * @param dst Block receiving the sums.
+ * @param src Block to add, should not be updated concurrently.
+ */
+void fsm_stats_merge(fsm_stats_t* dst, const fsm_stats_t* src);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_STATS_H
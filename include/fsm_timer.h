@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_TIMER_H
+#define FSM_TIMER_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of wheel levels; each level covers FSM_TIMER_SLOTS times the span of the level below.
+#define FSM_TIMER_LEVELS 4
+// log2 of the number of slots per level.
+#define FSM_TIMER_SLOT_BITS 6
+// Number of slots per level.
+#define FSM_TIMER_SLOTS (1 << FSM_TIMER_SLOT_BITS)
+// Maximum number of expiries handed to fsm_process_events_batch() at once.
+#define FSM_TIMER_BATCH 64
+// Marks an empty list link.
+#define FSM_TIMER_NONE 0xFFFFFFFFu
+
+/**
+ * @brief Timer of one instance, linked into a wheel slot while armed.
+ */
+typedef struct fsm_timer_node {
+	uint64_t    deadline;  ///< Tick at which the timer expires.
+	uint32_t    next;      ///< Next node in the slot, FSM_TIMER_NONE at the end.
+	uint32_t    prev;      ///< Previous node in the slot, FSM_TIMER_NONE at the head.
+	uint16_t    slot;      ///< Slot holding the node (level * FSM_TIMER_SLOTS + slot), FSM_TIMER_IDLE if disarmed.
+	fsm_event_t event;     ///< Event delivered on expiry.
+} fsm_timer_node_t;
+
+// Slot value of a disarmed node.
+#define FSM_TIMER_IDLE 0xFFFF
+
+/**
+ * @brief Hierarchical timing wheel driving the state timeouts of a population.
+ * @note Instances live in one caller-provided array and share a definition; the wheel keeps one timer per
+ * instance, indexed like the array. It observes the definition, so entering a state with a timeout arms
+ * the timer and any transition cancels the previous one. Time only advances through fsm_tick(), in ticks
+ * of whatever unit the caller chooses. Not thread-safe: tick and dispatch from the same thread.
+ */
+typedef struct fsm_timer_wheel {
+	fsm_def_t*        def;                                       ///< Observed definition.
+	fsm_t*            instances;                                 ///< Caller-provided instances.
+	fsm_timer_node_t* nodes;                                     ///< Caller-provided timers, one per instance.
+	size_t            count;                                     ///< Number of instances.
+	uint64_t          now;                                       ///< Last tick processed.
+	fsm_observer_t    next_observer;                             ///< Observer installed before the wheel.
+	void*             next_context;                              ///< Context of next_observer.
+	uint32_t          heads[FSM_TIMER_LEVELS][FSM_TIMER_SLOTS];  ///< First node of each slot.
+	fsm_t*            batch_instances[FSM_TIMER_BATCH];          ///< Expired instances awaiting dispatch.
+	fsm_event_t       batch_events[FSM_TIMER_BATCH];             ///< Events of batch_instances.
+	fsm_result_t      batch_results[FSM_TIMER_BATCH];            ///< Dispatch results of the last batch.
+} fsm_timer_wheel_t;
+
+/**
+ * @brief Initializes a timer wheel over a population and arms the timeouts of their current states.
+ * @note Instances must already be initialized with def; entries with a NULL def, such as free slots of an
+ * fsm_pool_t, are skipped. State timeouts come from the state table attached with fsm_def_set_states().
+ * The wheel registers itself as the observer of def.
+ *
+ * @param wheel Pointer to the wheel.
+ * @param def Definition shared by all instances.
+ * @param instances Array of count initialized instances, must outlive the wheel.
+ * @param nodes Caller-provided array of count timers, must outlive the wheel.
+ * @param count Number of instances (below FSM_TIMER_NONE).
+ * @param now Current tick.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_timer_init(fsm_timer_wheel_t* wheel, fsm_def_t* def, fsm_t* instances, fsm_timer_node_t* nodes,
+							size_t count, uint64_t now);
+
+/**
+ * @brief Detaches the wheel from its definition, restoring the previous observer.
+ * @note Observers chain in installation order, so modules sharing a definition (timer wheels, membership
+ * indexes) must be detached in reverse order of initialization.
+ *
+ * @param wheel Pointer to the wheel.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS if an observer installed after the wheel
+ * is still attached, in which case the wheel stays attached.
+ */
+fsm_result_t fsm_timer_deinit(fsm_timer_wheel_t* wheel);
+
+/**
+ * @brief Arms the timer of an instance, replacing any armed timer. O(1).
+ *
+ * @param wheel Pointer to the wheel.
+ * @param id Index of the instance.
+ * @param ticks Ticks from now until expiry (at least 1).
+ * @param event Event delivered on expiry.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_timer_arm(fsm_timer_wheel_t* wheel, size_t id, uint64_t ticks, fsm_event_t event);
+
+/**
+ * @brief Cancels the timer of an instance, if armed. O(1).
+ *
+ * @param wheel Pointer to the wheel.
+ * @param id Index of the instance.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_timer_cancel(fsm_timer_wheel_t* wheel, size_t id);
+
+/**
+ * @brief Advances the wheel to a tick and delivers the expired timeouts.
+ * @note Expiries are dispatched in batches of up to FSM_TIMER_BATCH events with fsm_process_events_batch().
+ * Timers armed by the resulting transitions are handled in the same call if they are due by now.
+ * A timeout that does not fire stays armed: when a guard denies it, the timer is re-armed with the timeout
+ * of the current state (or dropped if the state has none), and when the instance is busy with a suspended
+ * transition it is retried every tick until the transition completes. Timeouts matching no rule are dropped,
+ * as are timers of instances whose def is NULL. A now at or before the last tick does nothing.
+ *
+ * @param wheel Pointer to the wheel.
+ * @param now Current tick.
+ * @return Number of timeout events delivered.
+ */
+size_t fsm_tick(fsm_timer_wheel_t* wheel, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_TIMER_H
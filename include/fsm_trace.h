@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_TRACE_H
+#define FSM_TRACE_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Whether the trace hooks are compiled into the dispatch path (CMake option FSM_ENABLE_TRACE).
+#ifdef FSM_TRACE
+#define FSM_TRACE_ENABLED 1
+#else
+#define FSM_TRACE_ENABLED 0
+#endif
+
+// Bits of fsm_trace_record_t::event_result holding the event ID, the rest holds the result code.
+#define FSM_TRACE_EVENT_BITS 12
+// Instance ID of a record whose instance lies outside the traced array.
+#define FSM_TRACE_NO_INSTANCE 0xFFFFFFFFu
+
+#if FSM_MAX_EVENTS > (1 << FSM_TRACE_EVENT_BITS)
+#error "FSM_MAX_EVENTS does not fit in a trace record"
+#endif
+
+/**
+ * @brief One dispatched event, packed into 16 bytes.
+ * @note States always fit in 8 bits since FSM_MAX_STATES is at most 256.
+ */
+typedef struct fsm_trace_record {
+	uint64_t timestamp;     ///< Clock ticks at dispatch (TSC on x86), only differences are meaningful.
+	uint32_t instance;      ///< Index in the traced instance array, or FSM_TRACE_NO_INSTANCE.
+	uint16_t event_result;  ///< Event ID in the low FSM_TRACE_EVENT_BITS bits, fsm_result_t above.
+	uint8_t  from;          ///< State before dispatch.
+	uint8_t  to;            ///< State after dispatch.
+} fsm_trace_record_t;
+
+// Event ID of a trace record.
+#define FSM_TRACE_RECORD_EVENT(record) \
+	((fsm_event_t)((record)->event_result & ((1u << FSM_TRACE_EVENT_BITS) - 1)))
+// Result code of a trace record.
+#define FSM_TRACE_RECORD_RESULT(record) ((fsm_result_t)((record)->event_result >> FSM_TRACE_EVENT_BITS))
+
+/**
+ * @brief Per-thread flight recorder of dispatched events.
+ * @note Only the attached thread writes the ring, overwriting the oldest records once full, so recording
+ * needs no locks. head is published with release ordering; a reader on another thread may see records that
+ * are being overwritten, so copy the ring after detaching it for an exact dump.
+ */
+typedef struct fsm_trace_ring {
+	fsm_trace_record_t* records;         ///< Caller-provided record storage.
+	size_t              mask;            ///< Capacity - 1, capacity is a power of two.
+	size_t              head;            ///< Number of records written so far.
+	const fsm_t*        instances;       ///< Array instance IDs are taken from (NULL for none).
+	size_t              instance_count;  ///< Number of entries in instances.
+} fsm_trace_ring_t;
+
+/**
+ * @brief Replay statistics.
+ */
+typedef struct fsm_trace_replay_report {
+	size_t   events;          ///< Records dispatched.
+	size_t   skipped;         ///< Records without a usable instance ID.
+	size_t   mismatches;      ///< Records whose source state, result or target state did not reproduce.
+	uint64_t elapsed_ns;      ///< Wall time spent replaying.
+	double   events_per_sec;  ///< Dispatch throughput of the replay.
+} fsm_trace_replay_report_t;
+
+/**
+ * @brief Initializes a trace ring.
+ *
+ * @param ring Pointer to the ring.
+ * @param records Caller-provided storage for capacity records.
+ * @param capacity Number of records, a power of two.
+ * @param instances Optional array of traced instances; a record's instance ID is its index in it.
+ * @param instance_count Number of entries in instances (below FSM_TRACE_NO_INSTANCE).
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_trace_init(fsm_trace_ring_t* ring, fsm_trace_record_t* records, size_t capacity,
+							const fsm_t* instances, size_t instance_count);
+
+/**
+ * @brief Attaches a trace ring to the calling thread.
+ * @note Has no effect on dispatch when the library is built without FSM_TRACE.
+ * @param ring Pointer to the ring, or NULL to detach.
+ */
+void fsm_trace_attach(fsm_trace_ring_t* ring);
+
+/**
+ * @brief Gets the trace ring attached to the calling thread.
+ * @return Pointer to the attached ring, or NULL.
+ */
+fsm_trace_ring_t* fsm_trace_current(void);
+
+/**
+ * @brief Copies the retained records of a ring, oldest first.
+ *
+ * @param ring Pointer to the ring.
+ * @param out Destination array.
+ * @param capacity Number of entries in out; the newest records are kept if it is smaller than the ring.
+ * @return Number of records copied.
+ */
+size_t fsm_trace_copy(const fsm_trace_ring_t* ring, fsm_trace_record_t* out, size_t capacity);
+
+/**
+ * @brief Feeds a trace back through a definition to reproduce the recorded states.
+ * @note An instance seen for the first time (def == NULL) is initialized in the record's source state, so
+ * pass zeroed instances. When an instance is not in the recorded source state, the record counts as a
+ * mismatch and the instance is moved there before dispatch. Events are dispatched with NULL data, so
+ * actions must tolerate it. Tracing is detached on the calling thread during the replay.
+ *
+ * @param def Definition the trace was recorded with.
+ * @param records Array of count records.
+ * @param count Number of records.
+ * @param instances Array of instance_count instances, indexed by record instance ID.
+ * @param instance_count Number of entries in instances.
+ * @param report Receives the replay statistics.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_trace_replay(const fsm_def_t* def, const fsm_trace_record_t* records, size_t count,
+							  fsm_t* instances, size_t instance_count, fsm_trace_replay_report_t* report);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_TRACE_H
@@ -0,0 +1,208 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_VERSION_H
+#define FSM_VERSION_H
+
+#include "fsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Epoch of a reader slot that is offline and does not hold back reclamation.
+#define FSM_VERSIONS_OFFLINE 0
+
+typedef struct fsm_version fsm_version_t;
+
+/**
+ * @brief Maps a state of the previous version to the same state in a new version.
+ * @param context User-provided context.
+ * @param state State number in the previous version.
+ * @return State number in the new version.
+ */
+typedef fsm_state_t (*fsm_remap_t)(void* context, fsm_state_t state);
+
+/**
+ * @brief Called once a retired version is no longer used by any thread or instance.
+ * @param context User-provided context.
+ * @param version The released version, whose storage may now be freed or reused.
+ */
+typedef void (*fsm_version_release_t)(void* context, fsm_version_t* version);
+
+/**
+ * @brief One published revision of a machine definition.
+ * @note The caller builds def with the fsm_def_* functions and fills the callbacks, then hands the version to
+ * fsm_versions_init() or fsm_versions_publish(). The remaining fields are managed by the version set. The
+ * version and everything its definition points to must stay valid until release is called.
+ */
+struct fsm_version {
+	fsm_def_t             def;              ///< Definition of this version, instances point here.
+	fsm_remap_t           remap;            ///< Maps states of the previous version (NULL if numbering is kept).
+	void*                 remap_context;    ///< Context passed to remap.
+	fsm_version_release_t release;          ///< Called when the version is released (NULL if none).
+	void*                 release_context;  ///< Context passed to release.
+	fsm_version_t*        next;             ///< Version published after this one, NULL while current.
+	uint64_t              number;           ///< Publication number, 1 for the initial version.
+	size_t                retired_epoch;    ///< Epoch at which the version stopped being current.
+	size_t                instances;        ///< Number of instances using the version.
+};
+
+/**
+ * @brief Reader slot of a thread dispatching events of versioned instances.
+ */
+typedef struct fsm_versions_reader {
+	size_t epoch;                                       ///< Last epoch announced, or FSM_VERSIONS_OFFLINE.
+	char   _pad[FSM_CACHE_LINE_SIZE - sizeof(size_t)];  ///< Keeps each slot on its own cache line.
+} fsm_versions_reader_t;
+
+/**
+ * @brief Set of versions of a definition, with one current version that can be replaced while events are
+ * being dispatched.
+ * @note Publication is RCU-style. Dispatching threads take no locks: fsm_versions_process() compares the
+ * instance's definition with the current version and, when a newer one was published, moves the instance to it
+ * before dispatching, remapping its state through every version in between. A dispatch that started on an old
+ * version finishes on it. Each dispatching thread owns a reader slot and reports a quiescent state with
+ * fsm_versions_quiescent() between events, typically once per batch; it must not hold on to a version across
+ * that call. A retired version is released once every online reader has reported a quiescent state since its
+ * retirement and no instance uses it anymore, oldest first. Publication and reclamation must be serialized by
+ * the caller.
+ */
+typedef struct fsm_versions {
+	fsm_version_t*         current;       ///< Published version, read by the dispatching threads.
+	fsm_version_t*         oldest;        ///< Oldest version not released yet.
+	fsm_versions_reader_t* readers;       ///< Caller-provided reader slots.
+	size_t                 reader_count;  ///< Number of reader slots.
+	char                   _pad0[FSM_CACHE_LINE_SIZE];
+	size_t                 epoch;  ///< Grace period counter, advanced by every publication.
+	char                   _pad1[FSM_CACHE_LINE_SIZE];
+} fsm_versions_t;
+
+/**
+ * @brief Initializes a version set with its first version.
+ * @note Every reader slot starts online; slots of threads that do not dispatch must be taken offline with
+ * fsm_versions_offline(), or they hold back reclamation.
+ *
+ * @param versions Pointer to the version set.
+ * @param initial First version, its def initialized.
+ * @param readers Caller-provided reader slots, one per dispatching thread, must outlive the set.
+ * @param reader_count Number of reader slots.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_versions_init(fsm_versions_t* versions, fsm_version_t* initial, fsm_versions_reader_t* readers,
+							   size_t reader_count);
+
+/**
+ * @brief Makes a version current. Events dispatched afterwards use it.
+ * @note The previous version is retired and released by a later fsm_versions_reclaim() once it is unused;
+ * this call runs one reclamation pass. Must not run concurrently with another publication or reclamation.
+ *
+ * @param versions Pointer to the version set.
+ * @param version New version, its def initialized, not published before.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters.
+ */
+fsm_result_t fsm_versions_publish(fsm_versions_t* versions, fsm_version_t* version);
+
+/**
+ * @brief Releases the retired versions no longer used by any reader or instance.
+ * @note Same threading rules as fsm_versions_publish(). Call periodically after a publication until the
+ * retired versions are released.
+ *
+ * @param versions Pointer to the version set.
+ * @return Number of versions released.
+ */
+size_t fsm_versions_reclaim(fsm_versions_t* versions);
+
+/**
+ * @brief Gets the current version.
+ * @param versions Pointer to the version set.
+ * @return Pointer to the current version.
+ */
+const fsm_version_t* fsm_versions_current(const fsm_versions_t* versions);
+
+/**
+ * @brief Reports a quiescent state of a reader: it holds no version it read before this call.
+ * @note Also brings an offline reader back online, which must happen before it dispatches again.
+ *
+ * @param versions Pointer to the version set.
+ * @param reader Index of the calling thread's reader slot.
+ */
+void fsm_versions_quiescent(fsm_versions_t* versions, size_t reader);
+
+/**
+ * @brief Takes a reader offline, e.g. before it blocks for a long time, so it no longer holds back reclamation.
+ * @param versions Pointer to the version set.
+ * @param reader Index of the calling thread's reader slot.
+ */
+void fsm_versions_offline(fsm_versions_t* versions, size_t reader);
+
+/**
+ * @brief Initializes an instance on the current version.
+ * @note Called from a reader thread or the publishing thread.
+ *
+ * @param versions Pointer to the version set.
+ * @param self Pointer to the FSM instance.
+ * @param initial_state Initial state in the current version.
+ * @return FSM_RESULT_SUCCESS on success, or the error of fsm_init().
+ */
+fsm_result_t fsm_versions_attach(fsm_versions_t* versions, fsm_t* self, fsm_state_t initial_state);
+
+/**
+ * @brief Removes an instance from its version, which may then be released.
+ * @param versions Pointer to the version set.
+ * @param self Pointer to an attached instance, its def is reset to NULL.
+ */
+void fsm_versions_detach(fsm_versions_t* versions, fsm_t* self);
+
+/**
+ * @brief Moves an instance to the current version, remapping its state.
+ * @note Called from a reader thread by the thread dispatching for the instance, or from the publishing thread
+ * while nothing dispatches for it. A suspended transition (see fsm_suspend()) completes on its version first.
+ * Observers belong to a def, so those installed on the old version's def, such as a timer wheel or a membership
+ * index, stop tracking the instance once it migrates; install them on the new def as well to keep tracking it.
+ *
+ * @param versions Pointer to the version set.
+ * @param self Pointer to an attached instance.
+ * @return FSM_RESULT_SUCCESS if the instance is on the current version, FSM_RESULT_BUSY if a transition is
+ * pending, FSM_RESULT_STATE_OUT_OF_BOUNDS if a remap callback returned an invalid state, in which case the
+ * instance stays on its version.
+ */
+fsm_result_t fsm_versions_migrate(fsm_versions_t* versions, fsm_t* self);
+
+/**
+ * @brief Dispatches an event on the current version of the definition.
+ * @note fsm_versions_migrate() followed by fsm_process_event(). An instance with a pending transition keeps its
+ * version and gets FSM_RESULT_BUSY as usual.
+ *
+ * @param versions Pointer to the version set.
+ * @param self Pointer to an attached instance.
+ * @param event The event ID to process.
+ * @param data Optional data passed to the guard and actions.
+ * @return Same result code as fsm_process_event(), or the error of fsm_versions_migrate().
+ */
+fsm_result_t fsm_versions_process(fsm_versions_t* versions, fsm_t* self, fsm_event_t event, void* data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // FSM_VERSION_H
@@ -25,12 +25,162 @@
 
 #include <assert.h>
 
-// Macro to check if a state is in a mask
-#define FSM_STATE_IN_MASK(state, mask) ((mask & FSM_STATE_MASK(state)) != 0)
+#include "fsm_stats.h"
+#include "fsm_trace.h"
+#if defined(FSM_STATS) || defined(FSM_TRACE)
+#include "fsm_clock.h"
+#endif
+#ifdef FSM_TRACE
+#include "fsm_atomic.h"
+#endif
 
-fsm_result_t fsm_init(fsm_t* self, uint8_t initial_state, const fsm_transition_t* transition_rules,
-					  size_t transition_count) {
-	if (!self || !transition_rules || transition_count == 0) {
+// Hint the CPU to pull a cache line that is about to be read
+#if defined(__GNUC__) || defined(__clang__)
+#define FSM_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define FSM_PREFETCH(addr) ((void)(addr))
+#endif
+
+// Number of batch items to look ahead when prefetching instance state
+#define FSM_BATCH_PREFETCH_DISTANCE 8
+
+#if defined(_MSC_VER)
+#define FSM_THREAD_LOCAL __declspec(thread)
+#else
+#define FSM_THREAD_LOCAL __thread
+#endif
+
+// Statistics block of the calling thread; kept in this unit so the hot path reads it without a call.
+static FSM_THREAD_LOCAL fsm_stats_t* fsm_stats_thread = NULL;
+
+void fsm_stats_attach(fsm_stats_t* stats) {
+	fsm_stats_thread = stats;
+}
+
+fsm_stats_t* fsm_stats_current(void) {
+	return fsm_stats_thread;
+}
+
+// Trace ring of the calling thread, read by the dispatch path like fsm_stats_thread.
+static FSM_THREAD_LOCAL fsm_trace_ring_t* fsm_trace_thread = NULL;
+
+void fsm_trace_attach(fsm_trace_ring_t* ring) {
+	fsm_trace_thread = ring;
+}
+
+fsm_trace_ring_t* fsm_trace_current(void) {
+	return fsm_trace_thread;
+}
+
+#ifdef FSM_TRACE
+static void fsm_trace_record(fsm_trace_ring_t* ring, const fsm_t* self, fsm_event_t event, fsm_state_t from,
+							 fsm_result_t result) {
+	size_t              head   = ring->head;
+	fsm_trace_record_t* record = &ring->records[head & ring->mask];
+	uintptr_t           offset = (uintptr_t)self - (uintptr_t)ring->instances;
+	record->timestamp          = fsm_clock_ticks();
+	record->instance           = offset < ring->instance_count * sizeof(fsm_t) ? (uint32_t)(offset / sizeof(fsm_t))
+																			   : FSM_TRACE_NO_INSTANCE;
+	record->event_result       = (uint16_t)(event | ((unsigned)result << FSM_TRACE_EVENT_BITS));
+	record->from               = (uint8_t)from;
+	record->to                 = (uint8_t)self->current_state;
+	FSM_ATOMIC_STORE_RELEASE(&ring->head, head + 1);
+}
+
+#define FSM_TRACE_BEGIN(trace, self)                       \
+	fsm_trace_ring_t* trace        = fsm_trace_thread;      \
+	fsm_state_t       trace##_from = (self)->current_state
+#define FSM_TRACE_END(trace, self, event, result)                       \
+	do {                                                                \
+		if (trace) {                                                    \
+			fsm_trace_record(trace, self, event, trace##_from, result); \
+		}                                                               \
+	} while (0)
+#else
+#define FSM_TRACE_BEGIN(trace, self)              ((void)0)
+#define FSM_TRACE_END(trace, self, event, result) ((void)0)
+#endif
+
+#ifdef FSM_STATS
+// Counts a duration in the log2 bucket of its callback kind.
+static inline void fsm_stats_latency(fsm_stats_t* stats, fsm_stats_callback_t kind, uint64_t ns) {
+	size_t bucket = 0;
+	while (ns && bucket < FSM_STATS_LATENCY_BUCKETS - 1) {
+		ns >>= 1;
+		bucket++;
+	}
+	stats->callback_latency[kind][bucket]++;
+}
+
+static inline int fsm_stats_guard(fsm_stats_t* stats, fsm_guard_t guard, fsm_t* self, void* data) {
+	if (!stats) {
+		return guard(self, data);
+	}
+	uint64_t start  = fsm_clock_ns();
+	int      result = guard(self, data);
+	fsm_stats_latency(stats, FSM_STATS_GUARD, fsm_clock_ns() - start);
+	return result;
+}
+
+static inline void fsm_stats_action(fsm_stats_t* stats, fsm_stats_callback_t kind, fsm_action_t action, fsm_t* self,
+									void* data) {
+	if (!stats) {
+		action(self, data);
+		return;
+	}
+	uint64_t start = fsm_clock_ns();
+	action(self, data);
+	fsm_stats_latency(stats, kind, fsm_clock_ns() - start);
+}
+
+// Counts a rule outcome, only for the definition the block was set up with.
+static inline void fsm_stats_rule(fsm_stats_t* stats, const fsm_def_t* def, const fsm_transition_t* rule,
+								  int denied) {
+	if (stats && stats->def == def) {
+		size_t i = (size_t)(rule - def->transition_rules);
+		if (denied) {
+			stats->rule_denials[i]++;
+		} else {
+			stats->rule_hits[i]++;
+		}
+	}
+}
+
+// Charges the time since the last transition to the state being left.
+static inline void fsm_stats_leave(fsm_stats_t* stats, fsm_t* self) {
+	if (stats) {
+		uint64_t now = fsm_clock_ns();
+		stats->state_dwell_ns[self->current_state] += now - self->entered_ns;
+		stats->state_exits[self->current_state]++;
+		self->entered_ns = now;
+	}
+}
+
+static inline fsm_result_t fsm_stats_result(fsm_stats_t* stats, fsm_result_t result) {
+	if (stats) {
+		stats->results[result]++;
+	}
+	return result;
+}
+
+#define FSM_STATS_LOCAL(stats)                            fsm_stats_t* stats = fsm_stats_thread
+#define FSM_STATS_GUARD(stats, guard, self, data)         fsm_stats_guard(stats, guard, self, data)
+#define FSM_STATS_ACTION(stats, kind, action, self, data) fsm_stats_action(stats, kind, action, self, data)
+#define FSM_STATS_RULE(stats, def, rule, denied)          fsm_stats_rule(stats, def, rule, denied)
+#define FSM_STATS_LEAVE(stats, self)                      fsm_stats_leave(stats, self)
+#define FSM_STATS_RESULT(stats, result)                   fsm_stats_result(stats, result)
+#else
+// Compiled out: hooks expand to the bare calls and the stats argument is never evaluated.
+#define FSM_STATS_LOCAL(stats)                            ((void)0)
+#define FSM_STATS_GUARD(stats, guard, self, data)         (guard)(self, data)
+#define FSM_STATS_ACTION(stats, kind, action, self, data) (action)(self, data)
+#define FSM_STATS_RULE(stats, def, rule, denied)          ((void)0)
+#define FSM_STATS_LEAVE(stats, self)                      ((void)0)
+#define FSM_STATS_RESULT(stats, result)                   (result)
+#endif
+
+fsm_result_t fsm_def_init(fsm_def_t* def, const fsm_transition_t* transition_rules, size_t transition_count) {
+	if (!def || !transition_rules || transition_count == 0 || transition_count >= FSM_INDEX_NONE) {
 		return FSM_RESULT_INVALID_PARAMS;
 	}
 	for (size_t i = 0; i < transition_count; i++) {
@@ -39,41 +189,536 @@ fsm_result_t fsm_init(fsm_t* self, uint8_t initial_state, const fsm_transition_t
 		}
 	}
 
-	self->cleanup          = NULL;
-	self->transition_rules = transition_rules;
-	self->transition_count = transition_count;
-	self->current_state    = initial_state;
+	def->transition_rules = transition_rules;
+	def->transition_count = transition_count;
+	def->dispatch_index   = NULL;
+	def->chain_next       = NULL;
+	def->next_table       = NULL;
+	def->states           = NULL;
+	def->parents          = NULL;
+	def->paths            = NULL;
+	def->path_actions     = NULL;
+	def->observer         = NULL;
+	def->observer_context = NULL;
+	def->event_count      = 0;
+	def->state_count      = 0;
 	return FSM_RESULT_SUCCESS;
 }
 
-fsm_result_t fsm_process_event(fsm_t* self, uint8_t event, void* data) {
-	assert(self);
-	assert(self->transition_rules);
-	for (size_t i = 0; i < self->transition_count; i++) {
-		const fsm_transition_t* rule = &self->transition_rules[i];
-		if (rule->event == event && FSM_STATE_IN_MASK(self->current_state, rule->source_states_mask)) {
-			if (rule->guard && rule->guard(self, data) != 0) {
-				return FSM_RESULT_GUARD_DENIED;
+fsm_result_t fsm_def_compile(fsm_def_t* def, uint16_t* index, size_t index_size, uint16_t state_count,
+							 uint16_t event_count) {
+	if (!def || !def->transition_rules || !index) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (state_count == 0 || state_count > FSM_MAX_STATES || event_count == 0 || event_count > FSM_MAX_EVENTS) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (index_size < FSM_INDEX_SIZE(state_count, event_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->target_state >= state_count || rule->event >= event_count) {
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+
+	for (size_t i = 0; i < FSM_INDEX_SIZE(state_count, event_count); i++) {
+		index[i] = FSM_INDEX_NONE;
+	}
+	// Only the first matching rule claims a slot, which keeps the first-match-wins order of the scan.
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		for (uint16_t state = 0; state < state_count; state++) {
+			uint16_t* slot = &index[(size_t)state * event_count + rule->event];
+			if (*slot == FSM_INDEX_NONE && FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+				*slot = (uint16_t)i;
 			}
-			if (self->cleanup) {
-				self->cleanup(self, data);
+		}
+	}
+
+	def->dispatch_index = index;
+	def->event_count    = event_count;
+	def->state_count    = state_count;
+	return FSM_RESULT_SUCCESS;
+}
+
+static int fsm_states_have_actions(const fsm_state_desc_t* states, size_t state_count) {
+	for (size_t i = 0; states && i < state_count; i++) {
+		if (states[i].on_entry || states[i].on_exit) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+fsm_result_t fsm_def_compile_next_table(fsm_def_t* def, fsm_state_t* table, size_t table_size) {
+	if (!def || !def->dispatch_index || !table) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (table_size < FSM_NEXT_TABLE_SIZE(def->state_count, def->event_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->guard || rule->on_entry || rule->on_exit) {
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+	if (fsm_states_have_actions(def->states, def->state_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	for (uint16_t state = 0; state < def->state_count; state++) {
+		for (uint16_t event = 0; event < def->event_count; event++) {
+			size_t   slot = (size_t)state * def->event_count + event;
+			uint16_t i    = def->dispatch_index[slot];
+			table[slot]   = i == FSM_INDEX_NONE ? (fsm_state_t)state : def->transition_rules[i].target_state;
+		}
+	}
+	for (size_t i = FSM_INDEX_SIZE(def->state_count, def->event_count);
+		 i < FSM_NEXT_TABLE_SIZE(def->state_count, def->event_count); i++) {
+		table[i] = 0;
+	}
+
+	def->next_table = table;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_def_set_fallthrough(fsm_def_t* def, uint16_t* chain, size_t chain_size) {
+	if (!def || !def->dispatch_index || !chain) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (chain_size < FSM_CHAIN_SIZE(def->state_count, def->transition_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	// Walking the rules backwards, the last rule seen for an event is the next candidate of the current one.
+	uint16_t next[FSM_MAX_EVENTS];
+	for (uint16_t state = 0; state < def->state_count; state++) {
+		for (uint16_t event = 0; event < def->event_count; event++) {
+			next[event] = FSM_INDEX_NONE;
+		}
+		for (size_t i = def->transition_count; i-- > 0;) {
+			const fsm_transition_t* rule = &def->transition_rules[i];
+			uint16_t*               slot = &chain[(size_t)state * def->transition_count + i];
+			*slot                        = FSM_INDEX_NONE;
+			if (FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+				*slot             = next[rule->event];
+				next[rule->event] = (uint16_t)i;
 			}
-			self->cleanup       = rule->on_entry;
-			self->current_state = rule->target_state;
-			if (rule->on_entry) {
-				rule->on_entry(self, data);
+		}
+	}
+
+	def->chain_next = chain;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_def_set_states(fsm_def_t* def, const fsm_state_desc_t* states, size_t state_count) {
+	if (!def || !def->dispatch_index || !states || state_count < def->state_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (def->next_table && fsm_states_have_actions(states, def->state_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	// Hierarchy paths hold the state actions resolved at the time they were built.
+	if (def->paths) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	def->states = states;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_def_set_observer(fsm_def_t* def, fsm_observer_t observer, void* context) {
+	if (!def) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	def->observer         = observer;
+	def->observer_context = context;
+	return FSM_RESULT_SUCCESS;
+}
+
+// Feeds the little-endian bytes of value into an FNV-1a hash.
+static uint64_t fsm_hash_feed(uint64_t hash, uint64_t value, size_t bytes) {
+	for (size_t i = 0; i < bytes; i++) {
+		hash ^= (value >> (8 * i)) & 0xFF;
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+uint64_t fsm_def_hash(const fsm_def_t* def) {
+	if (!def || !def->transition_rules) {
+		return 0;
+	}
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	hash          = fsm_hash_feed(hash, def->transition_count, sizeof(uint32_t));
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		hash                         = fsm_hash_feed(hash, rule->event, sizeof(fsm_event_t));
+#ifdef FSM_WIDE
+		for (size_t w = 0; w < FSM_MASK_WORDS; w++) {
+			hash = fsm_hash_feed(hash, rule->source_states_mask[w], sizeof(uint64_t));
+		}
+#else
+		hash = fsm_hash_feed(hash, rule->source_states_mask, sizeof(uint32_t));
+#endif
+		hash = fsm_hash_feed(hash, rule->target_state, sizeof(fsm_state_t));
+	}
+	return hash;
+}
+
+static fsm_state_t fsm_common_ancestor(const fsm_state_t* parents, fsm_state_t a, fsm_state_t b) {
+	for (fsm_state_t x = a; x != FSM_STATE_NONE; x = parents[x]) {
+		for (fsm_state_t y = b; y != FSM_STATE_NONE; y = parents[y]) {
+			if (x == y) {
+				return x;
+			}
+		}
+	}
+	return FSM_STATE_NONE;
+}
+
+fsm_result_t fsm_def_set_hierarchy(fsm_def_t* def, const fsm_state_t* parents, fsm_path_t* paths, size_t path_count,
+								   fsm_action_t* actions, size_t* action_count) {
+	if (!def || !def->dispatch_index || def->next_table || !parents || !paths || !action_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (path_count < FSM_PATH_TABLE_SIZE(def->state_count) || (!actions && *action_count > 0)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	// Walking up from any state must reach the top within state_count steps, otherwise the parents form a cycle.
+	for (uint16_t state = 0; state < def->state_count; state++) {
+		size_t steps = 0;
+		for (fsm_state_t p = parents[state]; p != FSM_STATE_NONE; p = parents[p]) {
+			if (p >= def->state_count || ++steps >= def->state_count) {
+				return FSM_RESULT_INVALID_PARAMS;
+			}
+		}
+	}
+
+	const fsm_state_desc_t* states = def->states;
+	size_t                  used   = 0;
+	for (uint16_t from = 0; from < def->state_count; from++) {
+		for (uint16_t to = 0; to < def->state_count; to++) {
+			fsm_path_t* path = &paths[(size_t)from * def->state_count + to];
+			fsm_state_t lca  = fsm_common_ancestor(parents, (fsm_state_t)from, (fsm_state_t)to);
+			// External transition: a target that is the source or one of its ancestors is exited and re-entered.
+			if (lca == to) {
+				lca = parents[to];
+			}
+			path->offset      = (uint32_t)used;
+			path->exit_count  = 0;
+			path->entry_count = 0;
+			for (fsm_state_t s = (fsm_state_t)from; s != lca; s = parents[s]) {
+				if (states && states[s].on_exit) {
+					if (used < *action_count) {
+						actions[used] = states[s].on_exit;
+					}
+					used++;
+					path->exit_count++;
+				}
+			}
+			// Entry actions run top-down, so collect the chain bottom-up first.
+			fsm_state_t chain[FSM_MAX_STATES];
+			size_t      depth = 0;
+			for (fsm_state_t s = (fsm_state_t)to; s != lca; s = parents[s]) {
+				chain[depth++] = s;
+			}
+			while (depth > 0) {
+				fsm_state_t s = chain[--depth];
+				if (states && states[s].on_entry) {
+					if (used < *action_count) {
+						actions[used] = states[s].on_entry;
+					}
+					used++;
+					path->entry_count++;
+				}
+			}
+		}
+	}
+	if (used > *action_count) {
+		*action_count = used;
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	// Child-first resolution: an empty slot takes the rule of the nearest ancestor handling the event.
+	// The index storage was handed over writable to fsm_def_compile().
+	uint16_t* index = (uint16_t*)def->dispatch_index;
+	for (uint16_t state = 0; state < def->state_count; state++) {
+		for (uint16_t event = 0; event < def->event_count; event++) {
+			uint16_t* slot = &index[(size_t)state * def->event_count + event];
+			for (fsm_state_t p = parents[state]; *slot == FSM_INDEX_NONE && p != FSM_STATE_NONE; p = parents[p]) {
+				*slot = index[(size_t)p * def->event_count + event];
+			}
+		}
+	}
+
+	def->parents      = parents;
+	def->paths        = paths;
+	def->path_actions = actions;
+	*action_count     = used;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_init(fsm_t* self, const fsm_def_t* def, fsm_state_t initial_state) {
+	if (!self || !def || !def->transition_rules) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (def->dispatch_index && initial_state >= def->state_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	self->userdata      = NULL;
+	self->def           = def;
+	self->current_state = initial_state;
+	self->pending_from  = initial_state;
+	self->pending_rule  = 0;
+	self->pending_step  = 0;
+#ifdef FSM_STATS
+	self->entered_ns = fsm_clock_ns();
+#endif
+	return FSM_RESULT_SUCCESS;
+}
+
+static const fsm_transition_t* fsm_find_rule(const fsm_def_t* def, fsm_state_t state, fsm_event_t event) {
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->event == event && FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+			return rule;
+		}
+	}
+	return NULL;
+}
+
+// Resolves the rule for (state, event), using the dispatch index when the definition is compiled.
+static inline fsm_result_t fsm_lookup(const fsm_def_t* def, fsm_state_t state, fsm_event_t event,
+									  const fsm_transition_t** out_rule) {
+	if (def->dispatch_index) {
+		if (event >= def->event_count) {
+			return FSM_RESULT_EVENT_OUT_OF_BOUNDS;
+		}
+		if (state >= def->state_count) {
+			return FSM_RESULT_STATE_OUT_OF_BOUNDS;
+		}
+		uint16_t i = def->dispatch_index[(size_t)state * def->event_count + event];
+		if (i == FSM_INDEX_NONE) {
+			return FSM_RESULT_NO_TRANSITION_FOR_STATE;
+		}
+		*out_rule = &def->transition_rules[i];
+	} else {
+		*out_rule = fsm_find_rule(def, state, event);
+		if (!*out_rule) {
+			return FSM_RESULT_NO_TRANSITION_FOR_STATE;
+		}
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+// Value of pending_step between fsm_suspend() and the end of the calling action.
+#define FSM_PENDING_REQUESTED 0xFFFF
+
+// Records where a suspended transition continues.
+static fsm_result_t fsm_pend(fsm_t* self, const fsm_def_t* def, const fsm_transition_t* rule, fsm_state_t from,
+							 uint16_t step) {
+	self->pending_from = from;
+	self->pending_rule = (uint16_t)(rule - def->transition_rules);
+	self->pending_step = (uint16_t)(step + 1);
+	return FSM_RESULT_PENDING;
+}
+
+// Only actions can suspend a transition: a request left by a guard or the observer, where no suspension point
+// follows, is dropped so the instance does not stay busy.
+static inline void fsm_drop_suspend(fsm_t* self) {
+	if (self->pending_step == FSM_PENDING_REQUESTED) {
+		self->pending_step = 0;
+	}
+}
+
+// Ends the transition after an action that called fsm_suspend(), to continue at step next.
+#define FSM_SUSPEND_POINT(next)                                                    \
+	do {                                                                           \
+		if (self->pending_step) {                                                  \
+			return FSM_STATS_RESULT(stats, fsm_pend(self, def, rule, from, next)); \
+		}                                                                          \
+	} while (0)
+
+// Runs exit actions, the state change, entry actions and the observer of a rule, starting at step.
+// With E exit actions (1 without a hierarchy), steps [0, E) are the exits, E the rule's on_exit, E + 1 the
+// state change, E + 2 the rule's on_entry and E + 3 on the entries. A transition starts at step 0, which the
+// compiler folds away; fsm_resume() starts where fsm_suspend() stopped it.
+static inline fsm_result_t fsm_run(fsm_t* self, const fsm_def_t* def, const fsm_transition_t* rule,
+								   fsm_state_t from, void* data, uint16_t step) {
+	FSM_STATS_LOCAL(stats);
+	const fsm_state_desc_t* states       = def->states;
+	const fsm_action_t*     path_actions = NULL;
+	fsm_path_t              path         = {0, 1, 1};
+	if (def->paths) {
+		path = def->paths[(size_t)from * def->state_count + rule->target_state];
+		// A hierarchy without state actions has no action list, its paths are all empty.
+		path_actions = path.exit_count || path.entry_count ? &def->path_actions[path.offset] : NULL;
+		for (uint16_t i = step; i < path.exit_count; i++) {
+			FSM_STATS_ACTION(stats, FSM_STATS_EXIT, path_actions[i], self, data);
+			FSM_SUSPEND_POINT(i + 1);
+		}
+	} else if (step == 0 && states && states[from].on_exit) {
+		FSM_STATS_ACTION(stats, FSM_STATS_EXIT, states[from].on_exit, self, data);
+		FSM_SUSPEND_POINT(1);
+	}
+	uint16_t exits = path.exit_count;
+	if (step <= exits && rule->on_exit) {
+		FSM_STATS_ACTION(stats, FSM_STATS_EXIT, rule->on_exit, self, data);
+		FSM_SUSPEND_POINT(exits + 1);
+	}
+	if (step <= exits + 1) {
+		FSM_STATS_RULE(stats, def, rule, 0);
+		FSM_STATS_LEAVE(stats, self);
+		self->current_state = rule->target_state;
+	}
+	if (step <= exits + 2 && rule->on_entry) {
+		FSM_STATS_ACTION(stats, FSM_STATS_ENTRY, rule->on_entry, self, data);
+		FSM_SUSPEND_POINT(exits + 3);
+	}
+	if (def->paths) {
+		for (uint16_t i = step > exits + 3 ? step - exits - 3 : 0; i < path.entry_count; i++) {
+			FSM_STATS_ACTION(stats, FSM_STATS_ENTRY, path_actions[exits + i], self, data);
+			FSM_SUSPEND_POINT(exits + 4 + i);
+		}
+	} else if (step <= exits + 3 && states && states[rule->target_state].on_entry) {
+		FSM_STATS_ACTION(stats, FSM_STATS_ENTRY, states[rule->target_state].on_entry, self, data);
+		FSM_SUSPEND_POINT(exits + 4);
+	}
+	if (def->observer) {
+		def->observer(def->observer_context, self, from, rule->target_state);
+	}
+	fsm_drop_suspend(self);
+	return FSM_STATS_RESULT(stats, FSM_RESULT_SUCCESS);
+}
+
+// Next candidate of a fall-through chain after a denied rule, FSM_INDEX_NONE at the end. An inherited rule
+// continues the chain of the ancestor it belongs to.
+static uint16_t fsm_chain_next(const fsm_def_t* def, fsm_state_t state, const fsm_transition_t* rule) {
+	while (!FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+		state = def->parents[state];
+	}
+	return def->chain_next[(size_t)state * def->transition_count + (size_t)(rule - def->transition_rules)];
+}
+
+// Runs the guard, falling through the chain if enabled, then the whole transition of the selected rule.
+static inline fsm_result_t fsm_fire(fsm_t* self, const fsm_def_t* def, const fsm_transition_t* rule, void* data) {
+	if (rule->guard) {
+		FSM_STATS_LOCAL(stats);
+		while (rule->guard && FSM_STATS_GUARD(stats, rule->guard, self, data) != 0) {
+			FSM_STATS_RULE(stats, def, rule, 1);
+			uint16_t next = def->chain_next ? fsm_chain_next(def, self->current_state, rule) : FSM_INDEX_NONE;
+			if (next == FSM_INDEX_NONE) {
+				fsm_drop_suspend(self);
+				return FSM_STATS_RESULT(stats, FSM_RESULT_GUARD_DENIED);
 			}
-			return FSM_RESULT_SUCCESS;
+			rule = &def->transition_rules[next];
 		}
+		fsm_drop_suspend(self);
 	}
-	return FSM_RESULT_NO_TRANSITION_FOR_STATE;
+	return fsm_run(self, def, rule, self->current_state, data, 0);
 }
 
-uint8_t fsm_current_state(const fsm_t* self) {
+fsm_result_t fsm_process_event(fsm_t* self, fsm_event_t event, void* data) {
+	assert(self);
+	assert(self->def);
+	FSM_TRACE_BEGIN(trace, self);
+	const fsm_transition_t* rule = NULL;
+	fsm_result_t            result =
+		self->pending_step ? FSM_RESULT_BUSY : fsm_lookup(self->def, self->current_state, event, &rule);
+	if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_fire(self, self->def, rule, data);
+	} else {
+		FSM_STATS_LOCAL(stats);
+		result = FSM_STATS_RESULT(stats, result);
+	}
+	FSM_TRACE_END(trace, self, event, result);
+	return result;
+}
+
+fsm_result_t fsm_process_events_batch(fsm_t* const* instances, const fsm_event_t* events, void* const* data,
+									  fsm_result_t* results, size_t count) {
+	if (!instances || !events || !results) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!instances[i] || !instances[i]->def) {
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+
+	FSM_STATS_LOCAL(stats);
+	for (size_t i = 0; i < count; i++) {
+		// Two-stage prefetch: instance headers far ahead, then the index slot of a closer instance,
+		// whose state is expected to be in cache by now.
+		if (i + 2 * FSM_BATCH_PREFETCH_DISTANCE < count) {
+			FSM_PREFETCH(instances[i + 2 * FSM_BATCH_PREFETCH_DISTANCE]);
+		}
+		if (i + FSM_BATCH_PREFETCH_DISTANCE < count) {
+			const fsm_t*     ahead = instances[i + FSM_BATCH_PREFETCH_DISTANCE];
+			const fsm_def_t* def   = ahead->def;
+			fsm_event_t      event = events[i + FSM_BATCH_PREFETCH_DISTANCE];
+			if (def->dispatch_index && ahead->current_state < def->state_count && event < def->event_count) {
+				FSM_PREFETCH(&def->dispatch_index[(size_t)ahead->current_state * def->event_count + event]);
+			}
+		}
+
+		fsm_t*                  self = instances[i];
+		const fsm_transition_t* rule = NULL;
+		FSM_TRACE_BEGIN(trace, self);
+		results[i] = self->pending_step ? FSM_RESULT_BUSY
+										: fsm_lookup(self->def, self->current_state, events[i], &rule);
+		if (results[i] == FSM_RESULT_SUCCESS) {
+			results[i] = fsm_fire(self, self->def, rule, data ? data[i] : NULL);
+		} else {
+			(void)FSM_STATS_RESULT(stats, results[i]);
+		}
+		FSM_TRACE_END(trace, self, events[i], results[i]);
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+void fsm_suspend(fsm_t* self) {
+	assert(self);
+	self->pending_step = FSM_PENDING_REQUESTED;
+}
+
+fsm_result_t fsm_resume(fsm_t* self, void* data) {
+	if (!self || !self->def || !self->pending_step || self->pending_step == FSM_PENDING_REQUESTED) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	const fsm_def_t* def  = self->def;
+	uint16_t         step = (uint16_t)(self->pending_step - 1);
+	self->pending_step    = 0;
+	return fsm_run(self, def, &def->transition_rules[self->pending_rule], self->pending_from, data, step);
+}
+
+int fsm_is_pending(const fsm_t* self) {
+	assert(self);
+	return self->pending_step != 0;
+}
+
+fsm_state_t fsm_current_state(const fsm_t* self) {
 	assert(self);
 	return self->current_state;
 }
 
+int fsm_in_state(const fsm_t* self, fsm_state_t state) {
+	assert(self);
+	const fsm_def_t* def = self->def;
+	for (fsm_state_t s = self->current_state; s != FSM_STATE_NONE;
+		 s = def->parents && s < def->state_count ? def->parents[s] : FSM_STATE_NONE) {
+		if (s == state) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
 void* fsm_userdata(const fsm_t* self) {
 	assert(self);
 	return self->userdata;
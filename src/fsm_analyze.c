@@ -0,0 +1,343 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_analyze.h"
+
+#include <string.h>
+
+// Dimensions a definition is analyzed with: those of its index, or the extent of its rules.
+static void fsm_analyze_dimensions(const fsm_def_t* def, uint16_t* state_count, uint16_t* event_count) {
+	if (def->dispatch_index) {
+		*state_count = def->state_count;
+		*event_count = def->event_count;
+		return;
+	}
+	*state_count = 0;
+	*event_count = 0;
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->target_state >= *state_count) {
+			*state_count = (uint16_t)(rule->target_state + 1);
+		}
+		if (rule->event >= *event_count) {
+			*event_count = (uint16_t)(rule->event + 1);
+		}
+		for (uint16_t state = *state_count; state < FSM_MAX_STATES; state++) {
+			if (FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+				*state_count = (uint16_t)(state + 1);
+			}
+		}
+	}
+}
+
+// Index of the rule dispatch selects for a (state, event) pair, or transition_count if none.
+static size_t fsm_analyze_rule_for(const fsm_def_t* def, uint16_t event_count, uint16_t state, uint16_t event) {
+	if (def->dispatch_index) {
+		uint16_t i = def->dispatch_index[(size_t)state * event_count + event];
+		return i == FSM_INDEX_NONE ? def->transition_count : i;
+	}
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->event == event && FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+			return i;
+		}
+	}
+	return def->transition_count;
+}
+
+// Rule dispatch tries for a (state, event) pair after rule i denied: the next candidate of a fall-through
+// chain, or transition_count when chains are off or rule i has no guard.
+static size_t fsm_analyze_next(const fsm_def_t* def, uint16_t state, size_t i) {
+	const fsm_transition_t* rule = &def->transition_rules[i];
+	if (!def->chain_next || !rule->guard) {
+		return def->transition_count;
+	}
+	fsm_state_t owner = (fsm_state_t)state;
+	while (!FSM_STATE_IN_MASK(owner, rule->source_states_mask)) {
+		owner = def->parents[owner];
+	}
+	uint16_t next = def->chain_next[(size_t)owner * def->transition_count + i];
+	return next == FSM_INDEX_NONE ? def->transition_count : next;
+}
+
+// Whether dispatch selects rule i for a (state, event) pair when the guards before it deny.
+static int fsm_analyze_selects(const fsm_def_t* def, uint16_t event_count, uint16_t state, uint16_t event,
+							   size_t i) {
+	for (size_t j = fsm_analyze_rule_for(def, event_count, state, event); j != def->transition_count;
+		 j = fsm_analyze_next(def, state, j)) {
+		if (j == i) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+fsm_result_t fsm_def_analyze(const fsm_def_t* def, fsm_state_t initial_state, fsm_analysis_t* analysis,
+							 uint8_t* rule_flags) {
+	if (!def || !def->transition_rules || !analysis) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	uint16_t state_count, event_count;
+	fsm_analyze_dimensions(def, &state_count, &event_count);
+	if (initial_state >= state_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	memset(analysis, 0, sizeof(*analysis));
+	analysis->state_count = state_count;
+	analysis->event_count = event_count;
+
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule  = &def->transition_rules[i];
+		uint8_t                 flags = 0;
+		size_t                  own   = 0;
+		size_t                  won   = 0;
+		if (rule->target_state >= state_count || rule->event >= event_count) {
+			flags |= FSM_RULE_OUT_OF_RANGE;
+		}
+		for (uint16_t state = 0; state < FSM_MAX_STATES; state++) {
+			if (!FSM_STATE_IN_MASK(state, rule->source_states_mask)) {
+				continue;
+			}
+			if (state >= state_count) {
+				flags |= FSM_RULE_OUT_OF_RANGE;
+				continue;
+			}
+			own++;
+			if (rule->event < event_count && fsm_analyze_selects(def, event_count, state, rule->event, i)) {
+				won++;
+			}
+		}
+		if (own == 0) {
+			flags |= FSM_RULE_NO_SOURCE;
+		} else if (won == 0) {
+			flags |= FSM_RULE_SHADOWED;
+		} else if (won < own) {
+			flags |= FSM_RULE_PARTIALLY_SHADOWED;
+		}
+
+		analysis->shadowed_rules += (flags & (FSM_RULE_SHADOWED | FSM_RULE_NO_SOURCE)) != 0;
+		analysis->partially_shadowed_rules += (flags & FSM_RULE_PARTIALLY_SHADOWED) != 0;
+		analysis->out_of_range_rules += (flags & FSM_RULE_OUT_OF_RANGE) != 0;
+		if (rule_flags) {
+			rule_flags[i] = flags;
+		}
+	}
+
+	// Coverage and exits, then a breadth-first walk over every transition a passing guard would allow.
+	uint8_t     leaves[FSM_MAX_STATES]  = {0};
+	uint8_t     reached[FSM_MAX_STATES] = {0};
+	fsm_state_t queue[FSM_MAX_STATES];
+	for (uint16_t state = 0; state < state_count; state++) {
+		for (uint16_t event = 0; event < event_count; event++) {
+			size_t i = fsm_analyze_rule_for(def, event_count, state, event);
+			if (i == def->transition_count) {
+				continue;
+			}
+			analysis->handled_pairs++;
+			analysis->state_coverage[state]++;
+			analysis->event_coverage[event]++;
+			for (; i != def->transition_count; i = fsm_analyze_next(def, state, i)) {
+				if (def->transition_rules[i].target_state != state) {
+					leaves[state] = 1;
+				}
+			}
+		}
+	}
+	size_t head            = 0;
+	size_t tail            = 0;
+	reached[initial_state] = 1;
+	queue[tail++]          = initial_state;
+	while (head < tail) {
+		fsm_state_t state = queue[head++];
+		for (uint16_t event = 0; event < event_count; event++) {
+			for (size_t i = fsm_analyze_rule_for(def, event_count, state, event); i != def->transition_count;
+				 i = fsm_analyze_next(def, state, i)) {
+				fsm_state_t target = def->transition_rules[i].target_state;
+				if (target < state_count && !reached[target]) {
+					reached[target] = 1;
+					queue[tail++]   = target;
+				}
+			}
+		}
+	}
+
+	for (uint16_t state = 0; state < state_count; state++) {
+		if (!reached[state]) {
+			analysis->state_flags[state] |= FSM_STATE_UNREACHABLE;
+			analysis->unreachable_states++;
+		}
+		if (!leaves[state]) {
+			analysis->state_flags[state] |= FSM_STATE_DEAD_END;
+			analysis->dead_end_states++;
+		}
+	}
+	for (uint16_t event = 0; event < event_count; event++) {
+		analysis->unhandled_events += analysis->event_coverage[event] == 0;
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+static size_t fsm_mask_count(const fsm_transition_t* rule, uint16_t state_count) {
+	size_t count = 0;
+	for (uint16_t state = 0; state < state_count; state++) {
+		count += FSM_STATE_IN_MASK(state, rule->source_states_mask);
+	}
+	return count;
+}
+
+static void fsm_mask_add(fsm_transition_t* rule, uint16_t state) {
+#ifdef FSM_WIDE
+	rule->source_states_mask[state / 64] |= 1ULL << (state % 64);
+#else
+	rule->source_states_mask |= FSM_STATE_MASK(state);
+#endif
+}
+
+fsm_result_t fsm_def_optimize(const fsm_def_t* def, fsm_transition_t* rules, size_t* origins, size_t capacity,
+							  size_t* rule_count) {
+	if (!def || !def->transition_rules || !rules || !rule_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	uint16_t state_count, event_count;
+	fsm_analyze_dimensions(def, &state_count, &event_count);
+
+	// Walking events in order groups the output by event while keeping the original order within a group.
+	size_t count = 0;
+	for (uint16_t event = 0; event < event_count; event++) {
+		size_t group = count;
+		for (size_t i = 0; i < def->transition_count; i++) {
+			const fsm_transition_t* rule = &def->transition_rules[i];
+			if (rule->event != event || rule->target_state >= state_count) {
+				continue;
+			}
+			fsm_transition_t reduced = *rule;
+			memset(&reduced.source_states_mask, 0, sizeof(reduced.source_states_mask));
+			for (uint16_t state = 0; state < state_count; state++) {
+				if (FSM_STATE_IN_MASK(state, rule->source_states_mask) &&
+					fsm_analyze_selects(def, event_count, state, event, i)) {
+					fsm_mask_add(&reduced, state);
+				}
+			}
+			if (fsm_mask_count(&reduced, state_count) == 0) {
+				continue;
+			}
+			if (count < capacity) {
+				rules[count] = reduced;
+				if (origins) {
+					origins[count] = i;
+				}
+			}
+			count++;
+		}
+
+		// The rules of a group are disjoint now, so put the widest first for a linear scan. Fall-through chains
+		// overlap on purpose and keep their order.
+		for (size_t i = group + 1; i < count && count <= capacity && !def->chain_next; i++) {
+			fsm_transition_t rule   = rules[i];
+			size_t           origin = origins ? origins[i] : 0;
+			size_t           width  = fsm_mask_count(&rule, state_count);
+			size_t           j      = i;
+			for (; j > group && fsm_mask_count(&rules[j - 1], state_count) < width; j--) {
+				rules[j] = rules[j - 1];
+				if (origins) {
+					origins[j] = origins[j - 1];
+				}
+			}
+			rules[j] = rule;
+			if (origins) {
+				origins[j] = origin;
+			}
+		}
+	}
+
+	*rule_count = count;
+	return count <= capacity ? FSM_RESULT_SUCCESS : FSM_RESULT_INVALID_PARAMS;
+}
+
+// Whether the profiled rule a goes before rule b: guarded rules first, by hits, ties in table order.
+static int fsm_reorder_before(const fsm_def_t* def, const uint64_t* hits, size_t a, size_t b) {
+	int a_guarded = def->transition_rules[a].guard != NULL;
+	int b_guarded = def->transition_rules[b].guard != NULL;
+	if (a_guarded != b_guarded) {
+		return a_guarded;
+	}
+	return a_guarded && hits[a] > hits[b];
+}
+
+fsm_result_t fsm_def_reorder(const fsm_def_t* def, const fsm_stats_t* profile, fsm_transition_t* rules,
+							 size_t* origins, size_t capacity, size_t* rule_count) {
+	if (!def || !def->transition_rules || !def->chain_next || !rules || !origins || !rule_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (!profile || profile->def != def || !profile->rule_hits) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	uint16_t state_count, event_count;
+	fsm_analyze_dimensions(def, &state_count, &event_count);
+
+	size_t count = 0;
+	for (uint16_t event = 0; event < event_count; event++) {
+		// Each rule keeps the states where it is a candidate: a rule after an unguarded one is never tried.
+		size_t group = count;
+		for (size_t i = 0; i < def->transition_count; i++) {
+			const fsm_transition_t* rule = &def->transition_rules[i];
+			if (rule->event != event || rule->target_state >= state_count) {
+				continue;
+			}
+			fsm_transition_t reduced = *rule;
+			memset(&reduced.source_states_mask, 0, sizeof(reduced.source_states_mask));
+			for (uint16_t state = 0; state < state_count; state++) {
+				if (FSM_STATE_IN_MASK(state, rule->source_states_mask) &&
+					fsm_analyze_selects(def, event_count, state, event, i)) {
+					fsm_mask_add(&reduced, state);
+				}
+			}
+			if (fsm_mask_count(&reduced, state_count) == 0) {
+				continue;
+			}
+			if (count < capacity) {
+				rules[count]   = reduced;
+				origins[count] = i;
+			}
+			count++;
+		}
+
+		// Guarded rules by descending hits, then the unguarded ones, which end their chains and no longer
+		// overlap each other.
+		for (size_t i = group + 1; i < count && count <= capacity; i++) {
+			fsm_transition_t rule   = rules[i];
+			size_t           origin = origins[i];
+			size_t           j      = i;
+			for (; j > group && fsm_reorder_before(def, profile->rule_hits, origin, origins[j - 1]); j--) {
+				rules[j]   = rules[j - 1];
+				origins[j] = origins[j - 1];
+			}
+			rules[j]   = rule;
+			origins[j] = origin;
+		}
+	}
+
+	*rule_count = count;
+	return count <= capacity ? FSM_RESULT_SUCCESS : FSM_RESULT_INVALID_PARAMS;
+}
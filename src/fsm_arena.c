@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_arena.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "fsm_atomic.h"
+
+// Offset of the payload from its envelope.
+#define FSM_ENVELOPE_HEADER ((sizeof(fsm_envelope_t) + FSM_ARENA_ALIGN - 1) & ~(size_t)(FSM_ARENA_ALIGN - 1))
+
+// Each block starts with its release counter, alone on a cache line so releases do not touch payloads.
+#define FSM_ARENA_BLOCK_HEADER FSM_CACHE_LINE_SIZE
+
+static inline size_t* fsm_arena_counter(const fsm_arena_t* arena, size_t block) {
+	return (size_t*)(arena->base + block * arena->block_size);
+}
+
+fsm_result_t fsm_arena_init(fsm_arena_t* arena, void* buffer, size_t size, size_t block_size) {
+	if (!arena || !buffer || block_size <= FSM_ARENA_BLOCK_HEADER || block_size % FSM_CACHE_LINE_SIZE != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	size_t skip = (FSM_CACHE_LINE_SIZE - (uintptr_t)buffer % FSM_CACHE_LINE_SIZE) % FSM_CACHE_LINE_SIZE;
+	if (size < skip || (size - skip) / block_size == 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	arena->base        = (char*)buffer + skip;
+	arena->block_size  = block_size;
+	arena->block_count = (size - skip) / block_size;
+	arena->block       = 0;
+	arena->offset      = FSM_ARENA_BLOCK_HEADER;
+	arena->allocated   = 0;
+	arena->exhausted   = 0;
+	for (size_t i = 0; i < arena->block_count; i++) {
+		*fsm_arena_counter(arena, i) = 0;
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_envelope_t* fsm_arena_alloc(fsm_arena_t* arena, uint32_t type, size_t size) {
+	assert(arena);
+	size_t need = (FSM_ENVELOPE_HEADER + size + FSM_ARENA_ALIGN - 1) & ~(size_t)(FSM_ARENA_ALIGN - 1);
+	if (size > UINT32_MAX || need > arena->block_size - FSM_ARENA_BLOCK_HEADER) {
+		return NULL;
+	}
+
+	if (arena->offset + need > arena->block_size) {
+		// Seal the full block: releases made so far left its counter at minus their number, so adding the
+		// allocation count brings it to zero once every envelope of the block has been released.
+		if (arena->allocated) {
+			FSM_ATOMIC_FETCH_ADD(fsm_arena_counter(arena, arena->block), arena->allocated);
+			arena->allocated = 0;
+			arena->offset    = arena->block_size;
+		}
+		size_t next = (arena->block + 1) % arena->block_count;
+		if (FSM_ATOMIC_LOAD_ACQUIRE(fsm_arena_counter(arena, next)) != 0) {
+			arena->exhausted++;
+			return NULL;
+		}
+		arena->block  = next;
+		arena->offset = FSM_ARENA_BLOCK_HEADER;
+	}
+
+	fsm_envelope_t* envelope = (fsm_envelope_t*)(arena->base + arena->block * arena->block_size + arena->offset);
+	envelope->live           = fsm_arena_counter(arena, arena->block);
+	envelope->type           = type;
+	envelope->size           = (uint32_t)size;
+	arena->offset += need;
+	arena->allocated++;
+	return envelope;
+}
+
+void* fsm_envelope_payload(void* data, uint32_t type) {
+	fsm_envelope_t* envelope = (fsm_envelope_t*)data;
+	if (!envelope || envelope->type != type) {
+		return NULL;
+	}
+	return (char*)envelope + FSM_ENVELOPE_HEADER;
+}
+
+void fsm_envelope_release(fsm_envelope_t* envelope) {
+	if (envelope) {
+		FSM_ATOMIC_FETCH_ADD(envelope->live, (size_t)-1);
+	}
+}
+
+void fsm_envelopes_release(void* const* envelopes, size_t count) {
+	size_t* live = NULL;
+	size_t  run  = 0;
+	for (size_t i = 0; envelopes && i < count; i++) {
+		const fsm_envelope_t* envelope = (const fsm_envelope_t*)envelopes[i];
+		if (!envelope) {
+			continue;
+		}
+		if (envelope->live != live) {
+			if (run) {
+				FSM_ATOMIC_FETCH_ADD(live, 0 - run);
+			}
+			live = envelope->live;
+			run  = 0;
+		}
+		run++;
+	}
+	if (run) {
+		FSM_ATOMIC_FETCH_ADD(live, 0 - run);
+	}
+}
@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_ATOMIC_H
+#define FSM_ATOMIC_H
+
+#include <stddef.h>
+
+// Minimal atomic operations shared by the lock-free modules. The GCC/Clang builtins are type-generic,
+// the MSVC fallbacks operate on size_t words, or pointers for the _PTR variants.
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+#define FSM_ATOMIC_LOAD_RELAXED(ptr)         (*(volatile size_t*)(ptr))
+#define FSM_ATOMIC_STORE_RELAXED(ptr, value) (*(volatile size_t*)(ptr) = (value))
+#define FSM_ATOMIC_LOAD_ACQUIRE(ptr) fsm_atomic_load_acquire(ptr)
+#define FSM_ATOMIC_STORE_RELEASE(ptr, value) \
+	do {                                     \
+		_ReadWriteBarrier();                 \
+		*(volatile size_t*)(ptr) = (value);  \
+	} while (0)
+#define FSM_ATOMIC_CAS(ptr, expected, desired) fsm_atomic_cas(ptr, expected, desired)
+#define FSM_ATOMIC_FETCH_ADD(ptr, value)       fsm_atomic_fetch_add(ptr, value)
+#define FSM_ATOMIC_LOAD_PTR_ACQUIRE(ptr)       fsm_atomic_load_ptr_acquire((void* const*)(ptr))
+#define FSM_ATOMIC_STORE_PTR_RELEASE(ptr, value) \
+	do {                                         \
+		_ReadWriteBarrier();                     \
+		*(void* volatile*)(ptr) = (value);       \
+	} while (0)
+#define FSM_ATOMIC_FENCE() fsm_atomic_fence()
+
+static __inline size_t fsm_atomic_load_acquire(const size_t* ptr) {
+	size_t value = *(const volatile size_t*)ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+static __inline void* fsm_atomic_load_ptr_acquire(void* const* ptr) {
+	void* value = *(void* const volatile*)ptr;
+	_ReadWriteBarrier();
+	return value;
+}
+
+// Interlocked operations are full barriers.
+static __inline void fsm_atomic_fence(void) {
+	long fence = 0;
+	_InterlockedExchange(&fence, 1);
+}
+
+#ifdef _WIN64
+static __inline int fsm_atomic_cas(size_t* ptr, size_t* expected, size_t desired) {
+	size_t prev = (size_t)_InterlockedCompareExchange64((volatile __int64*)ptr, (__int64)desired, (__int64)*expected);
+	if (prev == *expected) {
+		return 1;
+	}
+	*expected = prev;
+	return 0;
+}
+static __inline size_t fsm_atomic_fetch_add(size_t* ptr, size_t value) {
+	return (size_t)_InterlockedExchangeAdd64((volatile __int64*)ptr, (__int64)value);
+}
+#else
+static __inline int fsm_atomic_cas(size_t* ptr, size_t* expected, size_t desired) {
+	size_t prev = (size_t)_InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)*expected);
+	if (prev == *expected) {
+		return 1;
+	}
+	*expected = prev;
+	return 0;
+}
+static __inline size_t fsm_atomic_fetch_add(size_t* ptr, size_t value) {
+	return (size_t)_InterlockedExchangeAdd((volatile long*)ptr, (long)value);
+}
+#endif
+
+#else
+
+#define FSM_ATOMIC_LOAD_RELAXED(ptr)         __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define FSM_ATOMIC_LOAD_ACQUIRE(ptr)         __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define FSM_ATOMIC_STORE_RELAXED(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELAXED)
+#define FSM_ATOMIC_STORE_RELEASE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define FSM_ATOMIC_CAS(ptr, expected, desired) \
+	__atomic_compare_exchange_n(ptr, expected, desired, 1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#define FSM_ATOMIC_FETCH_ADD(ptr, value)         __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL)
+#define FSM_ATOMIC_LOAD_PTR_ACQUIRE(ptr)         __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define FSM_ATOMIC_STORE_PTR_RELEASE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define FSM_ATOMIC_FENCE()                       __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif
+
+#endif  // FSM_ATOMIC_H
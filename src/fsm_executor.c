@@ -0,0 +1,347 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_executor.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "fsm_atomic.h"
+#include "fsm_clock.h"
+
+// Maximum number of events a worker processes from one shard before looking at other shards.
+#define FSM_EXECUTOR_SHARD_BUDGET 256
+
+// Number of empty polling rounds a worker yields before it starts sleeping.
+#define FSM_EXECUTOR_SPIN_ROUNDS 64
+
+// Sleep of an idle worker between polling rounds, in nanoseconds.
+#define FSM_EXECUTOR_IDLE_SLEEP_NS 50000
+
+typedef struct fsm_executor_entry {
+	size_t      sequence;     // Slot sequence number, same protocol as fsm_queue_t.
+	size_t      instance_id;  // Target instance.
+	void*       data;         // Event data.
+	uint64_t    posted_ns;    // Time the event was posted, for latency accounting.
+	fsm_event_t event;        // Event ID.
+	uint8_t     owned;        // Non-zero if data is an envelope released after dispatch.
+} fsm_executor_entry_t;
+
+typedef struct fsm_executor_shard {
+	fsm_executor_entry_t* entries;  // Bounded MPSC ring of posted events.
+	size_t                mask;     // Capacity - 1.
+	size_t                home;     // Worker that drains this shard by default.
+	char                  _pad0[FSM_CACHE_LINE_SIZE];
+	size_t                tail;  // Next position claimed by producers.
+	char                  _pad1[FSM_CACHE_LINE_SIZE];
+	size_t                head;   // Next position read by the current owner.
+	size_t                owner;  // Non-zero while a worker drains the shard.
+	char                  _pad2[FSM_CACHE_LINE_SIZE];
+} fsm_executor_shard_t;
+
+typedef struct fsm_executor_worker {
+	fsm_executor_t* executor;
+	pthread_t       thread;
+	size_t          index;
+	// Counters below are written only by the worker itself and read with relaxed loads.
+	uint64_t processed;
+	uint64_t steals;
+	uint64_t latency_total_ns;
+	uint64_t latency_max_ns;
+	uint64_t latency_histogram[FSM_EXECUTOR_LATENCY_BUCKETS];
+	char     _pad[FSM_CACHE_LINE_SIZE];
+} fsm_executor_worker_t;
+
+struct fsm_executor {
+	fsm_t*                 instances;
+	size_t                 instance_count;
+	fsm_executor_shard_t*  shards;
+	size_t                 shard_count;
+	fsm_executor_worker_t* workers;
+	size_t                 worker_count;
+	fsm_executor_entry_t*  entries;
+	fsm_versions_t*        versions;
+	uint64_t               created_ns;
+	size_t                 stopping;
+	uint64_t               posted;
+	uint64_t               rejected;
+};
+
+static inline size_t fsm_executor_bucket(uint64_t ns) {
+	size_t bucket = 0;
+	while (bucket + 1 < FSM_EXECUTOR_LATENCY_BUCKETS && ns >= ((uint64_t)1 << bucket)) {
+		bucket++;
+	}
+	return bucket;
+}
+
+// Drains up to a budget of events from a shard if no other worker owns it. Returns the number processed.
+static size_t fsm_executor_run_shard(fsm_executor_t* self, fsm_executor_worker_t* worker, fsm_executor_shard_t* shard) {
+	size_t expected = 0;
+	if (FSM_ATOMIC_LOAD_RELAXED(&shard->owner) != 0 || !FSM_ATOMIC_CAS(&shard->owner, &expected, 1)) {
+		return 0;
+	}
+
+	size_t processed = 0;
+	while (processed < FSM_EXECUTOR_SHARD_BUDGET) {
+		size_t                pos   = shard->head;
+		fsm_executor_entry_t* entry = &shard->entries[pos & shard->mask];
+		if (FSM_ATOMIC_LOAD_ACQUIRE(&entry->sequence) != pos + 1) {
+			break;
+		}
+		size_t      instance_id = entry->instance_id;
+		void*       data        = entry->data;
+		uint64_t    posted_ns   = entry->posted_ns;
+		fsm_event_t event       = entry->event;
+		uint8_t     owned       = entry->owned;
+		FSM_ATOMIC_STORE_RELEASE(&entry->sequence, pos + shard->mask + 1);
+		shard->head = pos + 1;
+
+		if (self->versions) {
+			fsm_versions_process(self->versions, &self->instances[instance_id], event, data);
+		} else {
+			fsm_process_event(&self->instances[instance_id], event, data);
+		}
+		if (owned) {
+			fsm_envelope_release((fsm_envelope_t*)data);
+		}
+
+		uint64_t latency = fsm_clock_ns() - posted_ns;
+		size_t   bucket  = fsm_executor_bucket(latency);
+		FSM_ATOMIC_STORE_RELAXED(&worker->latency_total_ns, worker->latency_total_ns + latency);
+		if (latency > worker->latency_max_ns) {
+			FSM_ATOMIC_STORE_RELAXED(&worker->latency_max_ns, latency);
+		}
+		FSM_ATOMIC_STORE_RELAXED(&worker->latency_histogram[bucket], worker->latency_histogram[bucket] + 1);
+		processed++;
+	}
+	if (processed) {
+		if (shard->home != worker->index) {
+			FSM_ATOMIC_STORE_RELAXED(&worker->steals, worker->steals + 1);
+		}
+		// Release ordering makes the processed events visible to fsm_executor_wait_idle().
+		FSM_ATOMIC_STORE_RELEASE(&worker->processed, worker->processed + processed);
+	}
+	FSM_ATOMIC_STORE_RELEASE(&shard->owner, 0);
+	return processed;
+}
+
+static void* fsm_executor_worker_main(void* arg) {
+	fsm_executor_worker_t* worker = (fsm_executor_worker_t*)arg;
+	fsm_executor_t*        self   = worker->executor;
+	size_t                 victim = worker->index;
+	size_t                 idle   = 0;
+
+	for (;;) {
+		size_t stopping = FSM_ATOMIC_LOAD_ACQUIRE(&self->stopping);
+		size_t done     = 0;
+		for (size_t i = worker->index; i < self->shard_count; i += self->worker_count) {
+			done += fsm_executor_run_shard(self, worker, &self->shards[i]);
+		}
+		// Nothing at home: try the other shards, starting where the last search stopped.
+		for (size_t n = 0; done == 0 && n < self->shard_count; n++) {
+			victim = (victim + 1) % self->shard_count;
+			if (self->shards[victim].home != worker->index) {
+				done += fsm_executor_run_shard(self, worker, &self->shards[victim]);
+			}
+		}
+		// No version is held between shard runs.
+		if (self->versions) {
+			fsm_versions_quiescent(self->versions, worker->index);
+		}
+
+		if (done) {
+			idle = 0;
+		} else if (stopping) {
+			break;
+		} else if (++idle < FSM_EXECUTOR_SPIN_ROUNDS) {
+			sched_yield();
+		} else {
+			struct timespec pause = {0, FSM_EXECUTOR_IDLE_SLEEP_NS};
+			nanosleep(&pause, NULL);
+		}
+	}
+	if (self->versions) {
+		fsm_versions_offline(self->versions, worker->index);
+	}
+	return NULL;
+}
+
+fsm_result_t fsm_executor_create(fsm_executor_t** out, fsm_t* instances, size_t instance_count,
+								 const fsm_executor_config_t* config) {
+	if (!out || !instances || instance_count == 0 || !config || config->thread_count == 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	size_t capacity = config->queue_capacity ? config->queue_capacity : 1024;
+	size_t shards   = config->shard_count ? config->shard_count : config->thread_count * 4;
+	if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (config->versions && config->versions->reader_count < config->thread_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	fsm_executor_t* self = (fsm_executor_t*)calloc(1, sizeof(fsm_executor_t));
+	if (!self) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	self->instances      = instances;
+	self->instance_count = instance_count;
+	self->shard_count    = shards;
+	self->worker_count   = config->thread_count;
+	self->versions       = config->versions;
+	self->shards         = (fsm_executor_shard_t*)calloc(shards, sizeof(fsm_executor_shard_t));
+	self->workers        = (fsm_executor_worker_t*)calloc(config->thread_count, sizeof(fsm_executor_worker_t));
+	self->entries        = (fsm_executor_entry_t*)calloc(shards * capacity, sizeof(fsm_executor_entry_t));
+	if (!self->shards || !self->workers || !self->entries) {
+		free(self->shards);
+		free(self->workers);
+		free(self->entries);
+		free(self);
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	for (size_t i = 0; i < shards; i++) {
+		fsm_executor_shard_t* shard = &self->shards[i];
+		shard->entries              = &self->entries[i * capacity];
+		shard->mask                 = capacity - 1;
+		shard->home                 = i % config->thread_count;
+		for (size_t j = 0; j < capacity; j++) {
+			shard->entries[j].sequence = j;
+		}
+	}
+	self->created_ns = fsm_clock_ns();
+
+	for (size_t i = 0; i < config->thread_count; i++) {
+		fsm_executor_worker_t* worker = &self->workers[i];
+		worker->executor              = self;
+		worker->index                 = i;
+		if (pthread_create(&worker->thread, NULL, fsm_executor_worker_main, worker) != 0) {
+			// Stop the workers already running, then release everything.
+			self->worker_count = i;
+			fsm_executor_destroy(self);
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+
+	*out = self;
+	return FSM_RESULT_SUCCESS;
+}
+
+static fsm_result_t fsm_executor_push(fsm_executor_t* self, size_t instance_id, fsm_event_t event, void* data,
+									  uint8_t owned) {
+	if (instance_id >= self->instance_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_executor_shard_t* shard = &self->shards[instance_id % self->shard_count];
+	size_t                pos   = FSM_ATOMIC_LOAD_RELAXED(&shard->tail);
+	fsm_executor_entry_t* entry;
+	for (;;) {
+		entry        = &shard->entries[pos & shard->mask];
+		size_t   seq = FSM_ATOMIC_LOAD_ACQUIRE(&entry->sequence);
+		intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+		if (dif == 0) {
+			if (FSM_ATOMIC_CAS(&shard->tail, &pos, pos + 1)) {
+				break;
+			}
+		} else if (dif < 0) {
+			FSM_ATOMIC_FETCH_ADD(&self->rejected, 1);
+			return FSM_RESULT_QUEUE_FULL;
+		} else {
+			pos = FSM_ATOMIC_LOAD_RELAXED(&shard->tail);
+		}
+	}
+	entry->instance_id = instance_id;
+	entry->data        = data;
+	entry->posted_ns   = fsm_clock_ns();
+	entry->event       = event;
+	entry->owned       = owned;
+	FSM_ATOMIC_FETCH_ADD(&self->posted, 1);
+	FSM_ATOMIC_STORE_RELEASE(&entry->sequence, pos + 1);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_executor_post(fsm_executor_t* self, size_t instance_id, fsm_event_t event, void* data) {
+	assert(self);
+	return fsm_executor_push(self, instance_id, event, data, 0);
+}
+
+fsm_result_t fsm_executor_post_envelope(fsm_executor_t* self, size_t instance_id, fsm_event_t event,
+										fsm_envelope_t* envelope) {
+	assert(self);
+	return fsm_executor_push(self, instance_id, event, envelope, envelope != NULL);
+}
+
+static uint64_t fsm_executor_processed(const fsm_executor_t* self) {
+	uint64_t processed = 0;
+	for (size_t i = 0; i < self->worker_count; i++) {
+		processed += FSM_ATOMIC_LOAD_ACQUIRE(&self->workers[i].processed);
+	}
+	return processed;
+}
+
+void fsm_executor_wait_idle(fsm_executor_t* self) {
+	assert(self);
+	while (fsm_executor_processed(self) < FSM_ATOMIC_LOAD_ACQUIRE(&self->posted)) {
+		sched_yield();
+	}
+}
+
+void fsm_executor_stats(const fsm_executor_t* self, fsm_executor_stats_t* stats) {
+	assert(self);
+	assert(stats);
+	*stats                  = (fsm_executor_stats_t){0};
+	stats->events_posted    = FSM_ATOMIC_LOAD_RELAXED(&self->posted);
+	stats->events_rejected  = FSM_ATOMIC_LOAD_RELAXED(&self->rejected);
+	stats->events_processed = fsm_executor_processed(self);
+	stats->elapsed_ns       = fsm_clock_ns() - self->created_ns;
+	for (size_t i = 0; i < self->worker_count; i++) {
+		const fsm_executor_worker_t* worker = &self->workers[i];
+		uint64_t                     max    = FSM_ATOMIC_LOAD_RELAXED(&worker->latency_max_ns);
+		stats->steals += FSM_ATOMIC_LOAD_RELAXED(&worker->steals);
+		stats->latency_total_ns += FSM_ATOMIC_LOAD_RELAXED(&worker->latency_total_ns);
+		if (max > stats->latency_max_ns) {
+			stats->latency_max_ns = max;
+		}
+		for (size_t b = 0; b < FSM_EXECUTOR_LATENCY_BUCKETS; b++) {
+			stats->latency_histogram[b] += FSM_ATOMIC_LOAD_RELAXED(&worker->latency_histogram[b]);
+		}
+	}
+}
+
+void fsm_executor_destroy(fsm_executor_t* self) {
+	if (!self) {
+		return;
+	}
+	FSM_ATOMIC_STORE_RELEASE(&self->stopping, 1);
+	for (size_t i = 0; i < self->worker_count; i++) {
+		pthread_join(self->workers[i].thread, NULL);
+	}
+	free(self->entries);
+	free(self->workers);
+	free(self->shards);
+	free(self);
+}
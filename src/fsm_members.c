@@ -0,0 +1,190 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_members.h"
+
+#include <assert.h>
+
+static void fsm_members_link(fsm_members_t* members, uint32_t id, fsm_state_t state) {
+	fsm_member_node_t* node = &members->nodes[id];
+	uint32_t*          head = &members->heads[state];
+
+	node->prev  = FSM_MEMBERS_NONE;
+	node->next  = *head;
+	node->state = state;
+	if (*head != FSM_MEMBERS_NONE) {
+		members->nodes[*head].prev = id;
+	}
+	*head = id;
+	members->sizes[state]++;
+}
+
+static void fsm_members_unlink(fsm_members_t* members, fsm_member_node_t* node) {
+	if (node->prev != FSM_MEMBERS_NONE) {
+		members->nodes[node->prev].next = node->next;
+	} else {
+		members->heads[node->state] = node->next;
+	}
+	if (node->next != FSM_MEMBERS_NONE) {
+		members->nodes[node->next].prev = node->prev;
+	}
+	members->sizes[node->state]--;
+	node->state = FSM_STATE_NONE;
+}
+
+static void fsm_members_observe(void* context, fsm_t* fsm, fsm_state_t from, fsm_state_t to) {
+	fsm_members_t* members = (fsm_members_t*)context;
+	uintptr_t      first   = (uintptr_t)members->instances;
+	uintptr_t      self    = (uintptr_t)fsm;
+	if (self >= first && self < (uintptr_t)(members->instances + members->count)) {
+		uint32_t           id   = (uint32_t)(fsm - members->instances);
+		fsm_member_node_t* node = &members->nodes[id];
+		// Instances left out of the index stay out, self-transitions keep their place.
+		if (node->state != FSM_STATE_NONE && node->state != to && to < FSM_MAX_STATES) {
+			fsm_members_unlink(members, node);
+			fsm_members_link(members, id, to);
+		}
+	}
+	if (members->next_observer) {
+		members->next_observer(members->next_context, fsm, from, to);
+	}
+}
+
+fsm_result_t fsm_members_init(fsm_members_t* members, fsm_def_t* def, fsm_t* instances, fsm_member_node_t* nodes,
+							  size_t count) {
+	if (!members || !def || !instances || !nodes || count == 0 || count >= FSM_MEMBERS_NONE) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!instances[i].def) {
+			continue;
+		}
+		if (instances[i].def != def || instances[i].current_state >= FSM_MAX_STATES) {
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+
+	members->def           = def;
+	members->instances     = instances;
+	members->nodes         = nodes;
+	members->count         = count;
+	members->epoch         = 0;
+	members->next_observer = def->observer;
+	members->next_context  = def->observer_context;
+	for (size_t state = 0; state < FSM_MAX_STATES; state++) {
+		members->heads[state] = FSM_MEMBERS_NONE;
+		members->sizes[state] = 0;
+	}
+	// Filed in reverse so a state's list starts in array order.
+	for (size_t i = count; i-- > 0;) {
+		nodes[i].epoch = 0;
+		nodes[i].state = FSM_STATE_NONE;
+		if (instances[i].def) {
+			fsm_members_link(members, (uint32_t)i, instances[i].current_state);
+		}
+	}
+	return fsm_def_set_observer(def, fsm_members_observe, members);
+}
+
+fsm_result_t fsm_members_deinit(fsm_members_t* members) {
+	if (!members || !members->def) {
+		return FSM_RESULT_SUCCESS;
+	}
+	// Only the head of the observer chain can be unlinked, observers installed later point at this one.
+	if (members->def->observer != fsm_members_observe || members->def->observer_context != members) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_def_set_observer(members->def, members->next_observer, members->next_context);
+	members->def = NULL;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_members_add(fsm_members_t* members, size_t id) {
+	if (!members || id >= members->count || members->nodes[id].state != FSM_STATE_NONE) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	const fsm_t* fsm = &members->instances[id];
+	if (fsm->def != members->def || fsm->current_state >= FSM_MAX_STATES) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	members->nodes[id].epoch = 0;
+	fsm_members_link(members, (uint32_t)id, fsm->current_state);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_members_remove(fsm_members_t* members, size_t id) {
+	if (!members || id >= members->count || members->nodes[id].state == FSM_STATE_NONE) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_members_unlink(members, &members->nodes[id]);
+	return FSM_RESULT_SUCCESS;
+}
+
+size_t fsm_members_count(const fsm_members_t* members, fsm_state_t state) {
+	assert(members);
+	return state < FSM_MAX_STATES ? members->sizes[state] : 0;
+}
+
+uint32_t fsm_members_first(const fsm_members_t* members, fsm_state_t state) {
+	assert(members);
+	return state < FSM_MAX_STATES ? members->heads[state] : FSM_MEMBERS_NONE;
+}
+
+uint32_t fsm_members_next(const fsm_members_t* members, uint32_t id) {
+	assert(members);
+	assert(id < members->count);
+	return members->nodes[id].next;
+}
+
+size_t fsm_broadcast(fsm_members_t* members, const fsm_states_mask_t* mask, fsm_event_t event, void* data) {
+	assert(members);
+	assert(mask);
+	// Each instance is stamped with the broadcast's epoch when reached, so one that moves to a state visited
+	// later is not dispatched twice. On wrap-around the old stamps are cleared once.
+	if (++members->epoch == 0) {
+		for (size_t i = 0; i < members->count; i++) {
+			members->nodes[i].epoch = 0;
+		}
+		members->epoch = 1;
+	}
+
+	size_t accepted = 0;
+	for (size_t state = 0; state < FSM_MAX_STATES; state++) {
+		if (!FSM_STATE_IN_MASK(state, *mask)) {
+			continue;
+		}
+		// The next node is taken before dispatch, which may move the current one to another list.
+		uint32_t id = members->heads[state];
+		while (id != FSM_MEMBERS_NONE) {
+			fsm_member_node_t* node = &members->nodes[id];
+			uint32_t           next = node->next;
+			if (node->epoch != members->epoch) {
+				node->epoch         = members->epoch;
+				fsm_result_t result = fsm_process_event(&members->instances[id], event, data);
+				accepted += result == FSM_RESULT_SUCCESS || result == FSM_RESULT_PENDING;
+			}
+			id = next;
+		}
+	}
+	return accepted;
+}
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_pool.h"
+
+// Hint the CPU to pull a cache line that is about to be read
+#if defined(__GNUC__) || defined(__clang__)
+#define FSM_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define FSM_PREFETCH(addr) ((void)(addr))
+#endif
+
+// Number of batch items to look ahead when prefetching slots and instances
+#define FSM_POOL_PREFETCH_DISTANCE 8
+
+#define FSM_HANDLE_INDEX_MASK     (FSM_POOL_MAX_CAPACITY - 1)
+#define FSM_HANDLE_GENERATION_MAX ((1u << FSM_HANDLE_GENERATION_BITS) - 1)
+
+static inline fsm_handle_t fsm_handle_make(uint32_t index, uint16_t generation) {
+	return ((fsm_handle_t)generation << FSM_HANDLE_INDEX_BITS) | index;
+}
+
+fsm_result_t fsm_pool_init(fsm_pool_t* pool, fsm_t* instances, fsm_pool_slot_t* slots, uint32_t* dense,
+						   size_t capacity) {
+	if (!pool || !instances || !slots || !dense || capacity == 0 || capacity > FSM_POOL_MAX_CAPACITY) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	for (size_t i = 0; i < capacity; i++) {
+		slots[i].link       = (uint32_t)(i + 1);
+		slots[i].generation = 1;
+		slots[i].live       = 0;
+		instances[i].def    = NULL;
+	}
+	pool->instances = instances;
+	pool->slots     = slots;
+	pool->dense     = dense;
+	pool->capacity  = capacity;
+	pool->count     = 0;
+	pool->free_head = 0;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_pool_create(fsm_pool_t* pool, const fsm_def_t* def, fsm_state_t initial_state,
+							 fsm_handle_t* out_handle) {
+	if (!pool || !out_handle) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (pool->free_head >= pool->capacity) {
+		return FSM_RESULT_POOL_FULL;
+	}
+
+	uint32_t         index  = pool->free_head;
+	fsm_pool_slot_t* slot   = &pool->slots[index];
+	fsm_result_t     result = fsm_init(&pool->instances[index], def, initial_state);
+	if (result != FSM_RESULT_SUCCESS) {
+		return result;
+	}
+	pool->free_head          = slot->link;
+	slot->link               = (uint32_t)pool->count;
+	slot->live               = 1;
+	pool->dense[pool->count] = index;
+	pool->count++;
+	*out_handle = fsm_handle_make(index, slot->generation);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_t* fsm_pool_get(const fsm_pool_t* pool, fsm_handle_t handle) {
+	uint32_t index = handle & FSM_HANDLE_INDEX_MASK;
+	if (!pool || index >= pool->capacity) {
+		return NULL;
+	}
+	const fsm_pool_slot_t* slot = &pool->slots[index];
+	if (!slot->live || slot->generation != handle >> FSM_HANDLE_INDEX_BITS) {
+		return NULL;
+	}
+	return &pool->instances[index];
+}
+
+fsm_result_t fsm_pool_destroy(fsm_pool_t* pool, fsm_handle_t handle) {
+	if (!fsm_pool_get(pool, handle)) {
+		return FSM_RESULT_INVALID_HANDLE;
+	}
+
+	uint32_t         index = handle & FSM_HANDLE_INDEX_MASK;
+	fsm_pool_slot_t* slot  = &pool->slots[index];
+	// Swap-remove from the dense list, the last live slot takes the freed position.
+	uint32_t last              = pool->dense[--pool->count];
+	pool->dense[slot->link]    = last;
+	pool->slots[last].link     = slot->link;
+	pool->instances[index].def = NULL;
+	slot->generation           = slot->generation == FSM_HANDLE_GENERATION_MAX ? 1 : slot->generation + 1;
+	slot->live                 = 0;
+	slot->link                 = pool->free_head;
+	pool->free_head            = index;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_pool_process_event(fsm_pool_t* pool, fsm_handle_t handle, fsm_event_t event, void* data) {
+	fsm_t* self = fsm_pool_get(pool, handle);
+	if (!self) {
+		return FSM_RESULT_INVALID_HANDLE;
+	}
+	return fsm_process_event(self, event, data);
+}
+
+fsm_result_t fsm_pool_process_events_batch(fsm_pool_t* pool, const fsm_handle_t* handles, const fsm_event_t* events,
+										   void* const* data, fsm_result_t* results, size_t count) {
+	if (!pool || !handles || !events || !results) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		// Only the memory of later items is touched ahead of time: each handle is checked right before its own
+		// dispatch, since actions of earlier items may destroy pooled instances or reuse their slots.
+		if (i + FSM_POOL_PREFETCH_DISTANCE < count) {
+			uint32_t ahead = handles[i + FSM_POOL_PREFETCH_DISTANCE] & FSM_HANDLE_INDEX_MASK;
+			if (ahead < pool->capacity) {
+				FSM_PREFETCH(&pool->slots[ahead]);
+				FSM_PREFETCH(&pool->instances[ahead]);
+			}
+		}
+		fsm_t* self = fsm_pool_get(pool, handles[i]);
+		results[i]  = self ? fsm_process_event(self, events[i], data ? data[i] : NULL) : FSM_RESULT_INVALID_HANDLE;
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_t* fsm_pool_at(const fsm_pool_t* pool, size_t position, fsm_handle_t* out_handle) {
+	if (!pool || position >= pool->count) {
+		return NULL;
+	}
+	uint32_t index = pool->dense[position];
+	if (out_handle) {
+		*out_handle = fsm_handle_make(index, pool->slots[index].generation);
+	}
+	return &pool->instances[index];
+}
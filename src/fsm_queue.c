@@ -0,0 +1,287 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_queue.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "fsm_atomic.h"
+
+static void fsm_queue_slots_init(fsm_queue_slot_t* slots, size_t capacity) {
+	for (size_t i = 0; i < capacity; i++) {
+		slots[i].sequence = i;
+		slots[i].data     = NULL;
+		slots[i].event    = 0;
+		slots[i].owned    = 0;
+	}
+}
+
+fsm_result_t fsm_queue_init(fsm_queue_t* queue, fsm_t* fsm, fsm_queue_slot_t* slots, size_t capacity) {
+	if (!queue || !fsm || !slots || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_queue_slots_init(slots, capacity);
+
+	queue->fsm              = fsm;
+	queue->slots            = slots;
+	queue->mask             = capacity - 1;
+	queue->urgent_slots     = NULL;
+	queue->urgent_mask      = 0;
+	queue->deferred         = NULL;
+	queue->deferred_mask    = 0;
+	queue->deferred_head    = 0;
+	queue->deferred_tail    = 0;
+	queue->deferred_dropped = 0;
+	queue->draining         = 0;
+	queue->recall           = 0;
+	queue->suspended        = NULL;
+	queue->tail             = 0;
+	queue->urgent_tail      = 0;
+	queue->head             = 0;
+	queue->urgent_head      = 0;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_queue_set_urgent(fsm_queue_t* queue, fsm_queue_slot_t* slots, size_t capacity) {
+	if (!queue || !slots || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_queue_slots_init(slots, capacity);
+
+	queue->urgent_slots = slots;
+	queue->urgent_mask  = capacity - 1;
+	queue->urgent_tail  = 0;
+	queue->urgent_head  = 0;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_queue_set_deferred(fsm_queue_t* queue, fsm_queue_slot_t* slots, size_t capacity) {
+	if (!queue || !slots || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	queue->deferred         = slots;
+	queue->deferred_mask    = capacity - 1;
+	queue->deferred_head    = 0;
+	queue->deferred_tail    = 0;
+	queue->deferred_dropped = 0;
+	queue->recall           = 0;
+	return FSM_RESULT_SUCCESS;
+}
+
+// Claims a slot of a lane for a producer, see fsm_post_event().
+static fsm_result_t fsm_queue_push(fsm_queue_slot_t* slots, size_t mask, size_t* tail, fsm_event_t event,
+								   void* data, uint8_t owned) {
+	size_t            pos = FSM_ATOMIC_LOAD_RELAXED(tail);
+	fsm_queue_slot_t* slot;
+	for (;;) {
+		slot         = &slots[pos & mask];
+		size_t   seq = FSM_ATOMIC_LOAD_ACQUIRE(&slot->sequence);
+		intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+		if (dif == 0) {
+			// The slot is free for this lap, claim the position.
+			if (FSM_ATOMIC_CAS(tail, &pos, pos + 1)) {
+				break;
+			}
+		} else if (dif < 0) {
+			// The consumer has not released this slot from the previous lap yet.
+			return FSM_RESULT_QUEUE_FULL;
+		} else {
+			pos = FSM_ATOMIC_LOAD_RELAXED(tail);
+		}
+	}
+	slot->event = event;
+	slot->data  = data;
+	slot->owned = owned;
+	FSM_ATOMIC_STORE_RELEASE(&slot->sequence, pos + 1);
+	return FSM_RESULT_SUCCESS;
+}
+
+// Takes the oldest published event of a lane, returns 0 if there is none.
+static int fsm_queue_pop(fsm_queue_slot_t* slots, size_t mask, size_t* head, fsm_queue_slot_t* out) {
+	size_t            pos  = *head;
+	fsm_queue_slot_t* slot = &slots[pos & mask];
+	if (FSM_ATOMIC_LOAD_ACQUIRE(&slot->sequence) != pos + 1) {
+		return 0;
+	}
+	out->event = slot->event;
+	out->data  = slot->data;
+	out->owned = slot->owned;
+	// Release the slot before dispatching, so actions can post follow-up events into it.
+	FSM_ATOMIC_STORE_RELEASE(&slot->sequence, pos + mask + 1);
+	*head = pos + 1;
+	return 1;
+}
+
+fsm_result_t fsm_post_event(fsm_queue_t* queue, fsm_event_t event, void* data) {
+	assert(queue);
+	return fsm_queue_push(queue->slots, queue->mask, &queue->tail, event, data, 0);
+}
+
+fsm_result_t fsm_post_envelope(fsm_queue_t* queue, fsm_event_t event, fsm_envelope_t* envelope) {
+	assert(queue);
+	return fsm_queue_push(queue->slots, queue->mask, &queue->tail, event, envelope, envelope != NULL);
+}
+
+fsm_result_t fsm_post_urgent_event(fsm_queue_t* queue, fsm_event_t event, void* data) {
+	assert(queue);
+	if (!queue->urgent_slots) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	return fsm_queue_push(queue->urgent_slots, queue->urgent_mask, &queue->urgent_tail, event, data, 0);
+}
+
+fsm_result_t fsm_post_urgent_envelope(fsm_queue_t* queue, fsm_event_t event, fsm_envelope_t* envelope) {
+	assert(queue);
+	if (!queue->urgent_slots) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	return fsm_queue_push(queue->urgent_slots, queue->urgent_mask, &queue->urgent_tail, event, envelope,
+						  envelope != NULL);
+}
+
+size_t fsm_queue_deferred_count(const fsm_queue_t* queue) {
+	assert(queue);
+	return queue->deferred_tail - queue->deferred_head;
+}
+
+// Whether the current state of fsm, or one of its ancestors, defers event.
+static int fsm_queue_defers(const fsm_t* fsm, fsm_event_t event) {
+	const fsm_def_t* def   = fsm->def;
+	fsm_state_t      state = fsm->current_state;
+	if (!def->states) {
+		return 0;
+	}
+	while (state < def->state_count) {
+		const fsm_state_desc_t* desc = &def->states[state];
+		for (uint16_t i = 0; i < desc->deferred_count; i++) {
+			if (desc->deferred_events[i] == event) {
+				return 1;
+			}
+		}
+		state = def->parents ? def->parents[state] : FSM_STATE_NONE;
+	}
+	return 0;
+}
+
+// Releases the envelope of a dispatched event. One whose transition was suspended is kept until the transition
+// completes, since the suspended action may still read it.
+static void fsm_queue_settle(fsm_queue_t* queue, const fsm_queue_slot_t* item, fsm_result_t result) {
+	if (!item->owned) {
+		return;
+	}
+	if (result == FSM_RESULT_PENDING) {
+		queue->suspended = (fsm_envelope_t*)item->data;
+	} else {
+		fsm_envelope_release((fsm_envelope_t*)item->data);
+	}
+}
+
+// Dispatches the parked events again after a transition, oldest first. A handled event leaves the ring,
+// and another transition restarts the walk from the oldest event still parked.
+static void fsm_queue_recall(fsm_queue_t* queue) {
+	size_t pos = queue->deferred_head;
+	while (pos != queue->deferred_tail) {
+		fsm_queue_slot_t slot   = queue->deferred[pos & queue->deferred_mask];
+		fsm_result_t     result = fsm_process_event(queue->fsm, slot.event, slot.data);
+		if (result == FSM_RESULT_NO_TRANSITION_FOR_STATE && fsm_queue_defers(queue->fsm, slot.event)) {
+			pos++;
+			continue;
+		}
+		fsm_queue_settle(queue, &slot, result);
+		// Close the gap by moving the older parked events up one position.
+		for (size_t i = pos; i != queue->deferred_head; i--) {
+			queue->deferred[i & queue->deferred_mask] = queue->deferred[(i - 1) & queue->deferred_mask];
+		}
+		queue->deferred_head++;
+		if (result == FSM_RESULT_PENDING) {
+			// The rest is recalled by the drain once the transition completes.
+			queue->recall = 1;
+			return;
+		}
+		pos = result == FSM_RESULT_SUCCESS ? queue->deferred_head : pos + 1;
+	}
+}
+
+static void fsm_queue_dispatch(fsm_queue_t* queue, const fsm_queue_slot_t* item) {
+	fsm_result_t result = fsm_process_event(queue->fsm, item->event, item->data);
+	if (queue->deferred && result == FSM_RESULT_NO_TRANSITION_FOR_STATE && fsm_queue_defers(queue->fsm, item->event)) {
+		if (queue->deferred_tail - queue->deferred_head > queue->deferred_mask) {
+			queue->deferred_dropped++;
+		} else {
+			// The parked event keeps its envelope.
+			fsm_queue_slot_t* slot = &queue->deferred[queue->deferred_tail++ & queue->deferred_mask];
+			slot->event            = item->event;
+			slot->data             = item->data;
+			slot->owned            = item->owned;
+			return;
+		}
+	}
+	fsm_queue_settle(queue, item, result);
+	if (!queue->deferred) {
+		return;
+	}
+	if (result == FSM_RESULT_SUCCESS && queue->deferred_tail != queue->deferred_head) {
+		fsm_queue_recall(queue);
+	} else if (result == FSM_RESULT_PENDING && queue->deferred_tail != queue->deferred_head) {
+		queue->recall = 1;
+	}
+}
+
+size_t fsm_drain(fsm_queue_t* queue) {
+	assert(queue);
+	if (queue->draining) {
+		return 0;
+	}
+	queue->draining = 1;
+
+	size_t           processed = 0;
+	fsm_queue_slot_t item;
+	for (;;) {
+		// Events wait in the lanes while a transition is suspended.
+		if (fsm_is_pending(queue->fsm)) {
+			break;
+		}
+		if (queue->suspended) {
+			fsm_envelope_release(queue->suspended);
+			queue->suspended = NULL;
+		}
+		if (queue->recall) {
+			queue->recall = 0;
+			fsm_queue_recall(queue);
+			continue;
+		}
+		// The urgent lane is checked before every normal event, so urgent events overtake queued ones.
+		if (!(queue->urgent_slots &&
+			  fsm_queue_pop(queue->urgent_slots, queue->urgent_mask, &queue->urgent_head, &item)) &&
+			!fsm_queue_pop(queue->slots, queue->mask, &queue->head, &item)) {
+			break;
+		}
+		fsm_queue_dispatch(queue, &item);
+		processed++;
+	}
+
+	queue->draining = 0;
+	return processed;
+}
@@ -0,0 +1,398 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_shared.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "fsm_atomic.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FSM_SHARED_POSIX 1
+#endif
+
+#define FSM_HANDLE_INDEX_MASK     (FSM_POOL_MAX_CAPACITY - 1)
+#define FSM_HANDLE_GENERATION_MAX ((1u << FSM_HANDLE_GENERATION_BITS) - 1)
+
+// State word layout: state in bits 0-15, generation from bit 16, flags in bits 30-31, sequence in the high half.
+#define FSM_SHARED_GENERATION_SHIFT 16
+#define FSM_SHARED_BUSY             (1ULL << 30)
+#define FSM_SHARED_LIVE             (1ULL << 31)
+#define FSM_SHARED_SEQUENCE_SHIFT   32
+
+// Alignment of the sections following the header.
+#define FSM_SHARED_ALIGN 64
+
+#ifdef FSM_SHARED_POSIX
+static inline uint64_t fsm_shared_word(fsm_state_t state, uint16_t generation, uint32_t sequence, uint64_t flags) {
+	return (uint64_t)state | ((uint64_t)generation << FSM_SHARED_GENERATION_SHIFT) | flags |
+		   ((uint64_t)sequence << FSM_SHARED_SEQUENCE_SHIFT);
+}
+
+static inline fsm_state_t fsm_shared_word_state(uint64_t word) {
+	return (fsm_state_t)(word & 0xFFFF);
+}
+
+static inline uint16_t fsm_shared_word_generation(uint64_t word) {
+	return (uint16_t)((word >> FSM_SHARED_GENERATION_SHIFT) & FSM_HANDLE_GENERATION_MAX);
+}
+
+static inline uint32_t fsm_shared_word_sequence(uint64_t word) {
+	return (uint32_t)(word >> FSM_SHARED_SEQUENCE_SHIFT);
+}
+
+static inline size_t fsm_shared_align(size_t offset) {
+	return (offset + FSM_SHARED_ALIGN - 1) & ~(size_t)(FSM_SHARED_ALIGN - 1);
+}
+
+// Whether dispatch on def is a pure table lookup, so a transition can be one compare-and-swap.
+static int fsm_shared_is_lock_free(const fsm_def_t* def) {
+	if (def->parents || def->observer || def->chain_next) {
+		return 0;
+	}
+	for (size_t i = 0; i < def->transition_count; i++) {
+		const fsm_transition_t* rule = &def->transition_rules[i];
+		if (rule->guard || rule->on_entry || rule->on_exit) {
+			return 0;
+		}
+	}
+	for (size_t i = 0; def->states && i < def->state_count; i++) {
+		if (def->states[i].on_entry || def->states[i].on_exit) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Points the mapping at the sections of a validated segment.
+static void fsm_shared_bind(fsm_shared_t* shared, void* data, size_t size, const fsm_def_t* def) {
+	shared->header    = (fsm_shared_header_t*)data;
+	shared->words     = (uint64_t*)((char*)data + shared->header->words_offset);
+	shared->links     = (uint32_t*)((char*)data + shared->header->links_offset);
+	shared->size      = size;
+	shared->def       = def;
+	shared->userdata  = NULL;
+	shared->lock_free = def ? fsm_shared_is_lock_free(def) : 0;
+}
+
+fsm_result_t fsm_shared_create(fsm_shared_t* shared, const char* name, const fsm_def_t* def, size_t capacity) {
+	if (!shared || !name || !def || !def->dispatch_index || capacity == 0 || capacity > FSM_POOL_MAX_CAPACITY) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	size_t words_offset = fsm_shared_align(sizeof(fsm_shared_header_t));
+	size_t links_offset = fsm_shared_align(words_offset + capacity * sizeof(uint64_t));
+	size_t size         = links_offset + capacity * sizeof(uint32_t);
+	int    fd           = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	if (ftruncate(fd, (off_t)size) != 0) {
+		close(fd);
+		shm_unlink(name);
+		return FSM_RESULT_IO_ERROR;
+	}
+	void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		shm_unlink(name);
+		return FSM_RESULT_IO_ERROR;
+	}
+
+	// The segment starts zeroed; everything but the magic is written before other processes may look.
+	fsm_shared_header_t* header = (fsm_shared_header_t*)data;
+	header->version             = FSM_SHARED_VERSION;
+	header->state_size          = sizeof(fsm_state_t);
+	header->def_hash            = fsm_def_hash(def);
+	header->capacity            = capacity;
+	header->words_offset        = words_offset;
+	header->links_offset        = links_offset;
+	header->total_size          = size;
+	header->free_head           = 0;
+	header->count               = 0;
+	fsm_shared_bind(shared, data, size, def);
+	for (size_t i = 0; i < capacity; i++) {
+		shared->words[i] = fsm_shared_word(0, 1, 0, 0);
+		shared->links[i] = (uint32_t)(i + 1);
+	}
+	FSM_ATOMIC_STORE_RELEASE(&header->magic, FSM_SHARED_MAGIC);
+	return FSM_RESULT_SUCCESS;
+}
+
+// Maps a named segment and checks its header.
+static fsm_result_t fsm_shared_map(fsm_shared_t* shared, const char* name, const fsm_def_t* def) {
+	int fd = shm_open(name, def ? O_RDWR : O_RDONLY, 0);
+	if (fd < 0) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(fsm_shared_header_t)) {
+		close(fd);
+		return FSM_RESULT_IO_ERROR;
+	}
+	size_t size = (size_t)st.st_size;
+	void*  data = mmap(NULL, size, def ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return FSM_RESULT_IO_ERROR;
+	}
+
+	const fsm_shared_header_t* header = (const fsm_shared_header_t*)data;
+	fsm_result_t               result = FSM_RESULT_SUCCESS;
+	if (FSM_ATOMIC_LOAD_ACQUIRE(&header->magic) != FSM_SHARED_MAGIC ||
+		header->version != FSM_SHARED_VERSION || header->total_size != size) {
+		result = FSM_RESULT_IO_ERROR;
+	} else if (header->state_size != sizeof(fsm_state_t) || (def && header->def_hash != fsm_def_hash(def))) {
+		result = FSM_RESULT_DEFINITION_MISMATCH;
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		munmap(data, size);
+		return result;
+	}
+	fsm_shared_bind(shared, data, size, def);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_shared_open(fsm_shared_t* shared, const char* name, const fsm_def_t* def) {
+	if (!shared || !name || !def || !def->dispatch_index) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	return fsm_shared_map(shared, name, def);
+}
+
+fsm_result_t fsm_shared_open_readonly(fsm_shared_t* shared, const char* name) {
+	if (!shared || !name) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	return fsm_shared_map(shared, name, NULL);
+}
+
+void fsm_shared_close(fsm_shared_t* shared) {
+	if (shared && shared->header) {
+		munmap(shared->header, shared->size);
+		memset(shared, 0, sizeof(*shared));
+	}
+}
+
+fsm_result_t fsm_shared_unlink(const char* name) {
+	return name && shm_unlink(name) == 0 ? FSM_RESULT_SUCCESS : FSM_RESULT_IO_ERROR;
+}
+
+fsm_result_t fsm_shared_alloc(fsm_shared_t* shared, fsm_state_t initial_state, fsm_handle_t* out_handle) {
+	if (!shared || !shared->def || !out_handle) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (shared->def->state_count && initial_state >= shared->def->state_count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	// Pop a slot; the tag in the high half makes a slot freed and popped again in between fail the CAS.
+	fsm_shared_header_t* header = shared->header;
+	uint64_t             head   = FSM_ATOMIC_LOAD_ACQUIRE(&header->free_head);
+	uint32_t             index;
+	for (;;) {
+		index = (uint32_t)head;
+		if (index >= header->capacity) {
+			return FSM_RESULT_POOL_FULL;
+		}
+		uint32_t next = FSM_ATOMIC_LOAD_RELAXED(&shared->links[index]);
+		uint64_t tag  = (head >> 32) + 1;
+		if (FSM_ATOMIC_CAS(&header->free_head, &head, tag << 32 | next)) {
+			break;
+		}
+	}
+
+	uint64_t word       = FSM_ATOMIC_LOAD_RELAXED(&shared->words[index]);
+	uint16_t generation = fsm_shared_word_generation(word);
+	FSM_ATOMIC_STORE_RELEASE(&shared->words[index], fsm_shared_word(initial_state, generation,
+																	 fsm_shared_word_sequence(word), FSM_SHARED_LIVE));
+	FSM_ATOMIC_FETCH_ADD(&header->count, 1);
+	*out_handle = ((fsm_handle_t)generation << FSM_HANDLE_INDEX_BITS) | index;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_shared_free(fsm_shared_t* shared, fsm_handle_t handle) {
+	if (!shared || !shared->def) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	uint32_t index = handle & FSM_HANDLE_INDEX_MASK;
+	if (index >= shared->header->capacity) {
+		return FSM_RESULT_INVALID_HANDLE;
+	}
+
+	uint64_t* slot = &shared->words[index];
+	uint64_t  word = FSM_ATOMIC_LOAD_ACQUIRE(slot);
+	uint16_t  generation;
+	do {
+		generation = fsm_shared_word_generation(word);
+		if (!(word & FSM_SHARED_LIVE) || generation != handle >> FSM_HANDLE_INDEX_BITS) {
+			return FSM_RESULT_INVALID_HANDLE;
+		}
+		if (word & FSM_SHARED_BUSY) {
+			return FSM_RESULT_BUSY;
+		}
+	} while (!FSM_ATOMIC_CAS(slot, &word,
+							 fsm_shared_word(0, generation == FSM_HANDLE_GENERATION_MAX ? 1 : generation + 1,
+											 fsm_shared_word_sequence(word) + 1, 0)));
+
+	// Push the slot back on the free list.
+	fsm_shared_header_t* header = shared->header;
+	uint64_t             head   = FSM_ATOMIC_LOAD_RELAXED(&header->free_head);
+	do {
+		FSM_ATOMIC_STORE_RELAXED(&shared->links[index], (uint32_t)head);
+	} while (!FSM_ATOMIC_CAS(&header->free_head, &head, ((head >> 32) + 1) << 32 | index));
+	FSM_ATOMIC_FETCH_ADD(&header->count, (uint64_t)-1);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_shared_process(fsm_shared_t* shared, fsm_handle_t handle, fsm_event_t event, void* data) {
+	assert(shared);
+	const fsm_def_t* def   = shared->def;
+	uint32_t         index = handle & FSM_HANDLE_INDEX_MASK;
+	if (!def) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (index >= shared->header->capacity) {
+		return FSM_RESULT_INVALID_HANDLE;
+	}
+	if (event >= def->event_count) {
+		return FSM_RESULT_EVENT_OUT_OF_BOUNDS;
+	}
+
+	uint64_t*   slot = &shared->words[index];
+	uint64_t    word = FSM_ATOMIC_LOAD_ACQUIRE(slot);
+	fsm_state_t state;
+	for (;;) {
+		if (!(word & FSM_SHARED_LIVE) || fsm_shared_word_generation(word) != handle >> FSM_HANDLE_INDEX_BITS) {
+			return FSM_RESULT_INVALID_HANDLE;
+		}
+		if (word & FSM_SHARED_BUSY) {
+			return FSM_RESULT_BUSY;
+		}
+		state = fsm_shared_word_state(word);
+		if (state >= def->state_count) {
+			return FSM_RESULT_STATE_OUT_OF_BOUNDS;
+		}
+		if (shared->lock_free) {
+			uint16_t i = def->dispatch_index[(size_t)state * def->event_count + event];
+			if (i == FSM_INDEX_NONE) {
+				return FSM_RESULT_NO_TRANSITION_FOR_STATE;
+			}
+			uint64_t next = fsm_shared_word(def->transition_rules[i].target_state, fsm_shared_word_generation(word),
+											fsm_shared_word_sequence(word) + 1, FSM_SHARED_LIVE);
+			if (FSM_ATOMIC_CAS(slot, &word, next)) {
+				return FSM_RESULT_SUCCESS;
+			}
+		} else if (FSM_ATOMIC_CAS(slot, &word, word | FSM_SHARED_BUSY)) {
+			break;
+		}
+	}
+
+	// Claimed: the callbacks run here on a local instance, then the result is published.
+	fsm_t local;
+	fsm_init(&local, def, state);
+	local.userdata = shared->userdata;
+
+	fsm_result_t result   = fsm_process_event(&local, event, data);
+	uint32_t     sequence = fsm_shared_word_sequence(word) + (result == FSM_RESULT_SUCCESS);
+	FSM_ATOMIC_STORE_RELEASE(slot, fsm_shared_word(local.current_state, fsm_shared_word_generation(word), sequence,
+												   FSM_SHARED_LIVE));
+	return result;
+}
+
+fsm_result_t fsm_shared_read(const fsm_shared_t* shared, size_t index, fsm_shared_entry_t* entry) {
+	if (!shared || !shared->header || !entry || index >= shared->header->capacity) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	uint64_t word     = FSM_ATOMIC_LOAD_ACQUIRE(&shared->words[index]);
+	entry->state      = fsm_shared_word_state(word);
+	entry->generation = fsm_shared_word_generation(word);
+	entry->sequence   = fsm_shared_word_sequence(word);
+	entry->live       = (word & FSM_SHARED_LIVE) != 0;
+	entry->busy       = (word & FSM_SHARED_BUSY) != 0;
+	return FSM_RESULT_SUCCESS;
+}
+#else
+fsm_result_t fsm_shared_create(fsm_shared_t* shared, const char* name, const fsm_def_t* def, size_t capacity) {
+	(void)shared;
+	(void)name;
+	(void)def;
+	(void)capacity;
+	return FSM_RESULT_IO_ERROR;
+}
+
+fsm_result_t fsm_shared_open(fsm_shared_t* shared, const char* name, const fsm_def_t* def) {
+	(void)shared;
+	(void)name;
+	(void)def;
+	return FSM_RESULT_IO_ERROR;
+}
+
+fsm_result_t fsm_shared_open_readonly(fsm_shared_t* shared, const char* name) {
+	(void)shared;
+	(void)name;
+	return FSM_RESULT_IO_ERROR;
+}
+
+void fsm_shared_close(fsm_shared_t* shared) {
+	(void)shared;
+}
+
+fsm_result_t fsm_shared_unlink(const char* name) {
+	(void)name;
+	return FSM_RESULT_IO_ERROR;
+}
+
+fsm_result_t fsm_shared_alloc(fsm_shared_t* shared, fsm_state_t initial_state, fsm_handle_t* out_handle) {
+	(void)shared;
+	(void)initial_state;
+	(void)out_handle;
+	return FSM_RESULT_INVALID_PARAMS;
+}
+
+fsm_result_t fsm_shared_free(fsm_shared_t* shared, fsm_handle_t handle) {
+	(void)shared;
+	(void)handle;
+	return FSM_RESULT_INVALID_PARAMS;
+}
+
+fsm_result_t fsm_shared_process(fsm_shared_t* shared, fsm_handle_t handle, fsm_event_t event, void* data) {
+	(void)shared;
+	(void)handle;
+	(void)event;
+	(void)data;
+	return FSM_RESULT_INVALID_PARAMS;
+}
+
+fsm_result_t fsm_shared_read(const fsm_shared_t* shared, size_t index, fsm_shared_entry_t* entry) {
+	(void)shared;
+	(void)index;
+	(void)entry;
+	return FSM_RESULT_INVALID_PARAMS;
+}
+#endif
@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FSM_SNAPSHOT_POSIX 1
+#endif
+
+static inline size_t fsm_snapshot_align(size_t offset) {
+	return (offset + FSM_SNAPSHOT_ALIGN - 1) & ~(size_t)(FSM_SNAPSHOT_ALIGN - 1);
+}
+
+static inline size_t fsm_snapshot_states_offset(void) {
+	return fsm_snapshot_align(sizeof(fsm_snapshot_header_t));
+}
+
+static inline size_t fsm_snapshot_records_offset(size_t count) {
+	return fsm_snapshot_align(fsm_snapshot_states_offset() + count * sizeof(fsm_state_t));
+}
+
+size_t fsm_snapshot_size(size_t count, size_t record_size) {
+	return fsm_snapshot_records_offset(count) + count * record_size;
+}
+
+fsm_result_t fsm_snapshot_write(const fsm_def_t* def, const fsm_t* instances, size_t count, size_t record_size,
+								fsm_snapshot_save_t save, void* context, void* buffer, size_t buffer_size) {
+	if (!def || (!instances && count > 0) || !buffer || (record_size > 0 && !save)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if ((uintptr_t)buffer % sizeof(uint64_t) != 0 || buffer_size < fsm_snapshot_size(count, record_size)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	// Checked before anything is written, so a refused snapshot leaves the buffer untouched.
+	for (size_t i = 0; i < count; i++) {
+		if (instances[i].def && instances[i].def != def) {
+			return FSM_RESULT_DEFINITION_MISMATCH;
+		}
+		if (instances[i].def && instances[i].pending_step) {
+			return FSM_RESULT_BUSY;
+		}
+	}
+
+	uint8_t*               base    = (uint8_t*)buffer;
+	fsm_snapshot_header_t* header  = (fsm_snapshot_header_t*)base;
+	fsm_state_t*           states  = (fsm_state_t*)(base + fsm_snapshot_states_offset());
+	uint8_t*               records = base + fsm_snapshot_records_offset(count);
+
+	memset(base, 0, fsm_snapshot_records_offset(count));
+	header->magic          = FSM_SNAPSHOT_MAGIC;
+	header->version        = FSM_SNAPSHOT_VERSION;
+	header->state_size     = (uint16_t)sizeof(fsm_state_t);
+	header->def_hash       = fsm_def_hash(def);
+	header->count          = count;
+	header->record_size    = record_size;
+	header->states_offset  = fsm_snapshot_states_offset();
+	header->records_offset = fsm_snapshot_records_offset(count);
+	header->total_size     = fsm_snapshot_size(count, record_size);
+	for (size_t i = 0; i < count; i++) {
+		states[i] = instances[i].def ? instances[i].current_state : FSM_STATE_NONE;
+	}
+	for (size_t i = 0; i < count && record_size > 0; i++) {
+		if (instances[i].def) {
+			save(context, &instances[i], records + i * record_size, record_size);
+		} else {
+			memset(records + i * record_size, 0, record_size);
+		}
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_snapshot_view(const fsm_def_t* def, void* buffer, size_t buffer_size, fsm_snapshot_view_t* view) {
+	if (!def || !buffer || !view || (uintptr_t)buffer % sizeof(uint64_t) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (buffer_size < sizeof(fsm_snapshot_header_t)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	uint8_t*                     base   = (uint8_t*)buffer;
+	const fsm_snapshot_header_t* header = (const fsm_snapshot_header_t*)base;
+	if (header->magic != FSM_SNAPSHOT_MAGIC || header->version != FSM_SNAPSHOT_VERSION) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (header->state_size != sizeof(fsm_state_t) || header->def_hash != fsm_def_hash(def)) {
+		return FSM_RESULT_DEFINITION_MISMATCH;
+	}
+	// The layout is fully determined by count and record_size, so any other offsets mean a corrupt header.
+	if (header->count > (SIZE_MAX - FSM_SNAPSHOT_ALIGN * 2) / sizeof(fsm_state_t) ||
+		(header->record_size > 0 && header->count > SIZE_MAX / 2 / header->record_size) ||
+		header->states_offset != fsm_snapshot_states_offset() ||
+		header->records_offset != fsm_snapshot_records_offset((size_t)header->count) ||
+		header->total_size != fsm_snapshot_size((size_t)header->count, (size_t)header->record_size) ||
+		header->total_size > buffer_size) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	view->header      = header;
+	view->states      = (const fsm_state_t*)(base + header->states_offset);
+	view->records     = header->record_size > 0 ? base + header->records_offset : NULL;
+	view->count       = (size_t)header->count;
+	view->record_size = (size_t)header->record_size;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_snapshot_restore(const fsm_snapshot_view_t* view, const fsm_def_t* def, fsm_t* instances,
+								  size_t count, fsm_snapshot_load_t load, void* context) {
+	if (!view || !def || (!instances && view->count > 0) || count < view->count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	uint8_t* records = (uint8_t*)view->records;
+	for (size_t i = 0; i < view->count; i++) {
+		if (view->states[i] == FSM_STATE_NONE) {
+			instances[i].def = NULL;
+			continue;
+		}
+		fsm_result_t result = fsm_init(&instances[i], def, view->states[i]);
+		if (result != FSM_RESULT_SUCCESS) {
+			return result;
+		}
+		if (!records) {
+			continue;
+		}
+		if (load) {
+			load(context, &instances[i], records + i * view->record_size, view->record_size);
+		} else {
+			instances[i].userdata = records + i * view->record_size;
+		}
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+#ifdef FSM_SNAPSHOT_POSIX
+// Writes a snapshot into an open file through a shared mapping and flushes it to disk.
+static fsm_result_t fsm_snapshot_fill(int fd, const fsm_def_t* def, const fsm_t* instances, size_t count,
+									  size_t record_size, fsm_snapshot_save_t save, void* context) {
+	size_t size = fsm_snapshot_size(count, record_size);
+	if (ftruncate(fd, (off_t)size) != 0) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	fsm_result_t result = fsm_snapshot_write(def, instances, count, record_size, save, context, data, size);
+	if (result == FSM_RESULT_SUCCESS && msync(data, size, MS_SYNC) != 0) {
+		result = FSM_RESULT_IO_ERROR;
+	}
+	munmap(data, size);
+	if (result == FSM_RESULT_SUCCESS && fsync(fd) != 0) {
+		result = FSM_RESULT_IO_ERROR;
+	}
+	return result;
+}
+
+// Flushes the directory entry of a renamed file, best effort.
+static void fsm_snapshot_sync_dir(const char* path) {
+	char        dir[PATH_MAX];
+	const char* slash = strrchr(path, '/');
+	if (!slash) {
+		strcpy(dir, ".");
+	} else {
+		size_t length = slash == path ? 1 : (size_t)(slash - path);
+		memcpy(dir, path, length);
+		dir[length] = '\0';
+	}
+	int fd = open(dir, O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+}
+
+fsm_result_t fsm_snapshot_write_file(const char* path, const fsm_def_t* def, const fsm_t* instances, size_t count,
+									 size_t record_size, fsm_snapshot_save_t save, void* context) {
+	if (!path || !def || (!instances && count > 0) || (record_size > 0 && !save)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	char temp[PATH_MAX];
+	if ((size_t)snprintf(temp, sizeof(temp), "%s.tmp", path) >= sizeof(temp)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	int fd = open(temp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	fsm_result_t result = fsm_snapshot_fill(fd, def, instances, count, record_size, save, context);
+	if (close(fd) != 0 && result == FSM_RESULT_SUCCESS) {
+		result = FSM_RESULT_IO_ERROR;
+	}
+	if (result == FSM_RESULT_SUCCESS && rename(temp, path) != 0) {
+		result = FSM_RESULT_IO_ERROR;
+	}
+	if (result != FSM_RESULT_SUCCESS) {
+		unlink(temp);
+		return result;
+	}
+	fsm_snapshot_sync_dir(path);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_snapshot_map_file(const char* path, fsm_snapshot_map_t* map) {
+	if (!path || !map) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return FSM_RESULT_IO_ERROR;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return FSM_RESULT_IO_ERROR;
+	}
+	void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return FSM_RESULT_IO_ERROR;
+	}
+
+	map->data = data;
+	map->size = (size_t)st.st_size;
+	return FSM_RESULT_SUCCESS;
+}
+
+void fsm_snapshot_unmap_file(fsm_snapshot_map_t* map) {
+	if (map && map->data) {
+		munmap(map->data, map->size);
+		map->data = NULL;
+		map->size = 0;
+	}
+}
+#else
+fsm_result_t fsm_snapshot_write_file(const char* path, const fsm_def_t* def, const fsm_t* instances, size_t count,
+									 size_t record_size, fsm_snapshot_save_t save, void* context) {
+	(void)path;
+	(void)def;
+	(void)instances;
+	(void)count;
+	(void)record_size;
+	(void)save;
+	(void)context;
+	return FSM_RESULT_IO_ERROR;
+}
+
+fsm_result_t fsm_snapshot_map_file(const char* path, fsm_snapshot_map_t* map) {
+	(void)path;
+	(void)map;
+	return FSM_RESULT_IO_ERROR;
+}
+
+void fsm_snapshot_unmap_file(fsm_snapshot_map_t* map) {
+	(void)map;
+}
+#endif
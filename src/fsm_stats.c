@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_stats.h"
+
+#include <string.h>
+
+fsm_result_t fsm_stats_init(fsm_stats_t* stats, const fsm_def_t* def, uint64_t* rule_hits, uint64_t* rule_denials,
+							size_t rule_capacity) {
+	if (!stats) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if (def && (!rule_hits || !rule_denials || rule_capacity < def->transition_count)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	memset(stats, 0, sizeof(fsm_stats_t));
+	if (def) {
+		memset(rule_hits, 0, rule_capacity * sizeof(uint64_t));
+		memset(rule_denials, 0, rule_capacity * sizeof(uint64_t));
+		stats->def           = def;
+		stats->rule_hits     = rule_hits;
+		stats->rule_denials  = rule_denials;
+		stats->rule_capacity = rule_capacity;
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+void fsm_stats_merge(fsm_stats_t* dst, const fsm_stats_t* src) {
+	if (!dst || !src) {
+		return;
+	}
+	for (size_t i = 0; i < FSM_RESULT_COUNT; i++) {
+		dst->results[i] += src->results[i];
+	}
+	for (size_t i = 0; i < FSM_MAX_STATES; i++) {
+		dst->state_dwell_ns[i] += src->state_dwell_ns[i];
+		dst->state_exits[i] += src->state_exits[i];
+	}
+	for (size_t k = 0; k < FSM_STATS_CALLBACKS; k++) {
+		for (size_t b = 0; b < FSM_STATS_LATENCY_BUCKETS; b++) {
+			dst->callback_latency[k][b] += src->callback_latency[k][b];
+		}
+	}
+	if (dst->def && dst->def == src->def) {
+		for (size_t i = 0; i < dst->def->transition_count; i++) {
+			dst->rule_hits[i] += src->rule_hits[i];
+			dst->rule_denials[i] += src->rule_denials[i];
+		}
+	}
+}
@@ -0,0 +1,225 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_timer.h"
+
+#include <assert.h>
+
+static void fsm_timer_unlink(fsm_timer_wheel_t* wheel, fsm_timer_node_t* node) {
+	uint32_t* head = &wheel->heads[node->slot / FSM_TIMER_SLOTS][node->slot % FSM_TIMER_SLOTS];
+	if (node->prev != FSM_TIMER_NONE) {
+		wheel->nodes[node->prev].next = node->next;
+	} else {
+		*head = node->next;
+	}
+	if (node->next != FSM_TIMER_NONE) {
+		wheel->nodes[node->next].prev = node->prev;
+	}
+	node->slot = FSM_TIMER_IDLE;
+}
+
+// Links a node into the slot of its deadline: the lowest level whose span still covers the remaining ticks.
+static void fsm_timer_link(fsm_timer_wheel_t* wheel, uint32_t id) {
+	fsm_timer_node_t* node  = &wheel->nodes[id];
+	uint64_t          tick  = node->deadline > wheel->now ? node->deadline : wheel->now;
+	uint64_t          delta = tick - wheel->now;
+	size_t            level = 0;
+	while (level < FSM_TIMER_LEVELS - 1 && delta >= (1ULL << (FSM_TIMER_SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+	// Beyond the range of the wheel: park in the top-level slot visited last, it is re-linked when cascaded.
+	if (delta >= (1ULL << (FSM_TIMER_SLOT_BITS * FSM_TIMER_LEVELS))) {
+		tick = wheel->now + ((uint64_t)(FSM_TIMER_SLOTS - 1) << (FSM_TIMER_SLOT_BITS * level));
+	}
+	size_t    slot = (size_t)(tick >> (FSM_TIMER_SLOT_BITS * level)) & (FSM_TIMER_SLOTS - 1);
+	uint32_t* head = &wheel->heads[level][slot];
+
+	node->prev = FSM_TIMER_NONE;
+	node->next = *head;
+	node->slot = (uint16_t)(level * FSM_TIMER_SLOTS + slot);
+	if (*head != FSM_TIMER_NONE) {
+		wheel->nodes[*head].prev = id;
+	}
+	*head = id;
+}
+
+static void fsm_timer_observe(void* context, fsm_t* fsm, fsm_state_t from, fsm_state_t to) {
+	fsm_timer_wheel_t* wheel = (fsm_timer_wheel_t*)context;
+	uintptr_t          first = (uintptr_t)wheel->instances;
+	uintptr_t          self  = (uintptr_t)fsm;
+	if (self >= first && self < (uintptr_t)(wheel->instances + wheel->count)) {
+		size_t                  id     = (size_t)(fsm - wheel->instances);
+		const fsm_state_desc_t* states = wheel->def->states;
+		if (states && states[to].timeout) {
+			fsm_timer_arm(wheel, id, states[to].timeout, states[to].timeout_event);
+		} else {
+			fsm_timer_cancel(wheel, id);
+		}
+	}
+	if (wheel->next_observer) {
+		wheel->next_observer(wheel->next_context, fsm, from, to);
+	}
+}
+
+fsm_result_t fsm_timer_init(fsm_timer_wheel_t* wheel, fsm_def_t* def, fsm_t* instances, fsm_timer_node_t* nodes,
+							size_t count, uint64_t now) {
+	if (!wheel || !def || !instances || !nodes || count == 0 || count >= FSM_TIMER_NONE) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (!instances[i].def) {
+			continue;
+		}
+		if (instances[i].def != def || (def->states && instances[i].current_state >= def->state_count)) {
+			return FSM_RESULT_INVALID_PARAMS;
+		}
+	}
+
+	wheel->def           = def;
+	wheel->instances     = instances;
+	wheel->nodes         = nodes;
+	wheel->count         = count;
+	wheel->now           = now;
+	wheel->next_observer = def->observer;
+	wheel->next_context  = def->observer_context;
+	for (size_t level = 0; level < FSM_TIMER_LEVELS; level++) {
+		for (size_t slot = 0; slot < FSM_TIMER_SLOTS; slot++) {
+			wheel->heads[level][slot] = FSM_TIMER_NONE;
+		}
+	}
+	for (size_t i = 0; i < count; i++) {
+		nodes[i].slot = FSM_TIMER_IDLE;
+		if (instances[i].def && def->states && def->states[instances[i].current_state].timeout) {
+			const fsm_state_desc_t* state = &def->states[instances[i].current_state];
+			fsm_timer_arm(wheel, i, state->timeout, state->timeout_event);
+		}
+	}
+	return fsm_def_set_observer(def, fsm_timer_observe, wheel);
+}
+
+fsm_result_t fsm_timer_deinit(fsm_timer_wheel_t* wheel) {
+	if (!wheel || !wheel->def) {
+		return FSM_RESULT_SUCCESS;
+	}
+	// Only the head of the observer chain can be unlinked, observers installed later point at this one.
+	if (wheel->def->observer != fsm_timer_observe || wheel->def->observer_context != wheel) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_def_set_observer(wheel->def, wheel->next_observer, wheel->next_context);
+	wheel->def = NULL;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_timer_arm(fsm_timer_wheel_t* wheel, size_t id, uint64_t ticks, fsm_event_t event) {
+	if (!wheel || id >= wheel->count || ticks == 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_timer_node_t* node = &wheel->nodes[id];
+	if (node->slot != FSM_TIMER_IDLE) {
+		fsm_timer_unlink(wheel, node);
+	}
+	node->deadline = wheel->now + ticks;
+	node->event    = event;
+	fsm_timer_link(wheel, (uint32_t)id);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_timer_cancel(fsm_timer_wheel_t* wheel, size_t id) {
+	if (!wheel || id >= wheel->count) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_timer_node_t* node = &wheel->nodes[id];
+	if (node->slot != FSM_TIMER_IDLE) {
+		fsm_timer_unlink(wheel, node);
+	}
+	return FSM_RESULT_SUCCESS;
+}
+
+// Dispatches the collected expiries. A timeout that could not fire is kept: after a guard denial the timer is
+// re-armed with the timeout of the state, an instance busy with a suspended transition retries on the next tick.
+static size_t fsm_timer_flush(fsm_timer_wheel_t* wheel, size_t pending) {
+	if (pending == 0) {
+		return 0;
+	}
+	fsm_process_events_batch(wheel->batch_instances, wheel->batch_events, NULL, wheel->batch_results, pending);
+	const fsm_state_desc_t* states = wheel->def->states;
+	for (size_t i = 0; i < pending; i++) {
+		fsm_t*       fsm    = wheel->batch_instances[i];
+		fsm_result_t result = wheel->batch_results[i];
+		size_t       id     = (size_t)(fsm - wheel->instances);
+		// An action dispatched earlier in the batch may have armed the timer again.
+		if (wheel->nodes[id].slot != FSM_TIMER_IDLE) {
+			continue;
+		}
+		if (result == FSM_RESULT_BUSY) {
+			fsm_timer_arm(wheel, id, 1, wheel->batch_events[i]);
+		} else if (result == FSM_RESULT_GUARD_DENIED && states && states[fsm->current_state].timeout) {
+			fsm_timer_arm(wheel, id, states[fsm->current_state].timeout, wheel->batch_events[i]);
+		}
+	}
+	return pending;
+}
+
+size_t fsm_tick(fsm_timer_wheel_t* wheel, uint64_t now) {
+	assert(wheel);
+	size_t delivered = 0;
+	while (wheel->now < now) {
+		uint64_t tick = ++wheel->now;
+
+		// Higher levels whose span starts at this tick move their timers down, top level first so a timer can
+		// fall through several levels within the same tick.
+		size_t top = 0;
+		while (top + 1 < FSM_TIMER_LEVELS && (tick & ((1ULL << (FSM_TIMER_SLOT_BITS * (top + 1))) - 1)) == 0) {
+			top++;
+		}
+		for (size_t level = top; level > 0; level--) {
+			uint32_t* head = &wheel->heads[level][(tick >> (FSM_TIMER_SLOT_BITS * level)) & (FSM_TIMER_SLOTS - 1)];
+			while (*head != FSM_TIMER_NONE) {
+				uint32_t id = *head;
+				fsm_timer_unlink(wheel, &wheel->nodes[id]);
+				fsm_timer_link(wheel, id);
+			}
+		}
+
+		// Nodes are popped one at a time, so transitions dispatched mid-slot see a consistent wheel.
+		uint32_t* head    = &wheel->heads[0][tick & (FSM_TIMER_SLOTS - 1)];
+		size_t    pending = 0;
+		while (*head != FSM_TIMER_NONE) {
+			uint32_t          id   = *head;
+			fsm_timer_node_t* node = &wheel->nodes[id];
+			fsm_timer_unlink(wheel, node);
+			// A destroyed instance, such as a freed pool slot, drops its timer.
+			if (!wheel->instances[id].def) {
+				continue;
+			}
+			wheel->batch_instances[pending] = &wheel->instances[id];
+			wheel->batch_events[pending]    = node->event;
+			if (++pending == FSM_TIMER_BATCH) {
+				delivered += fsm_timer_flush(wheel, pending);
+				pending = 0;
+			}
+		}
+		delivered += fsm_timer_flush(wheel, pending);
+	}
+	return delivered;
+}
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_trace.h"
+
+#include "fsm_clock.h"
+
+// The result code has to fit above the event ID in fsm_trace_record_t::event_result.
+typedef char fsm_trace_result_bits_check[FSM_RESULT_COUNT <= (1 << (16 - FSM_TRACE_EVENT_BITS)) ? 1 : -1];
+
+fsm_result_t fsm_trace_init(fsm_trace_ring_t* ring, fsm_trace_record_t* records, size_t capacity,
+							const fsm_t* instances, size_t instance_count) {
+	if (!ring || !records || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	if ((!instances && instance_count > 0) || instance_count >= FSM_TRACE_NO_INSTANCE) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	ring->records        = records;
+	ring->mask           = capacity - 1;
+	ring->head           = 0;
+	ring->instances      = instances;
+	ring->instance_count = instances ? instance_count : 0;
+	return FSM_RESULT_SUCCESS;
+}
+
+size_t fsm_trace_copy(const fsm_trace_ring_t* ring, fsm_trace_record_t* out, size_t capacity) {
+	if (!ring || !out) {
+		return 0;
+	}
+	size_t head  = ring->head;
+	size_t count = head < ring->mask + 1 ? head : ring->mask + 1;
+	if (count > capacity) {
+		count = capacity;
+	}
+	for (size_t i = 0; i < count; i++) {
+		out[i] = ring->records[(head - count + i) & ring->mask];
+	}
+	return count;
+}
+
+fsm_result_t fsm_trace_replay(const fsm_def_t* def, const fsm_trace_record_t* records, size_t count,
+							  fsm_t* instances, size_t instance_count, fsm_trace_replay_report_t* report) {
+	if (!def || (!records && count > 0) || (!instances && instance_count > 0) || !report) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	fsm_trace_ring_t* attached = fsm_trace_current();
+	fsm_trace_attach(NULL);
+
+	report->events     = 0;
+	report->skipped    = 0;
+	report->mismatches = 0;
+	uint64_t start     = fsm_clock_ns();
+	for (size_t i = 0; i < count; i++) {
+		const fsm_trace_record_t* record = &records[i];
+		if (record->instance >= instance_count) {
+			report->skipped++;
+			continue;
+		}
+		fsm_t* self     = &instances[record->instance];
+		int    diverged = 0;
+		if (!self->def) {
+			if (fsm_init(self, def, record->from) != FSM_RESULT_SUCCESS) {
+				report->skipped++;
+				continue;
+			}
+		} else if (self->current_state != record->from) {
+			// Resynchronize so one divergence is not reported again for every later event of the instance.
+			diverged            = 1;
+			self->current_state = record->from;
+		}
+		fsm_result_t result = fsm_process_event(self, FSM_TRACE_RECORD_EVENT(record), NULL);
+		if (diverged || result != FSM_TRACE_RECORD_RESULT(record) || self->current_state != record->to) {
+			report->mismatches++;
+		}
+		report->events++;
+	}
+	report->elapsed_ns     = fsm_clock_ns() - start;
+	report->events_per_sec = report->elapsed_ns ? (double)report->events * 1e9 / (double)report->elapsed_ns : 0.0;
+
+	fsm_trace_attach(attached);
+	return FSM_RESULT_SUCCESS;
+}
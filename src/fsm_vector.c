@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_vector.h"
+
+// The vector kernels work on byte-sized states and events, wide mode uses the scalar kernel only.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(FSM_WIDE)
+#define FSM_VECTOR_X86 1
+#include <immintrin.h>
+#endif
+
+typedef void (*fsm_advance_kernel_t)(const fsm_state_t* table, uint16_t state_count, uint16_t event_count,
+									 fsm_state_t* states, const fsm_event_t* events, size_t count);
+
+static void fsm_advance_scalar(const fsm_state_t* table, uint16_t state_count, uint16_t event_count,
+							   fsm_state_t* states, const fsm_event_t* events, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		fsm_state_t state = states[i];
+		fsm_event_t event = events[i];
+		if (state < state_count && event < event_count) {
+			states[i] = table[(size_t)state * event_count + event];
+		}
+	}
+}
+
+#ifdef FSM_VECTOR_X86
+
+// 8 lanes per step: widen to 32 bits, gather the table words at state * event_count + event and keep
+// their low byte. Lanes with an out-of-range state or event keep their state through the gather mask.
+__attribute__((target("avx2"))) static void fsm_advance_avx2(const fsm_state_t* table, uint16_t state_count,
+															 uint16_t event_count, fsm_state_t* states,
+															 const fsm_event_t* events, size_t count) {
+	const __m256i v_states = _mm256_set1_epi32(state_count);
+	const __m256i v_events = _mm256_set1_epi32(event_count);
+	const __m256i low_byte = _mm256_set1_epi32(0xFF);
+	const __m256i pick     = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  //
+											  0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m256i merge    = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i s     = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(states + i)));
+		__m256i e     = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(events + i)));
+		__m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(v_states, s), _mm256_cmpgt_epi32(v_events, e));
+		__m256i idx   = _mm256_add_epi32(_mm256_mullo_epi32(s, v_events), e);
+		__m256i next  = _mm256_mask_i32gather_epi32(s, (const int*)table, idx, valid, 1);
+		next          = _mm256_shuffle_epi8(_mm256_and_si256(next, low_byte), pick);
+		next          = _mm256_permutevar8x32_epi32(next, merge);
+		_mm_storel_epi64((__m128i*)(states + i), _mm256_castsi256_si128(next));
+	}
+	fsm_advance_scalar(table, state_count, event_count, states + i, events + i, count - i);
+}
+
+// 16 lanes per step for tables with at most 16 events: each state row is a 16-byte shuffle control,
+// looked up with pshufb and blended into the lanes currently in that state.
+__attribute__((target("sse4.1"))) static void fsm_advance_sse41(const fsm_state_t* table, uint16_t state_count,
+																uint16_t event_count, fsm_state_t* states,
+																const fsm_event_t* events, size_t count) {
+	const __m128i v_events = _mm_set1_epi8((char)event_count);
+	const __m128i bias     = _mm_set1_epi8((char)0x80);
+
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m128i s    = _mm_loadu_si128((const __m128i*)(states + i));
+		__m128i e    = _mm_loadu_si128((const __m128i*)(events + i));
+		// Unsigned e < event_count, via a signed compare on biased bytes.
+		__m128i ok   = _mm_cmpgt_epi8(_mm_xor_si128(v_events, bias), _mm_xor_si128(e, bias));
+		__m128i next = s;
+		for (uint16_t state = 0; state < state_count; state++) {
+			__m128i row  = _mm_loadu_si128((const __m128i*)(table + (size_t)state * event_count));
+			__m128i hit  = _mm_and_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8((char)state)), ok);
+			__m128i look = _mm_shuffle_epi8(row, e);
+			next         = _mm_blendv_epi8(next, look, hit);
+		}
+		_mm_storeu_si128((__m128i*)(states + i), next);
+	}
+	fsm_advance_scalar(table, state_count, event_count, states + i, events + i, count - i);
+}
+
+#endif  // FSM_VECTOR_X86
+
+static const fsm_advance_kernel_t fsm_kernels[FSM_KERNEL_COUNT] = {
+	[FSM_KERNEL_SCALAR] = fsm_advance_scalar,
+#ifdef FSM_VECTOR_X86
+	[FSM_KERNEL_SSE41] = fsm_advance_sse41,
+	[FSM_KERNEL_AVX2]  = fsm_advance_avx2,
+#endif
+};
+
+int fsm_kernel_usable(const fsm_def_t* def, fsm_kernel_t kernel) {
+	if (!def || !def->next_table) {
+		return 0;
+	}
+	switch (kernel) {
+	case FSM_KERNEL_SCALAR:
+		return 1;
+#ifdef FSM_VECTOR_X86
+	case FSM_KERNEL_SSE41:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse4.1") && def->event_count <= 16 && def->state_count <= 16;
+	case FSM_KERNEL_AVX2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	default:
+		return 0;
+	}
+}
+
+fsm_result_t fsm_advance_states_kernel(const fsm_def_t* def, fsm_kernel_t kernel, fsm_state_t* states,
+									   const fsm_event_t* events, size_t count) {
+	if (!fsm_kernel_usable(def, kernel) || (count && (!states || !events))) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_kernels[kernel](def->next_table, def->state_count, def->event_count, states, events, count);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_advance_states(const fsm_def_t* def, fsm_state_t* states, const fsm_event_t* events, size_t count) {
+	fsm_kernel_t kernel = FSM_KERNEL_AVX2;
+	while (kernel != FSM_KERNEL_SCALAR && !fsm_kernel_usable(def, kernel)) {
+		kernel = (fsm_kernel_t)(kernel - 1);
+	}
+	return fsm_advance_states_kernel(def, kernel, states, events, count);
+}
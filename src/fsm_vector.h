@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_VECTOR_H
+#define FSM_VECTOR_H
+
+#include "fsm.h"
+
+// Kernels behind fsm_advance_states(), which picks the fastest one the CPU and table allow. Forcing a
+// kernel lets checks compare each of them with the scalar reference.
+typedef enum {
+	FSM_KERNEL_SCALAR,  ///< Portable loop, always available.
+	FSM_KERNEL_SSE41,   ///< pshufb row lookup, x86 with SSE4.1, up to 16 states and 16 events.
+	FSM_KERNEL_AVX2,    ///< 32-bit gathers, x86 with AVX2.
+	FSM_KERNEL_COUNT,
+} fsm_kernel_t;
+
+/**
+ * @brief Whether a kernel can run a definition's next-state table on this CPU.
+ * @param def Pointer to a definition with a next-state table.
+ * @param kernel Kernel to check.
+ * @return Non-zero if fsm_advance_states_kernel() accepts the kernel, 0 otherwise.
+ */
+int fsm_kernel_usable(const fsm_def_t* def, fsm_kernel_t kernel);
+
+/**
+ * @brief fsm_advance_states() with a forced kernel.
+ *
+ * @param def Pointer to a definition with a next-state table.
+ * @param kernel Kernel to run, see fsm_kernel_usable().
+ * @param states Array of count states, advanced in place.
+ * @param events Array of count events.
+ * @param count Number of lanes.
+ * @return FSM_RESULT_SUCCESS on success, FSM_RESULT_INVALID_PARAMS on invalid parameters or an unusable kernel.
+ */
+fsm_result_t fsm_advance_states_kernel(const fsm_def_t* def, fsm_kernel_t kernel, fsm_state_t* states,
+									   const fsm_event_t* events, size_t count);
+
+#endif  // FSM_VECTOR_H
@@ -0,0 +1,199 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_version.h"
+
+#include <assert.h>
+
+#include "fsm_atomic.h"
+
+// Instances point at the definition embedded first in their version.
+static inline fsm_version_t* fsm_version_of(const fsm_def_t* def) {
+	return (fsm_version_t*)(void*)def;
+}
+
+// Readers start online at the initial epoch, which is never FSM_VERSIONS_OFFLINE.
+#define FSM_VERSIONS_FIRST_EPOCH 1
+
+fsm_result_t fsm_versions_init(fsm_versions_t* versions, fsm_version_t* initial, fsm_versions_reader_t* readers,
+							   size_t reader_count) {
+	if (!versions || !initial || !initial->def.transition_rules || (reader_count && !readers)) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	initial->next          = NULL;
+	initial->number        = 1;
+	initial->retired_epoch = 0;
+	initial->instances     = 0;
+	for (size_t i = 0; i < reader_count; i++) {
+		readers[i].epoch = FSM_VERSIONS_FIRST_EPOCH;
+	}
+	versions->current      = initial;
+	versions->oldest       = initial;
+	versions->readers      = readers;
+	versions->reader_count = reader_count;
+	versions->epoch        = FSM_VERSIONS_FIRST_EPOCH;
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_versions_publish(fsm_versions_t* versions, fsm_version_t* version) {
+	if (!versions || !version || !version->def.transition_rules || version == versions->current) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+
+	// Only the publisher writes current, so reading it plainly is fine here.
+	fsm_version_t* previous = versions->current;
+	version->next           = NULL;
+	version->number         = previous->number + 1;
+	version->retired_epoch  = 0;
+	version->instances      = 0;
+	previous->next          = version;
+	FSM_ATOMIC_STORE_PTR_RELEASE(&versions->current, version);
+
+	// Readers announcing this epoch or a later one have seen the new version.
+	previous->retired_epoch = FSM_ATOMIC_FETCH_ADD(&versions->epoch, 1) + 1;
+	fsm_versions_reclaim(versions);
+	return FSM_RESULT_SUCCESS;
+}
+
+size_t fsm_versions_reclaim(fsm_versions_t* versions) {
+	assert(versions);
+	// Pairs with the fence of a reader coming back online: either it is seen online here, or it has seen
+	// the latest epoch.
+	FSM_ATOMIC_FENCE();
+	size_t horizon = FSM_ATOMIC_LOAD_RELAXED(&versions->epoch);
+	for (size_t i = 0; i < versions->reader_count; i++) {
+		size_t epoch = FSM_ATOMIC_LOAD_ACQUIRE(&versions->readers[i].epoch);
+		if (epoch != FSM_VERSIONS_OFFLINE && epoch < horizon) {
+			horizon = epoch;
+		}
+	}
+
+	// Oldest first, so the versions between an instance's version and the current one keep their remaps.
+	size_t released = 0;
+	while (versions->oldest != versions->current && versions->oldest->retired_epoch <= horizon &&
+		   FSM_ATOMIC_LOAD_ACQUIRE(&versions->oldest->instances) == 0) {
+		fsm_version_t* version = versions->oldest;
+		versions->oldest       = version->next;
+		if (version->release) {
+			version->release(version->release_context, version);
+		}
+		released++;
+	}
+	return released;
+}
+
+const fsm_version_t* fsm_versions_current(const fsm_versions_t* versions) {
+	assert(versions);
+	return (const fsm_version_t*)FSM_ATOMIC_LOAD_PTR_ACQUIRE(&versions->current);
+}
+
+void fsm_versions_quiescent(fsm_versions_t* versions, size_t reader) {
+	assert(versions && reader < versions->reader_count);
+	size_t* slot      = &versions->readers[reader].epoch;
+	size_t  announced = FSM_ATOMIC_LOAD_RELAXED(slot);
+	size_t  epoch     = FSM_ATOMIC_LOAD_ACQUIRE(&versions->epoch);
+	if (announced != FSM_VERSIONS_OFFLINE) {
+		if (announced != epoch) {
+			FSM_ATOMIC_STORE_RELEASE(slot, epoch);
+		}
+		return;
+	}
+	// Coming back online: a publisher that missed the slot must not have advanced the epoch unseen.
+	for (;;) {
+		FSM_ATOMIC_STORE_RELEASE(slot, epoch);
+		FSM_ATOMIC_FENCE();
+		size_t latest = FSM_ATOMIC_LOAD_ACQUIRE(&versions->epoch);
+		if (latest == epoch) {
+			break;
+		}
+		epoch = latest;
+	}
+}
+
+void fsm_versions_offline(fsm_versions_t* versions, size_t reader) {
+	assert(versions && reader < versions->reader_count);
+	FSM_ATOMIC_STORE_RELEASE(&versions->readers[reader].epoch, FSM_VERSIONS_OFFLINE);
+}
+
+fsm_result_t fsm_versions_attach(fsm_versions_t* versions, fsm_t* self, fsm_state_t initial_state) {
+	if (!versions || !self) {
+		return FSM_RESULT_INVALID_PARAMS;
+	}
+	fsm_version_t* current = (fsm_version_t*)FSM_ATOMIC_LOAD_PTR_ACQUIRE(&versions->current);
+	fsm_result_t   result  = fsm_init(self, &current->def, initial_state);
+	if (result == FSM_RESULT_SUCCESS) {
+		FSM_ATOMIC_FETCH_ADD(&current->instances, 1);
+	}
+	return result;
+}
+
+void fsm_versions_detach(fsm_versions_t* versions, fsm_t* self) {
+	assert(versions && self && self->def);
+	(void)versions;
+	FSM_ATOMIC_FETCH_ADD(&fsm_version_of(self->def)->instances, (size_t)-1);
+	self->def = NULL;
+}
+
+// Moves an instance from its version to current, which the caller has loaded.
+static fsm_result_t fsm_versions_move(fsm_t* self, fsm_version_t* current) {
+	if (self->pending_step) {
+		return FSM_RESULT_BUSY;
+	}
+	// The instance keeps its version alive, and with it every later version up to current.
+	fsm_version_t* from  = fsm_version_of(self->def);
+	fsm_state_t    state = self->current_state;
+	for (fsm_version_t* version = from; version != current;) {
+		version = version->next;
+		if (version->remap) {
+			state = version->remap(version->remap_context, state);
+		}
+		if (version->def.state_count && state >= version->def.state_count) {
+			return FSM_RESULT_STATE_OUT_OF_BOUNDS;
+		}
+	}
+
+	FSM_ATOMIC_FETCH_ADD(&current->instances, 1);
+	self->def           = &current->def;
+	self->current_state = state;
+	FSM_ATOMIC_FETCH_ADD(&from->instances, (size_t)-1);
+	return FSM_RESULT_SUCCESS;
+}
+
+fsm_result_t fsm_versions_migrate(fsm_versions_t* versions, fsm_t* self) {
+	assert(versions && self && self->def);
+	fsm_version_t* current = (fsm_version_t*)FSM_ATOMIC_LOAD_PTR_ACQUIRE(&versions->current);
+	return self->def == &current->def ? FSM_RESULT_SUCCESS : fsm_versions_move(self, current);
+}
+
+fsm_result_t fsm_versions_process(fsm_versions_t* versions, fsm_t* self, fsm_event_t event, void* data) {
+	assert(versions && self && self->def);
+	fsm_version_t* current = (fsm_version_t*)FSM_ATOMIC_LOAD_PTR_ACQUIRE(&versions->current);
+	if (self->def != &current->def) {
+		fsm_result_t result = fsm_versions_move(self, current);
+		if (result == FSM_RESULT_STATE_OUT_OF_BOUNDS) {
+			return result;
+		}
+	}
+	return fsm_process_event(self, event, data);
+}
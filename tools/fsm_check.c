@@ -0,0 +1,264 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fsm.h"
+#include "fsm_analyze.h"
+#include "fsm_spec.h"
+
+/**
+ * Transition table checker for CI.
+ *
+ * Loads machine specs (see fsm_spec.h), runs fsm_def_analyze() on each and reports the findings in the
+ * usual "file:line: severity: message" form. Shadowed rules and unreachable states are errors; partially
+ * shadowed rules, dead-end states and unhandled events are warnings.
+ *
+ * Usage: fsm_check [-W] [-O] [-P hits] spec...
+ *   -W  treat warnings as errors
+ *   -O  print the optimized rule set (fsm_def_optimize()) of each spec
+ *   -P  print the rule set of each fall-through spec reordered (fsm_def_reorder()) by the profile in hits,
+ *       one hit count per rule in spec order, as collected in fsm_stats_t::rule_hits
+ *
+ * Exit status: 0 when clean, 1 when findings fail the check, 2 when a spec cannot be loaded.
+ */
+
+static void check_print_rule(const fsm_spec_t* spec, const fsm_spec_rule_t* rule, const fsm_transition_t* mask) {
+	printf("on %s from", spec->events[rule->event]);
+	for (size_t state = 0; state < spec->state_count; state++) {
+		if (mask ? FSM_STATE_IN_MASK(state, mask->source_states_mask) : rule->sources[state]) {
+			printf(" %s", spec->states[state].name);
+		}
+	}
+	printf(" to %s", spec->states[rule->target].name);
+	if (rule->guard[0]) {
+		printf(" guard=%s", rule->guard);
+	}
+	if (rule->on_entry[0]) {
+		printf(" entry=%s", rule->on_entry);
+	}
+	if (rule->on_exit[0]) {
+		printf(" exit=%s", rule->on_exit);
+	}
+}
+
+static void check_rule(const char* path, const fsm_spec_t* spec, size_t i, const char* severity, const char* what) {
+	printf("%s:%d: %s: rule '", path, spec->rules[i].line, severity);
+	check_print_rule(spec, &spec->rules[i], NULL);
+	printf("' %s\n", what);
+}
+
+// Prints the findings of an analysis, returns the number of errors and adds its warnings to *warnings.
+static size_t check_report(const char* path, const fsm_spec_t* spec, const fsm_analysis_t* analysis,
+						   const uint8_t* rule_flags, size_t* warnings) {
+	size_t errors = 0;
+	for (size_t i = 0; i < spec->rule_count; i++) {
+		if (rule_flags[i] & (FSM_RULE_SHADOWED | FSM_RULE_NO_SOURCE)) {
+			check_rule(path, spec, i, "error", "never fires, its source states are taken by earlier rules");
+			errors++;
+		} else if (rule_flags[i] & FSM_RULE_PARTIALLY_SHADOWED) {
+			check_rule(path, spec, i, "warning", "is partially shadowed by earlier rules");
+			(*warnings)++;
+		}
+	}
+	for (size_t state = 0; state < spec->state_count; state++) {
+		const fsm_spec_state_t* desc = &spec->states[state];
+		if (analysis->state_flags[state] & FSM_STATE_UNREACHABLE) {
+			printf("%s:%d: error: state '%s' is unreachable from '%s'\n", path, desc->line, desc->name,
+				   spec->states[spec->initial].name);
+			errors++;
+		}
+		if (analysis->state_flags[state] & FSM_STATE_DEAD_END) {
+			printf("%s:%d: warning: state '%s' is a dead end\n", path, desc->line, desc->name);
+			(*warnings)++;
+		}
+	}
+	for (size_t event = 0; event < spec->event_count; event++) {
+		if (analysis->event_coverage[event] == 0) {
+			printf("%s: warning: event '%s' is not handled in any state\n", path, spec->events[event]);
+			(*warnings)++;
+		}
+	}
+	printf("%s: %zu states, %zu events, %zu rules, %zu of %zu (state, event) pairs handled\n", path,
+		   spec->state_count, spec->event_count, spec->rule_count, analysis->handled_pairs,
+		   spec->state_count * spec->event_count);
+	return errors;
+}
+
+// Reads the hit counts of a profile, returns 0 when it holds exactly count of them.
+static int check_load_profile(const char* path, uint64_t* hits, size_t count) {
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		return -1;
+	}
+	size_t             loaded = 0;
+	unsigned long long value;
+	while (fscanf(file, "%llu", &value) == 1) {
+		if (loaded < count) {
+			hits[loaded] = (uint64_t)value;
+		}
+		loaded++;
+	}
+	int complete = feof(file) && loaded == count;
+	fclose(file);
+	return complete ? 0 : -1;
+}
+
+// Reorders the rules of a fall-through spec by a profile and prints them.
+static fsm_result_t check_reorder(const char* path, const fsm_spec_t* spec, const fsm_def_t* def,
+								  const char* profile_path, fsm_transition_t* rules, size_t* origins) {
+	size_t       count     = spec->rule_count;
+	uint64_t*    hits      = (uint64_t*)malloc(count * sizeof(uint64_t));
+	uint64_t*    denials   = (uint64_t*)malloc(count * sizeof(uint64_t));
+	fsm_stats_t* profile   = (fsm_stats_t*)malloc(sizeof(fsm_stats_t));
+	size_t       reordered = 0;
+	fsm_result_t result    = FSM_RESULT_INVALID_PARAMS;
+
+	if (hits && denials && profile) {
+		result = fsm_stats_init(profile, def, hits, denials, count);
+	}
+	if (result == FSM_RESULT_SUCCESS && check_load_profile(profile_path, hits, count) != 0) {
+		printf("%s: error: '%s' does not hold one hit count per rule\n", path, profile_path);
+		result = FSM_RESULT_INVALID_PARAMS;
+	} else if (result == FSM_RESULT_SUCCESS) {
+		result = fsm_def_reorder(def, profile, rules, origins, count, &reordered);
+	}
+	if (result == FSM_RESULT_SUCCESS) {
+		printf("# %s: %zu reordered rules\n", path, reordered);
+		for (size_t i = 0; i < reordered; i++) {
+			check_print_rule(spec, &spec->rules[origins[i]], &rules[i]);
+			printf("\n");
+		}
+	}
+
+	free(hits);
+	free(denials);
+	free(profile);
+	return result;
+}
+
+// Checks one spec, returns the number of errors and adds its warnings to *warnings.
+static size_t check_spec(const char* path, const fsm_spec_t* spec, int optimize, const char* profile,
+						 size_t* warnings) {
+	size_t            count      = spec->rule_count;
+	size_t            index_size = FSM_INDEX_SIZE(spec->state_count, spec->event_count);
+	fsm_transition_t* rules      = (fsm_transition_t*)malloc(count * sizeof(fsm_transition_t));
+	fsm_transition_t* optimized  = (fsm_transition_t*)malloc(count * sizeof(fsm_transition_t));
+	size_t*           origins    = (size_t*)malloc(count * sizeof(size_t));
+	uint8_t*          rule_flags = (uint8_t*)malloc(count);
+	uint16_t*         index      = (uint16_t*)malloc(index_size * sizeof(uint16_t));
+	uint16_t*         chain      = (uint16_t*)malloc(FSM_CHAIN_SIZE(spec->state_count, count) * sizeof(uint16_t));
+	fsm_analysis_t*   analysis   = (fsm_analysis_t*)malloc(sizeof(fsm_analysis_t));
+	size_t            errors     = 0;
+	size_t            rule_count = 0;
+	fsm_result_t      result     = FSM_RESULT_INVALID_PARAMS;
+	fsm_def_t         def;
+
+	if (rules && optimized && origins && rule_flags && index && chain && analysis) {
+		fsm_spec_transitions(spec, rules);
+		result = fsm_def_init(&def, rules, count);
+		if (result == FSM_RESULT_SUCCESS) {
+			result = fsm_def_compile(&def, index, index_size, (uint16_t)spec->state_count, (uint16_t)spec->event_count);
+		}
+		if (result == FSM_RESULT_SUCCESS && spec->fallthrough) {
+			result = fsm_def_set_fallthrough(&def, chain, FSM_CHAIN_SIZE(spec->state_count, count));
+		}
+		if (result == FSM_RESULT_SUCCESS) {
+			result = fsm_def_analyze(&def, spec->initial, analysis, rule_flags);
+		}
+		if (result == FSM_RESULT_SUCCESS && optimize) {
+			result = fsm_def_optimize(&def, optimized, origins, count, &rule_count);
+		}
+	}
+
+	if (result != FSM_RESULT_SUCCESS) {
+		printf("%s: error: %s\n", path, fsm_result_string(result));
+		errors++;
+	} else {
+		errors = check_report(path, spec, analysis, rule_flags, warnings);
+	}
+	if (result == FSM_RESULT_SUCCESS && optimize) {
+		printf("# %s: %zu optimized rules\n", path, rule_count);
+		for (size_t i = 0; i < rule_count; i++) {
+			check_print_rule(spec, &spec->rules[origins[i]], &optimized[i]);
+			printf("\n");
+		}
+	}
+	if (result == FSM_RESULT_SUCCESS && profile && !spec->fallthrough) {
+		printf("%s: error: reordering needs a 'fallthrough' spec\n", path);
+		errors++;
+	} else if (result == FSM_RESULT_SUCCESS && profile &&
+			   check_reorder(path, spec, &def, profile, optimized, origins) != FSM_RESULT_SUCCESS) {
+		errors++;
+	}
+
+	free(rules);
+	free(optimized);
+	free(origins);
+	free(rule_flags);
+	free(index);
+	free(chain);
+	free(analysis);
+	return errors;
+}
+
+int main(int argc, char** argv) {
+	const char* profile  = NULL;
+	int         strict   = 0;
+	int         optimize = 0;
+	int         failed   = 0;
+	int         specs    = 0;
+	size_t      warnings = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-W") == 0) {
+			strict = 1;
+		} else if (strcmp(argv[i], "-O") == 0) {
+			optimize = 1;
+		} else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+			profile = argv[++i];
+		}
+	}
+	for (int i = 1; i < argc; i++) {
+		if (argv[i][0] == '-') {
+			i += strcmp(argv[i], "-P") == 0;
+			continue;
+		}
+		char       error[256];
+		fsm_spec_t spec;
+		specs++;
+		if (fsm_spec_load(&spec, argv[i], error, sizeof(error)) != 0) {
+			printf("%s\n", error);
+			return 2;
+		}
+		failed |= check_spec(argv[i], &spec, optimize, profile, &warnings) > 0;
+		fsm_spec_free(&spec);
+	}
+	if (specs == 0) {
+		printf("Usage: %s [-W] [-O] [-P hits] spec...\n", argv[0]);
+		return 2;
+	}
+	return failed || (strict && warnings > 0) ? 1 : 0;
+}
@@ -0,0 +1,393 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "fsm.h"
+#include "fsm_spec.h"
+
+/**
+ * Code generator for machine specs (see fsm_spec.h).
+ *
+ * Writes <spec>_fsm.h and <spec>_fsm.c next to each other. They hold state and event enums, the
+ * fsm_transition_t and fsm_state_desc_t tables for the generic dispatcher, a <machine>_def_init() that
+ * compiles them, and a <machine>_dispatch() made of nested switch statements that calls guards and
+ * actions directly. Callbacks named in the spec are declared extern and implemented by the application.
+ *
+ * Usage: fsm_gen [-o output_dir] spec
+ */
+
+#define GEN_PATH_MAX 1024
+
+typedef struct gen {
+	const fsm_spec_t* spec;                      ///< Spec being generated.
+	char              base[FSM_SPEC_NAME_MAX];   ///< Output file base name, e.g. vending_machine_fsm.
+	char              lower[FSM_SPEC_NAME_MAX];  ///< Symbol prefix, the machine name.
+	char              upper[FSM_SPEC_NAME_MAX];  ///< Constant prefix, the upper-case machine name.
+	const char*       source;                    ///< Spec file name, for the generated banner.
+} gen_t;
+
+// Index of the rule dispatch selects for a (state, event) pair, following first-match-wins, or -1.
+static int gen_rule_for(const fsm_spec_t* spec, size_t state, size_t event) {
+	for (size_t i = 0; i < spec->rule_count; i++) {
+		if (spec->rules[i].event == event && spec->rules[i].sources[state]) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+// Index of the candidate tried after rule i denies in a fall-through spec, or -1.
+static int gen_next_rule(const fsm_spec_t* spec, size_t state, size_t i) {
+	if (!spec->fallthrough || !spec->rules[i].guard[0]) {
+		return -1;
+	}
+	for (size_t j = i + 1; j < spec->rule_count; j++) {
+		if (spec->rules[j].event == spec->rules[i].event && spec->rules[j].sources[state]) {
+			return (int)j;
+		}
+	}
+	return -1;
+}
+
+static int gen_has_state_actions(const fsm_spec_t* spec) {
+	for (size_t i = 0; i < spec->state_count; i++) {
+		if (spec->states[i].on_entry[0] || spec->states[i].on_exit[0]) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Callback name of slot k: the entry and exit action of each state, then the guard, entry and exit action of
+// each rule. Sets *guard for guard slots.
+static const char* gen_callback(const fsm_spec_t* spec, size_t k, int* guard) {
+	*guard = 0;
+	if (k < spec->state_count * 2) {
+		const fsm_spec_state_t* state = &spec->states[k / 2];
+		return k % 2 ? state->on_exit : state->on_entry;
+	}
+	k -= spec->state_count * 2;
+	const fsm_spec_rule_t* rule = &spec->rules[k / 3];
+	*guard                      = k % 3 == 0;
+	return k % 3 == 0 ? rule->guard : k % 3 == 1 ? rule->on_entry : rule->on_exit;
+}
+
+static void gen_mask(FILE* out, const fsm_spec_rule_t* rule) {
+	uint64_t words[(FSM_MAX_STATES + 63) / 64] = {0};
+	for (size_t state = 0; state < FSM_MAX_STATES; state++) {
+		if (rule->sources[state]) {
+			words[state / 64] |= 1ULL << (state % 64);
+		}
+	}
+#ifdef FSM_WIDE
+	fprintf(out, "{");
+	for (size_t i = 0; i < FSM_MASK_WORDS; i++) {
+		fprintf(out, "%s0x%llxull", i ? ", " : "", (unsigned long long)words[i]);
+	}
+	fprintf(out, "}");
+#else
+	fprintf(out, "0x%08lxu", (unsigned long)words[0]);
+#endif
+}
+
+static void gen_header(const gen_t* gen, FILE* out) {
+	const fsm_spec_t* spec = gen->spec;
+	char              guard[FSM_SPEC_NAME_MAX] = {0};
+	for (size_t i = 0; gen->base[i]; i++) {
+		guard[i] = (char)toupper((unsigned char)gen->base[i]);
+	}
+
+	fprintf(out, "// Generated by fsm_gen from %s, do not edit.\n", gen->source);
+	fprintf(out, "#ifndef %s_H\n#define %s_H\n\n#include \"fsm.h\"\n\n", guard, guard);
+#ifdef FSM_WIDE
+	fprintf(out, "#if !defined(FSM_WIDE) || FSM_MASK_WORDS != %d\n", FSM_MASK_WORDS);
+	fprintf(out, "#error \"%s.h was generated for FSM_WIDE_MODE=ON with %d states\"\n#endif\n\n", gen->base,
+			FSM_MAX_STATES);
+#else
+	fprintf(out, "#ifdef FSM_WIDE\n#error \"%s.h was generated for FSM_WIDE_MODE=OFF\"\n#endif\n\n", gen->base);
+#endif
+	fprintf(out, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n");
+
+	fprintf(out, "typedef enum {\n");
+	for (size_t i = 0; i < spec->state_count; i++) {
+		fprintf(out, "\t%s_STATE_%s,\n", gen->upper, spec->states[i].name);
+	}
+	fprintf(out, "\t%s_STATE_COUNT,\n} %s_state_t;\n\n", gen->upper, gen->lower);
+	fprintf(out, "typedef enum {\n");
+	for (size_t i = 0; i < spec->event_count; i++) {
+		fprintf(out, "\t%s_EVENT_%s,\n", gen->upper, spec->events[i]);
+	}
+	fprintf(out, "\t%s_EVENT_COUNT,\n} %s_event_t;\n\n", gen->upper, gen->lower);
+	fprintf(out, "#define %s_INITIAL_STATE    %s_STATE_%s\n", gen->upper, gen->upper,
+			spec->states[spec->initial].name);
+	fprintf(out, "#define %s_TRANSITION_COUNT %zu\n\n", gen->upper, spec->rule_count);
+
+	fprintf(out, "extern const char* const      %s_state_names[%s_STATE_COUNT];\n", gen->lower, gen->upper);
+	fprintf(out, "extern const char* const      %s_event_names[%s_EVENT_COUNT];\n", gen->lower, gen->upper);
+	fprintf(out, "extern const fsm_transition_t %s_transitions[%s_TRANSITION_COUNT];\n", gen->lower, gen->upper);
+	fprintf(out, "extern const fsm_state_desc_t %s_states[%s_STATE_COUNT];\n\n", gen->lower, gen->upper);
+
+	fprintf(out, "// Callbacks named in %s, implemented by the application.\n", gen->source);
+	size_t slots = spec->state_count * 2 + spec->rule_count * 3;
+	for (size_t k = 0; k < slots; k++) {
+		int         guard;
+		int         seen = 0;
+		const char* name = gen_callback(spec, k, &guard);
+		for (size_t j = 0; j < k && name[0] && !seen; j++) {
+			int other;
+			seen = strcmp(gen_callback(spec, j, &other), name) == 0;
+		}
+		if (name[0] && !seen) {
+			fprintf(out, "%s %s(fsm_t* fsm, void* data);\n", guard ? "int" : "void", name);
+		}
+	}
+	fprintf(out, "\n/**\n * @brief Initializes and compiles a definition from the generated tables.\n");
+	fprintf(out, " * @param def Pointer to the definition to initialize.\n");
+	fprintf(out, " * @return FSM_RESULT_SUCCESS on success, an error code otherwise.\n */\n");
+	fprintf(out, "fsm_result_t %s_def_init(fsm_def_t* def);\n\n", gen->lower);
+	fprintf(out, "/**\n * @brief Dispatches an event with code specialized for this machine.\n");
+	fprintf(out, " * @note Equivalent to fsm_process_event() on a definition from %s_def_init(), including\n",
+			gen->lower);
+	fprintf(out, " * the observer of self->def when there is one, but without statistics, trace, hierarchy or\n");
+	fprintf(out, " * fsm_suspend() support. self->def may be NULL.\n");
+	fprintf(out, " * @param self Pointer to the FSM instance.\n * @param event Event to process.\n");
+	fprintf(out, " * @param data Optional data passed to the guard and actions.\n");
+	fprintf(out, " * @return Same result code as fsm_process_event().\n */\n");
+	fprintf(out, "fsm_result_t %s_dispatch(fsm_t* self, fsm_event_t event, void* data);\n\n", gen->lower);
+	fprintf(out, "#ifdef __cplusplus\n}\n#endif\n#endif  // %s_H\n", guard);
+}
+
+// Writes the actions and state change of a selected rule, indented by depth tabs.
+static void gen_transition(const gen_t* gen, FILE* out, const fsm_spec_state_t* source, const fsm_spec_rule_t* rule,
+						   int depth) {
+	const char*             tabs   = "\t\t\t\t\t\t\t\t";
+	const fsm_spec_state_t* target = &gen->spec->states[rule->target];
+	if (source->on_exit[0]) {
+		fprintf(out, "%.*s%s(self, data);\n", depth, tabs, source->on_exit);
+	}
+	if (rule->on_exit[0]) {
+		fprintf(out, "%.*s%s(self, data);\n", depth, tabs, rule->on_exit);
+	}
+	fprintf(out, "%.*sto                  = %s_STATE_%s;\n", depth, tabs, gen->upper, target->name);
+	fprintf(out, "%.*sself->current_state = to;\n", depth, tabs);
+	if (rule->on_entry[0]) {
+		fprintf(out, "%.*s%s(self, data);\n", depth, tabs, rule->on_entry);
+	}
+	if (target->on_entry[0]) {
+		fprintf(out, "%.*s%s(self, data);\n", depth, tabs, target->on_entry);
+	}
+}
+
+static void gen_source(const gen_t* gen, FILE* out) {
+	const fsm_spec_t* spec = gen->spec;
+	const char*       u    = gen->upper;
+	const char*       l    = gen->lower;
+
+	fprintf(out, "// Generated by fsm_gen from %s, do not edit.\n", gen->source);
+	fprintf(out, "#include \"%s.h\"\n\n", gen->base);
+
+	fprintf(out, "const char* const %s_state_names[%s_STATE_COUNT] = {\n", l, u);
+	for (size_t i = 0; i < spec->state_count; i++) {
+		fprintf(out, "\t\"%s\",\n", spec->states[i].name);
+	}
+	fprintf(out, "};\n\nconst char* const %s_event_names[%s_EVENT_COUNT] = {\n", l, u);
+	for (size_t i = 0; i < spec->event_count; i++) {
+		fprintf(out, "\t\"%s\",\n", spec->events[i]);
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "const fsm_transition_t %s_transitions[%s_TRANSITION_COUNT] = {\n", l, u);
+	for (size_t i = 0; i < spec->rule_count; i++) {
+		const fsm_spec_rule_t* rule = &spec->rules[i];
+		fprintf(out, "\t{\n");
+		fprintf(out, "\t\t.guard              = %s,\n", rule->guard[0] ? rule->guard : "NULL");
+		fprintf(out, "\t\t.on_exit            = %s,\n", rule->on_exit[0] ? rule->on_exit : "NULL");
+		fprintf(out, "\t\t.on_entry           = %s,\n", rule->on_entry[0] ? rule->on_entry : "NULL");
+		fprintf(out, "\t\t.source_states_mask = ");
+		gen_mask(out, rule);
+		fprintf(out, ",  //");
+		for (size_t state = 0; state < spec->state_count; state++) {
+			if (rule->sources[state]) {
+				fprintf(out, " %s", spec->states[state].name);
+			}
+		}
+		fprintf(out, "\n\t\t.target_state       = %s_STATE_%s,\n", u, spec->states[rule->target].name);
+		fprintf(out, "\t\t.event              = %s_EVENT_%s,\n", u, spec->events[rule->event]);
+		fprintf(out, "\t},\n");
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "const fsm_state_desc_t %s_states[%s_STATE_COUNT] = {\n", l, u);
+	if (!gen_has_state_actions(spec)) {
+		fprintf(out, "\t{0},\n");
+	}
+	for (size_t i = 0; i < spec->state_count; i++) {
+		const fsm_spec_state_t* state = &spec->states[i];
+		if (state->on_entry[0] || state->on_exit[0]) {
+			fprintf(out, "\t[%s_STATE_%s] = {.on_entry = %s, .on_exit = %s},\n", u, state->name,
+					state->on_entry[0] ? state->on_entry : "NULL", state->on_exit[0] ? state->on_exit : "NULL");
+		}
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "fsm_result_t %s_def_init(fsm_def_t* def) {\n", l);
+	fprintf(out, "\tstatic uint16_t index[FSM_INDEX_SIZE(%s_STATE_COUNT, %s_EVENT_COUNT)];\n", u, u);
+	if (spec->fallthrough) {
+		fprintf(out, "\tstatic uint16_t chain[FSM_CHAIN_SIZE(%s_STATE_COUNT, %s_TRANSITION_COUNT)];\n", u, u);
+	}
+	fprintf(out, "\tfsm_result_t    result = fsm_def_init(def, %s_transitions, %s_TRANSITION_COUNT);\n", l, u);
+	fprintf(out, "\tif (result == FSM_RESULT_SUCCESS) {\n");
+	fprintf(out, "\t\tresult = fsm_def_compile(def, index, FSM_INDEX_SIZE(%s_STATE_COUNT, %s_EVENT_COUNT), "
+				 "%s_STATE_COUNT,\n\t\t\t\t\t\t\t\t %s_EVENT_COUNT);\n\t}\n",
+			u, u, u, u);
+	if (spec->fallthrough) {
+		fprintf(out, "\tif (result == FSM_RESULT_SUCCESS) {\n");
+		fprintf(out, "\t\tresult = fsm_def_set_fallthrough(def, chain, FSM_CHAIN_SIZE(%s_STATE_COUNT, "
+					 "%s_TRANSITION_COUNT));\n\t}\n",
+				u, u);
+	}
+	if (gen_has_state_actions(spec)) {
+		fprintf(out, "\tif (result == FSM_RESULT_SUCCESS) {\n");
+		fprintf(out, "\t\tresult = fsm_def_set_states(def, %s_states, %s_STATE_COUNT);\n\t}\n", l, u);
+	}
+	fprintf(out, "\treturn result;\n}\n\n");
+
+	fprintf(out, "fsm_result_t %s_dispatch(fsm_t* self, fsm_event_t event, void* data) {\n", l);
+	fprintf(out, "\tfsm_state_t from = self->current_state;\n\tfsm_state_t to;\n");
+	int callbacks = 0;
+	for (size_t k = 0; k < spec->state_count * 2 + spec->rule_count * 3; k++) {
+		int guard;
+		callbacks |= gen_callback(spec, k, &guard)[0] != '\0';
+	}
+	if (!callbacks) {
+		fprintf(out, "\t(void)data;\n");
+	}
+	fprintf(out, "\tif (self->pending_step) {\n\t\treturn FSM_RESULT_BUSY;\n\t}\n");
+	fprintf(out, "\tif (event >= %s_EVENT_COUNT) {\n\t\treturn FSM_RESULT_EVENT_OUT_OF_BOUNDS;\n\t}\n", u);
+	fprintf(out, "\tswitch (from) {\n");
+	for (size_t state = 0; state < spec->state_count; state++) {
+		const fsm_spec_state_t* source  = &spec->states[state];
+		int                     handled = 0;
+		fprintf(out, "\t\tcase %s_STATE_%s:\n", u, source->name);
+		for (size_t event = 0; event < spec->event_count; event++) {
+			int i = gen_rule_for(spec, state, event);
+			if (i < 0) {
+				continue;
+			}
+			const fsm_spec_rule_t* rule = &spec->rules[i];
+			if (!handled) {
+				fprintf(out, "\t\t\tswitch (event) {\n");
+				handled = 1;
+			}
+			fprintf(out, "\t\t\t\tcase %s_EVENT_%s:\n", u, spec->events[event]);
+			// Fall-through candidates that may still deny each take the transition from their own branch.
+			int next = gen_next_rule(spec, state, (size_t)i);
+			for (; next >= 0; i = next, rule = &spec->rules[i], next = gen_next_rule(spec, state, (size_t)i)) {
+				fprintf(out, "\t\t\t\t\tif (%s(self, data) == 0) {\n", rule->guard);
+				gen_transition(gen, out, source, rule, 6);
+				fprintf(out, "\t\t\t\t\t\tbreak;\n\t\t\t\t\t}\n");
+			}
+			if (rule->guard[0]) {
+				fprintf(out, "\t\t\t\t\tif (%s(self, data) != 0) {\n", rule->guard);
+				fprintf(out, "\t\t\t\t\t\treturn FSM_RESULT_GUARD_DENIED;\n\t\t\t\t\t}\n");
+			}
+			gen_transition(gen, out, source, rule, 5);
+			fprintf(out, "\t\t\t\t\tbreak;\n");
+		}
+		if (handled) {
+			fprintf(out, "\t\t\t\tdefault: return FSM_RESULT_NO_TRANSITION_FOR_STATE;\n\t\t\t}\n\t\t\tbreak;\n");
+		} else {
+			fprintf(out, "\t\t\treturn FSM_RESULT_NO_TRANSITION_FOR_STATE;\n");
+		}
+	}
+	fprintf(out, "\t\tdefault: return FSM_RESULT_STATE_OUT_OF_BOUNDS;\n\t}\n");
+	fprintf(out, "\tif (self->def && self->def->observer) {\n");
+	fprintf(out, "\t\tself->def->observer(self->def->observer_context, self, from, to);\n\t}\n");
+	fprintf(out, "\treturn FSM_RESULT_SUCCESS;\n}\n");
+}
+
+int main(int argc, char** argv) {
+	const char* output = ".";
+	const char* path   = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output = argv[++i];
+		} else {
+			path = argv[i];
+		}
+	}
+	if (!path) {
+		printf("Usage: %s [-o output_dir] spec\n", argv[0]);
+		return 2;
+	}
+
+	char       error[256];
+	fsm_spec_t spec;
+	if (fsm_spec_load(&spec, path, error, sizeof(error)) != 0) {
+		printf("%s\n", error);
+		return 2;
+	}
+
+	gen_t       gen  = {&spec, {0}, {0}, {0}, path};
+	const char* name = strrchr(path, '/');
+	name             = name ? name + 1 : path;
+	gen.source       = name;
+	size_t length    = strcspn(name, ".");
+	if (length > FSM_SPEC_NAME_MAX - 5) {
+		length = FSM_SPEC_NAME_MAX - 5;
+	}
+	memcpy(gen.base, name, length);
+	strcpy(gen.base + length, "_fsm");
+	for (size_t i = 0; i < length; i++) {
+		if (!isalnum((unsigned char)gen.base[i])) {
+			gen.base[i] = '_';
+		}
+	}
+	for (size_t i = 0; spec.name[i]; i++) {
+		gen.lower[i] = spec.name[i];
+		gen.upper[i] = (char)toupper((unsigned char)spec.name[i]);
+	}
+
+	int  result = 0;
+	char file_path[GEN_PATH_MAX];
+	for (int part = 0; part < 2 && result == 0; part++) {
+		snprintf(file_path, sizeof(file_path), "%s/%s.%s", output, gen.base, part ? "c" : "h");
+		FILE* out = fopen(file_path, "w");
+		if (!out) {
+			printf("%s: cannot write file\n", file_path);
+			result = 2;
+			break;
+		}
+		if (part) {
+			gen_source(&gen, out);
+		} else {
+			gen_header(&gen, out);
+		}
+		fclose(out);
+	}
+	fsm_spec_free(&spec);
+	return result;
+}
@@ -0,0 +1,335 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#include "fsm_spec.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FSM_SPEC_LINE_MAX 4096
+
+// Parser state of one spec file.
+typedef struct fsm_spec_parser {
+	fsm_spec_t* spec;        ///< Spec being filled.
+	const char* path;        ///< File path, for messages.
+	int         line;        ///< Current line number.
+	char*       error;       ///< Message buffer.
+	size_t      error_size;  ///< Size of error.
+} fsm_spec_parser_t;
+
+static int fsm_spec_fail(fsm_spec_parser_t* parser, const char* format, ...) {
+	int     length = parser->line ? snprintf(parser->error, parser->error_size, "%s:%d: ", parser->path, parser->line)
+								  : snprintf(parser->error, parser->error_size, "%s: ", parser->path);
+	va_list args;
+	va_start(args, format);
+	if (length >= 0 && (size_t)length < parser->error_size) {
+		vsnprintf(parser->error + length, parser->error_size - (size_t)length, format, args);
+	}
+	va_end(args);
+	return -1;
+}
+
+static int fsm_spec_is_identifier(const char* token) {
+	if (!isalpha((unsigned char)token[0]) && token[0] != '_') {
+		return 0;
+	}
+	for (const char* c = token; *c; c++) {
+		if (!isalnum((unsigned char)*c) && *c != '_') {
+			return 0;
+		}
+	}
+	return strlen(token) < FSM_SPEC_NAME_MAX;
+}
+
+static int fsm_spec_find_state(const fsm_spec_t* spec, const char* name) {
+	for (size_t i = 0; i < spec->state_count; i++) {
+		if (strcmp(spec->states[i].name, name) == 0) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static int fsm_spec_find_event(const fsm_spec_t* spec, const char* name) {
+	for (size_t i = 0; i < spec->event_count; i++) {
+		if (strcmp(spec->events[i], name) == 0) {
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+static int fsm_spec_add_state(fsm_spec_parser_t* parser, const char* name) {
+	fsm_spec_t* spec = parser->spec;
+	if (!fsm_spec_is_identifier(name)) {
+		return fsm_spec_fail(parser, "invalid state name '%s'", name);
+	}
+	if (fsm_spec_find_state(spec, name) >= 0) {
+		return fsm_spec_fail(parser, "state '%s' is declared twice", name);
+	}
+	if (spec->state_count >= FSM_MAX_STATES) {
+		return fsm_spec_fail(parser, "more than %d states", FSM_MAX_STATES);
+	}
+	fsm_spec_state_t* state = &spec->states[spec->state_count++];
+	memset(state, 0, sizeof(*state));
+	strcpy(state->name, name);
+	state->line = parser->line;
+	return 0;
+}
+
+static int fsm_spec_add_event(fsm_spec_parser_t* parser, const char* name) {
+	fsm_spec_t* spec = parser->spec;
+	if (!fsm_spec_is_identifier(name)) {
+		return fsm_spec_fail(parser, "invalid event name '%s'", name);
+	}
+	if (fsm_spec_find_event(spec, name) >= 0) {
+		return fsm_spec_fail(parser, "event '%s' is declared twice", name);
+	}
+	if (spec->event_count >= FSM_MAX_EVENTS) {
+		return fsm_spec_fail(parser, "more than %d events", FSM_MAX_EVENTS);
+	}
+	if ((spec->event_count & (spec->event_count - 1)) == 0) {
+		size_t           capacity = spec->event_count ? spec->event_count * 2 : 16;
+		fsm_spec_name_t* events   = (fsm_spec_name_t*)realloc(spec->events, capacity * sizeof(fsm_spec_name_t));
+		if (!events) {
+			return fsm_spec_fail(parser, "out of memory");
+		}
+		spec->events = events;
+	}
+	strcpy(spec->events[spec->event_count++], name);
+	return 0;
+}
+
+// Parses a "key=name" callback attribute into the matching field.
+static int fsm_spec_attribute(fsm_spec_parser_t* parser, const char* token, char* guard, char* on_entry,
+							  char* on_exit) {
+	const char* value = strchr(token, '=');
+	char*       field = NULL;
+	if (value) {
+		size_t key = (size_t)(value - token);
+		if (guard && key == 5 && strncmp(token, "guard", key) == 0) {
+			field = guard;
+		} else if (key == 5 && strncmp(token, "entry", key) == 0) {
+			field = on_entry;
+		} else if (key == 4 && strncmp(token, "exit", key) == 0) {
+			field = on_exit;
+		}
+	}
+	if (!field) {
+		return fsm_spec_fail(parser, "unexpected '%s'", token);
+	}
+	if (!fsm_spec_is_identifier(value + 1)) {
+		return fsm_spec_fail(parser, "invalid function name in '%s'", token);
+	}
+	strcpy(field, value + 1);
+	return 0;
+}
+
+static int fsm_spec_parse_rule(fsm_spec_parser_t* parser, char** tokens, size_t count) {
+	fsm_spec_t* spec = parser->spec;
+	if (count < 5 || strcmp(tokens[2], "from") != 0) {
+		return fsm_spec_fail(parser, "expected 'on EVENT from STATE... to STATE'");
+	}
+	if ((spec->rule_count & (spec->rule_count - 1)) == 0) {
+		size_t           capacity = spec->rule_count ? spec->rule_count * 2 : 16;
+		fsm_spec_rule_t* rules    = (fsm_spec_rule_t*)realloc(spec->rules, capacity * sizeof(fsm_spec_rule_t));
+		if (!rules) {
+			return fsm_spec_fail(parser, "out of memory");
+		}
+		spec->rules = rules;
+	}
+	fsm_spec_rule_t* rule = &spec->rules[spec->rule_count];
+	memset(rule, 0, sizeof(*rule));
+	rule->line = parser->line;
+
+	int event = fsm_spec_find_event(spec, tokens[1]);
+	if (event < 0) {
+		return fsm_spec_fail(parser, "undeclared event '%s'", tokens[1]);
+	}
+	rule->event = (fsm_event_t)event;
+
+	size_t i = 3;
+	for (; i < count && strcmp(tokens[i], "to") != 0; i++) {
+		if (strcmp(tokens[i], "*") == 0) {
+			memset(rule->sources, 1, spec->state_count);
+			continue;
+		}
+		int state = fsm_spec_find_state(spec, tokens[i]);
+		if (state < 0) {
+			return fsm_spec_fail(parser, "undeclared state '%s'", tokens[i]);
+		}
+		rule->sources[state] = 1;
+	}
+	if (i == 3 || i + 1 >= count) {
+		return fsm_spec_fail(parser, "expected source states and 'to STATE'");
+	}
+	int target = fsm_spec_find_state(spec, tokens[i + 1]);
+	if (target < 0) {
+		return fsm_spec_fail(parser, "undeclared state '%s'", tokens[i + 1]);
+	}
+	rule->target = (fsm_state_t)target;
+
+	for (i += 2; i < count; i++) {
+		if (fsm_spec_attribute(parser, tokens[i], rule->guard, rule->on_entry, rule->on_exit)) {
+			return -1;
+		}
+	}
+	spec->rule_count++;
+	return 0;
+}
+
+static int fsm_spec_parse_line(fsm_spec_parser_t* parser, char** tokens, size_t count) {
+	fsm_spec_t* spec = parser->spec;
+	if (strcmp(tokens[0], "machine") == 0) {
+		if (count != 2 || !fsm_spec_is_identifier(tokens[1])) {
+			return fsm_spec_fail(parser, "expected 'machine NAME'");
+		}
+		strcpy(spec->name, tokens[1]);
+	} else if (strcmp(tokens[0], "states") == 0) {
+		for (size_t i = 1; i < count; i++) {
+			if (fsm_spec_add_state(parser, tokens[i])) {
+				return -1;
+			}
+		}
+	} else if (strcmp(tokens[0], "state") == 0) {
+		if (count < 2) {
+			return fsm_spec_fail(parser, "expected 'state NAME [entry=FUNCTION] [exit=FUNCTION]'");
+		}
+		int state = fsm_spec_find_state(spec, tokens[1]);
+		if (state < 0) {
+			if (fsm_spec_add_state(parser, tokens[1])) {
+				return -1;
+			}
+			state = (int)spec->state_count - 1;
+		}
+		for (size_t i = 2; i < count; i++) {
+			if (fsm_spec_attribute(parser, tokens[i], NULL, spec->states[state].on_entry,
+								   spec->states[state].on_exit)) {
+				return -1;
+			}
+		}
+	} else if (strcmp(tokens[0], "events") == 0) {
+		for (size_t i = 1; i < count; i++) {
+			if (fsm_spec_add_event(parser, tokens[i])) {
+				return -1;
+			}
+		}
+	} else if (strcmp(tokens[0], "initial") == 0) {
+		int state = count == 2 ? fsm_spec_find_state(spec, tokens[1]) : -1;
+		if (state < 0) {
+			return fsm_spec_fail(parser, "expected 'initial STATE' naming a declared state");
+		}
+		spec->initial = (fsm_state_t)state;
+	} else if (strcmp(tokens[0], "fallthrough") == 0) {
+		if (count != 1) {
+			return fsm_spec_fail(parser, "expected 'fallthrough'");
+		}
+		spec->fallthrough = 1;
+	} else if (strcmp(tokens[0], "on") == 0) {
+		return fsm_spec_parse_rule(parser, tokens, count);
+	} else {
+		return fsm_spec_fail(parser, "unknown directive '%s'", tokens[0]);
+	}
+	return 0;
+}
+
+int fsm_spec_load(fsm_spec_t* spec, const char* path, char* error, size_t error_size) {
+	static char       buffer[FSM_SPEC_LINE_MAX];
+	char*             tokens[FSM_SPEC_LINE_MAX / 2];
+	fsm_spec_parser_t parser = {spec, path, 0, error, error_size};
+
+	memset(spec, 0, sizeof(*spec));
+	spec->states = (fsm_spec_state_t*)malloc(FSM_MAX_STATES * sizeof(fsm_spec_state_t));
+	FILE* file   = fopen(path, "r");
+	if (!spec->states || !file) {
+		fsm_spec_fail(&parser, "cannot read file");
+		if (file) {
+			fclose(file);
+		}
+		fsm_spec_free(spec);
+		return -1;
+	}
+	strcpy(spec->name, "fsm");
+
+	int result = 0;
+	while (result == 0 && fgets(buffer, sizeof(buffer), file)) {
+		parser.line++;
+		char* comment = strchr(buffer, '#');
+		if (comment) {
+			*comment = '\0';
+		}
+		size_t count = 0;
+		for (char* token = strtok(buffer, " \t\r\n"); token; token = strtok(NULL, " \t\r\n")) {
+			tokens[count++] = token;
+		}
+		if (count > 0) {
+			result = fsm_spec_parse_line(&parser, tokens, count);
+		}
+	}
+	fclose(file);
+	if (result == 0 && (spec->state_count == 0 || spec->event_count == 0 || spec->rule_count == 0)) {
+		result = fsm_spec_fail(&parser, "a machine needs states, events and rules");
+	}
+	if (result != 0) {
+		fsm_spec_free(spec);
+	}
+	return result;
+}
+
+void fsm_spec_free(fsm_spec_t* spec) {
+	free(spec->states);
+	free(spec->events);
+	free(spec->rules);
+	spec->states = NULL;
+	spec->events = NULL;
+	spec->rules  = NULL;
+}
+
+// Stands in for the guards named by a spec.
+static int fsm_spec_guard(fsm_t* fsm, void* data) {
+	return 0;
+}
+
+void fsm_spec_transitions(const fsm_spec_t* spec, fsm_transition_t* rules) {
+	for (size_t i = 0; i < spec->rule_count; i++) {
+		const fsm_spec_rule_t* source = &spec->rules[i];
+		fsm_transition_t*      rule   = &rules[i];
+		memset(rule, 0, sizeof(*rule));
+		rule->event        = source->event;
+		rule->target_state = source->target;
+		rule->guard        = source->guard[0] ? fsm_spec_guard : NULL;
+		for (size_t state = 0; state < spec->state_count; state++) {
+			if (!source->sources[state]) {
+				continue;
+			}
+#ifdef FSM_WIDE
+			rule->source_states_mask[state / 64] |= 1ULL << (state % 64);
+#else
+			rule->source_states_mask |= FSM_STATE_MASK(state);
+#endif
+		}
+	}
+}
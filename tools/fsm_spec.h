@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 tayne3
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ * 2. THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *    SOFTWARE.
+ */
+#ifndef FSM_SPEC_H
+#define FSM_SPEC_H
+
+#include "fsm.h"
+
+/**
+ * Declarative machine description shared by the command line tools.
+ *
+ * A spec is a line-oriented text file, '#' starts a comment:
+ *
+ *   machine vending
+ *   states  IDLE ACCEPTING DISPENSING
+ *   state   DISPENSING entry=motor_on exit=motor_off
+ *   events  INSERT_COIN SELECT_ITEM DISPENSE_DONE CANCEL
+ *   initial IDLE
+ *   fallthrough
+ *   on INSERT_COIN from IDLE ACCEPTING to ACCEPTING entry=add_coin
+ *   on SELECT_ITEM from ACCEPTING to DISPENSING guard=can_dispense entry=start_dispense
+ *
+ * States and events are numbered in declaration order and must be declared before use. "state" declares
+ * a state or attaches entry/exit actions to a declared one, "from *" stands for every state, and the
+ * initial state defaults to the first one. Rules keep their order, so first-match-wins applies as usual.
+ * "fallthrough" lets a denied guard fall through to the next matching rule (fsm_def_set_fallthrough()).
+ */
+
+#define FSM_SPEC_NAME_MAX 64  // Longest identifier, including the terminator.
+
+// Storage of one identifier.
+typedef char fsm_spec_name_t[FSM_SPEC_NAME_MAX];
+
+/**
+ * @brief State declared in a spec.
+ */
+typedef struct fsm_spec_state {
+	char name[FSM_SPEC_NAME_MAX];      ///< State identifier.
+	char on_entry[FSM_SPEC_NAME_MAX];  ///< Entry action name (empty if none).
+	char on_exit[FSM_SPEC_NAME_MAX];   ///< Exit action name (empty if none).
+	int  line;                         ///< Line the state was declared on.
+} fsm_spec_state_t;
+
+/**
+ * @brief Rule declared in a spec, with its callbacks referred to by name.
+ */
+typedef struct fsm_spec_rule {
+	fsm_event_t event;                        ///< Triggering event.
+	fsm_state_t target;                       ///< Target state.
+	uint8_t     sources[FSM_MAX_STATES];      ///< Non-zero for each source state.
+	char        guard[FSM_SPEC_NAME_MAX];     ///< Guard name (empty if none).
+	char        on_entry[FSM_SPEC_NAME_MAX];  ///< Rule entry action name (empty if none).
+	char        on_exit[FSM_SPEC_NAME_MAX];   ///< Rule exit action name (empty if none).
+	int         line;                         ///< Line the rule was declared on.
+} fsm_spec_rule_t;
+
+/**
+ * @brief Parsed spec.
+ */
+typedef struct fsm_spec {
+	char              name[FSM_SPEC_NAME_MAX];  ///< Machine name, used as a prefix by generated code.
+	fsm_spec_state_t* states;                   ///< Declared states.
+	size_t            state_count;              ///< Number of states.
+	fsm_spec_name_t*  events;                   ///< Declared event names.
+	size_t            event_count;              ///< Number of events.
+	fsm_spec_rule_t*  rules;                    ///< Rules in declaration order.
+	size_t            rule_count;               ///< Number of rules.
+	fsm_state_t       initial;                  ///< Initial state.
+	int               fallthrough;              ///< Non-zero when denied guards fall through.
+} fsm_spec_t;
+
+/**
+ * @brief Parses a spec file.
+ * @param spec Receives the spec, release it with fsm_spec_free() on success.
+ * @param path Path of the spec file.
+ * @param error Receives a "path:line: message" description on failure.
+ * @param error_size Size of error.
+ * @return 0 on success, -1 on failure.
+ */
+int fsm_spec_load(fsm_spec_t* spec, const char* path, char* error, size_t error_size);
+
+/**
+ * @brief Releases the storage of a loaded spec.
+ * @param spec Pointer to the spec.
+ */
+void fsm_spec_free(fsm_spec_t* spec);
+
+/**
+ * @brief Converts the rules of a spec to a transition table without actions.
+ * @note Rules naming a guard get a placeholder guard that always passes, so that analysis knows them.
+ * @param spec Pointer to the spec.
+ * @param rules Destination array of rule_count entries.
+ */
+void fsm_spec_transitions(const fsm_spec_t* spec, fsm_transition_t* rules);
+
+#endif  // FSM_SPEC_H